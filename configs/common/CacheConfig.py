@@ -147,6 +147,14 @@ def config_cache(options, system):
                       "specified by the flag option.")
             system.l2.prefetcher = hwpClass()      
 
+    if options.cache_backdoor:
+        if options.l3cache and options.l2cache:
+            system.l3.atomic_backdoor = True
+        elif options.l2cache:
+            system.l2.atomic_backdoor = True
+        else:
+            fatal("--cache-backdoor requires --l2cache")
+
     if options.memchecker:
         system.memchecker = MemChecker()
 
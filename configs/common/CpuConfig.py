@@ -37,8 +37,17 @@ from __future__ import print_function
 from __future__ import absolute_import
 
 from m5 import fatal
+from m5.params import isNullPointer
 import m5.objects
 
+def config_branch_trace(cpu):
+    # Attach a probe recording the branches committed by the cpu. The
+    # trace is written to <probe name>.trc in the output directory.
+    if isNullPointer(cpu.branchPred):
+        fatal("%s has no branch predictor to trace, select one with "
+              "--bp-type", cpu)
+    cpu.branchTrace = m5.objects.BranchTraceProbe()
+
 def config_etrace(cpu_cls, cpu_list, options):
     if issubclass(cpu_cls, m5.objects.DerivO3CPU):
         # Assign the same file name to all cpus for now. This must be
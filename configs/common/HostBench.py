@@ -0,0 +1,110 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Helpers shared by the host performance benchmarks in configs/example
+# (*_bench.py). They all run a small system in front of an ideal memory,
+# mostly with a statically linked test program from tests/test-progs, and
+# time part of the simulation on the host.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import argparse
+import os
+import time
+
+import m5
+from m5.defines import buildEnv
+from m5.objects import *
+from m5.util import fatal
+
+test_progs = os.path.join(os.path.dirname(os.path.realpath(__file__)),
+                          "../../tests/test-progs")
+
+def makeParser():
+    return argparse.ArgumentParser(
+        formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+def addBinaryOption(parser, prog):
+    """Add a --binary option, defaulting to tests/test-progs/prog/prog."""
+    parser.add_argument("--binary",
+                        default=os.path.join(test_progs, prog, prog),
+                        help="Statically linked %s binary" % prog)
+
+def checkBinary(path, prog):
+    if not os.path.isfile(path):
+        fatal("%s not found, build it with make in tests/test-progs/%s",
+              path, prog)
+
+def makeSystem(mem_size, mem_mode, **kwargs):
+    """
+    Build a 1GHz system with a single memory range served by an ideal
+    memory, which keeps the host time spent outside the part of gem5
+    being measured short. The keyword arguments go to the memory bus.
+    """
+    system = System(membus = SystemXBar(**kwargs))
+    system.clk_domain = SrcClockDomain(clock = "1GHz",
+                                       voltage_domain = VoltageDomain())
+    system.mem_ranges = [AddrRange(mem_size)]
+    system.mem_mode = mem_mode
+
+    system.mem = SimpleMemory(range = system.mem_ranges[0],
+                              latency = "0ns", bandwidth = "1000GB/s")
+    system.mem.port = system.membus.master
+    system.system_port = system.membus.slave
+    return system
+
+def connectInterrupts(system, cpu):
+    cpu.createInterruptController()
+    if buildEnv['TARGET_ISA'] == "x86":
+        cpu.interrupts[0].pio = system.membus.master
+        cpu.interrupts[0].int_master = system.membus.slave
+        cpu.interrupts[0].int_slave = system.membus.master
+
+def setWorkload(cpu, cmd, output, **kwargs):
+    """Run cmd, whose first element is the binary, as the CPU's process."""
+    process = Process(**kwargs)
+    process.executable = cmd[0]
+    process.cmd = cmd
+    process.output = output
+    cpu.workload = process
+    cpu.createThreads()
+
+def runToExit(prog, guest_out, check_code = True):
+    """
+    Simulate until the guest exits and return the host time it took.
+    Stops with an error if the guest did not complete or, with
+    check_code, returned a non-zero exit code.
+    """
+    start = time.time()
+    exit_event = m5.simulate()
+    elapsed = time.time() - start
+
+    if exit_event.getCause() != "exiting with last active thread context":
+        fatal("Benchmark did not complete: %s", exit_event.getCause())
+    if check_code and exit_event.getCode() != 0:
+        fatal("%s failed, see %s", prog, guest_out)
+    return elapsed
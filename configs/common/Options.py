@@ -140,6 +140,9 @@ def addNoISAOptions(parser):
     parser.add_option("--l2_assoc", type="int", default=8)
     parser.add_option("--l3_assoc", type="int", default=16)
     parser.add_option("--cacheline_size", type="int", default=64)
+    parser.add_option("--cache-backdoor", action="store_true",
+                      help="Service atomic fills and evictions of the "
+                      "last-level cache through a memory backdoor")
 
     # Enable Ruby
     parser.add_option("--ruby", action="store_true")
@@ -258,6 +261,11 @@ def addCommonOptions(parser):
                       Elastic Trace probe in a capture simulation and
                       Trace CPU in a replay simulation""", default="")
 
+    parser.add_option("--branch-trace", action="store_true",
+                      help="""Capture the branches committed by each CPU in
+                      a binary branch trace, to be replayed through other
+                      predictors by configs/example/bpred_replay.py""")
+
     parser.add_option("-l", "--lpae", action="store_true")
     parser.add_option("-V", "--virtualisation", action="store_true")
 
@@ -285,6 +293,18 @@ def addCommonOptions(parser):
                       default="0us",
                       action="store", type="string",
                       help="Repeat interval for synchronisation barriers among dist-gem5 processes\nDEFAULT: --ethernet-linkdelay")
+    parser.add_option("--dist-sync-repeat-max",
+                      default="0us",
+                      action="store", type="string",
+                      help="Let the dist-gem5 synchronisation interval grow "
+                      "up to this value while the links are idle. The "
+                      "first packets after an idle period may arrive up to "
+                      "this value minus the link delay late\n"
+                      "DEFAULT: 0us (fixed interval)")
+    parser.add_option("--dist-transport", default="tcp",
+                      action="store", type="choice", choices=["tcp", "shm"],
+                      help="Message transport among dist-gem5 processes "
+                      "(shm requires all processes on the same host)")
     parser.add_option("--dist-sync-start",
                       default="5200000000000t",
                       action="store", type="string",
@@ -365,6 +385,32 @@ def addCommonOptions(parser):
     parser.add_option("-p", "--prog-interval", type="str",
         help="CPU Progress Interval")
 
+    # Sampled simulation (SMARTS): functional warming with the atomic CPU
+    # interleaved with short detailed warmup and measurement units
+    parser.add_option("--smarts", action="store_true", default=False,
+        help="""Run sampled simulation, measuring a detailed unit every
+                --smarts-period instructions and keeping caches and the
+                branch predictor warm in between.""")
+    parser.add_option("--smarts-period", action="store", type="int",
+        default=1000000,
+        help="Instructions between the start of two samples")
+    parser.add_option("--smarts-warmup", action="store", type="int",
+        default=2000,
+        help="Detailed warmup instructions before each measurement unit")
+    parser.add_option("--smarts-unit", action="store", type="int",
+        default=1000,
+        help="Instructions in each measurement unit")
+    parser.add_option("--smarts-max-samples", action="store", type="int",
+        default=None,
+        help="Stop after this many samples")
+    parser.add_option("--smarts-confidence", action="store", type="float",
+        default=0.997,
+        help="Confidence level of the reported CPI interval")
+    parser.add_option("--smarts-no-bp-warming", action="store_true",
+        default=False,
+        help="Don't share the detailed CPU's branch predictor with the "
+             "functional warming CPU")
+
     # Fastforwarding and simpoint related materials
     parser.add_option("-W", "--warmup-insts", action="store", type="int",
         default=None,
@@ -374,6 +420,15 @@ def addCommonOptions(parser):
     parser.add_option("-F", "--fast-forward", action="store", type="string",
         default=None,
         help="Number of instructions to fast forward before switching")
+    parser.add_option("--fast-forward-backdoors", action="store_true",
+        default=False,
+        help="""Let the atomic CPU used for fast-forwarding access memory
+                through backdoors when no caches are in the way.""")
+    parser.add_option("--fast-forward-block-cache", action="store_true",
+        default=False,
+        help="""Let the atomic CPU used for fast-forwarding replay the
+                decoding of basic blocks it has run before (implies
+                --fast-forward-backdoors).""")
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
@@ -491,6 +546,12 @@ def addFSOptions(parser):
     # Disk Image Options
     parser.add_option("--disk-image", action="append", type="string",
             default=[], help="Path to the disk images to use.")
+    parser.add_option("--disk-overlay-dir", action="store", type="string",
+            default=None, help="Keep the disk writes in persistent sparse "
+            "overlay files in this directory, so later runs reuse them.")
+    parser.add_option("--disk-stream-io", action="store_true",
+            help="Read and write raw disk images one sector at a time "
+            "instead of mapping them.")
     parser.add_option("--root-device", action="store", type="string",
             default=None, help="OS device name for root partition")
 
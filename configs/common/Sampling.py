@@ -0,0 +1,201 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""SMARTS-style sampled simulation.
+
+The workload runs on the functional warming CPUs (atomic CPUs connected to
+the regular cache hierarchy) so that cache tags and replacement state,
+including SHiP signature counters and DIP/DRRIP PSEL counters, stay warm.
+Every sampling period the detailed CPUs take over for a short warmup
+followed by a measurement unit. Stats are dumped once per measurement
+unit, and the CPI of the units is summarised with a confidence interval
+at the end of the run.
+"""
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import math
+import os
+
+import m5
+from m5.params import isNullPointer
+from m5.util import fatal, warn
+
+WARM_CAUSE = "smarts: functional warming done"
+DETAILED_WARMUP_CAUSE = "smarts: detailed warmup done"
+UNIT_CAUSE = "smarts: measurement unit done"
+
+def zScore(confidence):
+    """Two-sided standard normal quantile for a confidence level."""
+    if not 0.0 < confidence < 1.0:
+        fatal("SMARTS confidence level must be in (0, 1)")
+    target = confidence
+    lo, hi = 0.0, 10.0
+    # erf(z / sqrt(2)) is the probability mass within +-z
+    for _ in range(100):
+        mid = (lo + hi) / 2
+        if math.erf(mid / math.sqrt(2)) < target:
+            lo = mid
+        else:
+            hi = mid
+    return (lo + hi) / 2
+
+def setup(options, testsys, switch_cpus):
+    """Configure the functional warming and detailed CPUs for sampling.
+
+    Must be called before m5.instantiate(). testsys.cpu are the atomic
+    functional warming CPUs and switch_cpus the (switched out) detailed
+    CPUs.
+    """
+    if options.smarts_warmup < 0 or options.smarts_unit <= 0:
+        fatal("SMARTS needs a positive measurement unit")
+    if options.smarts_max_samples is not None and \
+            options.smarts_max_samples <= 0:
+        fatal("SMARTS needs at least one sample")
+    if options.smarts_period < options.smarts_warmup + options.smarts_unit:
+        fatal("SMARTS period must cover the detailed warmup and the "
+              "measurement unit")
+    if not options.caches and not options.ruby:
+        warn("SMARTS without caches only warms the branch predictor")
+    if options.num_cpus > 1:
+        warn("SMARTS sample boundaries are counted on cpu0 only")
+
+    for atomic_cpu, detailed_cpu in zip(testsys.cpu, switch_cpus):
+        if options.smarts_no_bp_warming:
+            continue
+        bp = getattr(detailed_cpu, 'branchPred', None)
+        if bp is not None and not isNullPointer(bp):
+            # Both CPUs drive the same predictor so that its tables see
+            # the branches executed during functional warming.
+            atomic_cpu.branchPred = bp
+
+def _totalInsts(cpus):
+    return sum(cpu.totalInsts() for cpu in cpus)
+
+def _simulateUntil(cpu, insts, cause, maxtick):
+    """Run until cpu retires insts more instructions."""
+    cpu.scheduleInstStop(0, insts, cause)
+    return m5.simulate(maxtick - m5.curTick())
+
+def _summarise(options, cpis):
+    n = len(cpis)
+    if n == 0:
+        print("SMARTS: no samples were collected")
+        return
+
+    mean = sum(cpis) / n
+    if n > 1:
+        var = sum((c - mean) ** 2 for c in cpis) / (n - 1)
+    else:
+        var = 0.0
+    stdev = math.sqrt(var)
+    cov = stdev / mean if mean else 0.0
+    z = zScore(options.smarts_confidence)
+    half_width = z * stdev / math.sqrt(n)
+    rel_error = half_width / mean if mean else 0.0
+
+    print("SMARTS: %d samples, CPI %f +- %f (%.2f%% at %.1f%% confidence)"
+          % (n, mean, half_width, rel_error * 100,
+             options.smarts_confidence * 100))
+    print("SMARTS: coefficient of variation %f; about %d samples are "
+          "needed for +-3%% error" %
+          (cov, int(math.ceil((z * cov / 0.03) ** 2))))
+
+    with open(os.path.join(m5.options.outdir, "smarts.txt"), "w") as f:
+        f.write("samples %d\n" % n)
+        f.write("confidence %f\n" % options.smarts_confidence)
+        f.write("cpi_mean %f\n" % mean)
+        f.write("cpi_stdev %f\n" % stdev)
+        f.write("cpi_ci_half_width %f\n" % half_width)
+        f.write("cpi_relative_error %f\n" % rel_error)
+
+def run(options, testsys, switch_cpus, maxtick):
+    """Run the sampling loop and return the event that ended it."""
+    atomic_cpus = list(testsys.cpu)
+    to_detailed = list(zip(atomic_cpus, switch_cpus))
+    to_atomic = list(zip(switch_cpus, atomic_cpus))
+
+    period = options.smarts_period
+    warmup = options.smarts_warmup
+    unit = options.smarts_unit
+    warming = period - warmup - unit
+
+    # Cycles are counted in detailed CPU clock periods
+    clock = switch_cpus[0].clk_domain.clock[0].getValue()
+
+    if options.fast_forward:
+        # Skip initialisation without sampling it
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        if exit_event.getCause() != \
+                "a thread reached the max instruction count":
+            return exit_event
+
+    samples_csv = open(os.path.join(m5.options.outdir, "smarts.csv"), "w")
+    samples_csv.write("sample,tick,insts,cycles,cpi\n")
+
+    cpis = []
+    print("**** SMARTS SAMPLING ****")
+    while True:
+        if options.smarts_max_samples is not None and \
+                len(cpis) >= options.smarts_max_samples:
+            break
+
+        if warming:
+            exit_event = _simulateUntil(atomic_cpus[0], warming,
+                                        WARM_CAUSE, maxtick)
+            if exit_event.getCause() != WARM_CAUSE:
+                break
+
+        m5.switchCpus(testsys, to_detailed)
+
+        if warmup:
+            exit_event = _simulateUntil(switch_cpus[0], warmup,
+                                        DETAILED_WARMUP_CAUSE, maxtick)
+            if exit_event.getCause() != DETAILED_WARMUP_CAUSE:
+                break
+
+        m5.stats.reset()
+        start_tick = m5.curTick()
+        start_insts = _totalInsts(switch_cpus)
+        exit_event = _simulateUntil(switch_cpus[0], unit, UNIT_CAUSE,
+                                    maxtick)
+        if exit_event.getCause() != UNIT_CAUSE:
+            break
+        m5.stats.dump()
+
+        insts = _totalInsts(switch_cpus) - start_insts
+        cycles = (m5.curTick() - start_tick) // clock
+        cpi = float(cycles) / insts if insts else 0.0
+        samples_csv.write("%d,%d,%d,%d,%f\n" %
+                          (len(cpis), start_tick, insts, cycles, cpi))
+        cpis.append(cpi)
+
+        m5.switchCpus(testsys, to_atomic)
+
+    samples_csv.close()
+    _summarise(options, cpis)
+    return exit_event
@@ -47,6 +47,7 @@ from os.path import join as joinpath
 
 from common import CpuConfig
 from common import ObjectList
+from common import Sampling
 
 import m5
 from m5.defines import buildEnv
@@ -83,7 +84,7 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.smarts:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
@@ -451,6 +452,13 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.smarts and (options.standard_switch or options.repeat_switch
+                           or options.take_checkpoints != None):
+        fatal("Can't combine --smarts with CPU switching or checkpointing")
+
+    if options.smarts and not cpu_class:
+        fatal("--smarts needs a detailed --cpu-type to sample with")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -469,6 +477,11 @@ def run(options, root, testsys, cpu_class):
         for i in range(np):
             if options.fast_forward:
                 testsys.cpu[i].max_insts_any_thread = int(options.fast_forward)
+                if options.fast_forward_backdoors or \
+                   options.fast_forward_block_cache:
+                    testsys.cpu[i].memory_backdoors = True
+                if options.fast_forward_block_cache:
+                    testsys.cpu[i].basic_block_cache = True
             switch_cpus[i].system = testsys
             switch_cpus[i].workload = testsys.cpu[i].workload
             switch_cpus[i].clk_domain = testsys.cpu[i].clk_domain
@@ -498,6 +511,9 @@ def run(options, root, testsys, cpu_class):
         testsys.switch_cpus = switch_cpus
         switch_cpu_list = [(testsys.cpu[i], switch_cpus[i]) for i in range(np)]
 
+        if options.smarts:
+            Sampling.setup(options, testsys, switch_cpus)
+
     if options.repeat_switch:
         switch_class = getCPUClass(options.cpu_type)[0]
         if switch_class.require_caches() and \
@@ -657,7 +673,7 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if (options.standard_switch or cpu_class) and not options.smarts:
         if options.standard_switch:
             print("Switch at instruction count:%s" %
                     str(testsys.cpu[0].max_insts_any_thread))
@@ -714,6 +730,10 @@ def run(options, root, testsys, cpu_class):
     elif options.restore_simpoint_checkpoint != None:
         restoreSimpointCheckpoint()
 
+    # Sampled simulation
+    elif options.smarts:
+        exit_event = Sampling.run(options, testsys, switch_cpus, maxtick)
+
     else:
         if options.fast_forward:
             m5.stats.reset()
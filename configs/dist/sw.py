@@ -53,6 +53,9 @@ def build_switch(options):
                                       server_port = options.dist_server_port,
                                       sync_start = options.dist_sync_start,
                                       sync_repeat = options.dist_sync_repeat,
+                                      sync_repeat_max = \
+                                          options.dist_sync_repeat_max,
+                                      transport = options.dist_transport,
                                       is_switch = True,
                                       num_nodes = options.dist_size)
                        for i in range(options.dist_size)]
@@ -0,0 +1,90 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import os
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import HostBench
+
+# This script measures how many instructions per host second the atomic
+# CPU runs when fast-forwarding without caches. It runs
+# tests/test-progs/block-bench, an integer sorting loop that on x86-64
+# also keeps rewriting and calling a small function, on an atomic CPU
+# in front of an ideal memory. Comparing the three modes shows what
+# serving fetches through a backdoor and replaying cached basic blocks
+# each add, e.g.
+#
+#   gem5.opt block_cache_bench.py --mode plain
+#   gem5.opt block_cache_bench.py --mode backdoors
+#   gem5.opt block_cache_bench.py --mode block-cache
+
+parser = HostBench.makeParser()
+
+HostBench.addBinaryOption(parser, "block-bench")
+parser.add_argument("--iterations", type=int, default=1000,
+                    help="Iterations of the sorting loop in the guest")
+parser.add_argument("--mode", default="block-cache",
+                    choices=["plain", "backdoors", "block-cache"],
+                    help="How the CPU fetches and decodes instructions")
+parser.add_argument("--block-cache-size", type=int, default=16384,
+                    help="Number of basic blocks to cache")
+parser.add_argument("--mem-size", default="512MB",
+                    help="Size of the simulated memory")
+
+options = parser.parse_args()
+
+HostBench.checkBinary(options.binary, "block-bench")
+
+system = HostBench.makeSystem(options.mem_size, "atomic")
+
+system.cpu = AtomicSimpleCPU(
+    memory_backdoors = options.mode != "plain",
+    basic_block_cache = options.mode == "block-cache",
+    basic_block_cache_size = options.block_cache_size)
+system.cpu.icache_port = system.membus.slave
+system.cpu.dcache_port = system.membus.slave
+HostBench.connectInterrupts(system, system.cpu)
+
+guest_out = os.path.join(m5.options.outdir, "block-bench.out")
+HostBench.setWorkload(system.cpu,
+                      [options.binary, str(options.iterations)], guest_out)
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+elapsed = HostBench.runToExit("block-bench", guest_out)
+
+insts = system.cpu.totalInsts()
+print("%d instructions in %.2f s (%s)" % (insts, elapsed, options.mode))
+print("%.2f MIPS" % (insts / elapsed / 1e6))
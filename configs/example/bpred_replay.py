@@ -0,0 +1,79 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import ObjectList
+
+# This script evaluates branch predictors on a branch trace captured
+# by se.py --branch-trace, without simulating a CPU. Every predictor
+# given with --bp-type sees the whole trace, and the MPKI and the
+# predictions per host second of each one end up in stats.txt, e.g.
+#
+#   gem5.opt se.py --cpu-type DerivO3CPU --branch-trace -c a.out
+#   gem5.opt bpred_replay.py m5out/system.cpu.branchTrace.trc \
+#       --bp-type TAGE --bp-type LTAGE --bp-type TAGE_SC_L_64KB
+
+parser = argparse.ArgumentParser(
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("trace", help="Branch trace to replay")
+parser.add_argument("--bp-type", action="append", default=[],
+                    choices=ObjectList.bp_list.get_names(),
+                    help="Branch predictor to evaluate, can be given "
+                    "several times")
+parser.add_argument("--num-threads", type=int, default=1,
+                    help="Hardware threads in the trace")
+parser.add_argument("--max-branches", type=int, default=0,
+                    help="Branches to replay, 0 replays the whole trace")
+
+options = parser.parse_args()
+
+bp_types = options.bp_type or ["TournamentBP"]
+
+predictors = [ ObjectList.bp_list.get(bp_type)(
+                   numThreads = options.num_threads)
+               for bp_type in bp_types ]
+
+replayer = BranchTraceReplayer(trace_file = options.trace,
+                               predictors = predictors,
+                               max_branches = options.max_branches)
+
+root = Root(full_system = False, replayer = replayer)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
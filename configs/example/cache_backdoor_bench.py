@@ -0,0 +1,108 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import os
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import HostBench
+
+# This script measures how many instructions per host second the atomic
+# CPU runs through a three-level classic cache hierarchy. It runs
+# tests/test-progs/mem-bench, which walks a buffer much larger than the
+# L3, on an AtomicSimpleCPU with private L1 caches, an L2 and an L3 in
+# front of an ideal memory. Comparing the two modes shows what servicing
+# the L3 fills and evictions through the memory backdoor saves over
+# sending packets to the memory, e.g.
+#
+#   gem5.opt cache_backdoor_bench.py --mode packets
+#   gem5.opt cache_backdoor_bench.py --mode backdoor
+
+parser = HostBench.makeParser()
+
+HostBench.addBinaryOption(parser, "mem-bench")
+parser.add_argument("--buffer-size", type=int, default=64,
+                    help="Size of the guest buffer in MB")
+parser.add_argument("--passes", type=int, default=4,
+                    help="Passes over the guest buffer")
+parser.add_argument("--mode", default="backdoor",
+                    choices=["packets", "backdoor"],
+                    help="How the L3 reaches the memory")
+parser.add_argument("--mem-size", default="512MB",
+                    help="Size of the simulated memory")
+
+options = parser.parse_args()
+
+HostBench.checkBinary(options.binary, "mem-bench")
+
+def cache(size, assoc, latency, **kwargs):
+    return Cache(size = size, assoc = assoc, tag_latency = latency,
+                 data_latency = latency, response_latency = latency,
+                 mshrs = 16, tgts_per_mshr = 12, **kwargs)
+
+system = HostBench.makeSystem(options.mem_size, "atomic")
+
+system.cpu = AtomicSimpleCPU()
+system.cpu.icache = cache("32kB", 8, 2)
+system.cpu.dcache = cache("32kB", 8, 2)
+system.cpu.icache_port = system.cpu.icache.cpu_side
+system.cpu.dcache_port = system.cpu.dcache.cpu_side
+
+system.l2bus = L2XBar()
+system.cpu.icache.mem_side = system.l2bus.slave
+system.cpu.dcache.mem_side = system.l2bus.slave
+system.l2 = cache("256kB", 8, 8)
+system.l2.cpu_side = system.l2bus.master
+
+system.l3bus = L2XBar()
+system.l2.mem_side = system.l3bus.slave
+system.l3 = cache("4MB", 16, 20,
+                  atomic_backdoor = options.mode == "backdoor")
+system.l3.cpu_side = system.l3bus.master
+system.l3.mem_side = system.membus.slave
+
+HostBench.connectInterrupts(system, system.cpu)
+
+guest_out = os.path.join(m5.options.outdir, "mem-bench.out")
+HostBench.setWorkload(system.cpu,
+                      [options.binary, str(options.buffer_size),
+                       str(options.passes)], guest_out)
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+elapsed = HostBench.runToExit("mem-bench", guest_out)
+
+insts = system.cpu.totalInsts()
+print("%d instructions in %.2f s (%s)" % (insts, elapsed, options.mode))
+print("%.2f MIPS" % (insts / elapsed / 1e6))
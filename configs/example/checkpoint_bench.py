@@ -0,0 +1,124 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import os
+import time
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import HostBench
+
+# This script measures the host wall time needed to write and restore
+# a physical memory checkpoint in the different formats supported by
+# the System. A traffic generator first writes a configurable
+# fraction of the memory, leaving the rest zero as in a typical
+# guest, and a checkpoint is then taken. Restoring is done by running
+# the script a second time with --restore and the same options, e.g.
+#
+#   gem5.opt checkpoint_bench.py --format chunked --mem-size 8GB
+#   gem5.opt checkpoint_bench.py --format chunked --mem-size 8GB --restore
+
+parser = HostBench.makeParser()
+
+parser.add_argument("--mem-size", default="4GB",
+                    help="Size of the simulated memory")
+parser.add_argument("--fill", type=float, default=0.25,
+                    help="Fraction of the memory written before "
+                    "checkpointing")
+parser.add_argument("--format", default="gzip",
+                    choices=MemoryCheckpointFormat.vals,
+                    help="Physical memory checkpoint format")
+parser.add_argument("--chunk-size", default="256kB",
+                    help="Chunk size of the chunked format")
+parser.add_argument("--threads", type=int, default=0,
+                    help="Host threads used by the chunked format, "
+                    "0 uses all host threads")
+parser.add_argument("--checkpoint-dir", default=None,
+                    help="Checkpoint directory, defaults to a directory "
+                    "in the output directory named after the format")
+parser.add_argument("--restore", action="store_true",
+                    help="Restore the checkpoint instead of creating it")
+parser.add_argument("--cow", action="store_true",
+                    help="Map raw checkpoints copy-on-write on restore")
+
+options = parser.parse_args()
+
+ckpt_dir = options.checkpoint_dir or \
+    os.path.join(m5.options.outdir, "cpt.%s" % options.format)
+
+# the ideal memory keeps the time spent filling it short
+system = HostBench.makeSystem(options.mem_size, "timing", width = 64)
+system.checkpoint_mem_format = options.format
+system.checkpoint_mem_chunk_size = options.chunk_size
+system.checkpoint_mem_threads = options.threads
+system.checkpoint_mem_cow = options.cow
+
+system.tgen = PyTrafficGen()
+system.tgen.port = system.membus.slave
+
+root = Root(full_system = False, system = system)
+
+mem_size = system.mem_ranges[0].size()
+
+if options.restore:
+    start = time.time()
+    m5.instantiate(ckpt_dir)
+    elapsed = time.time() - start
+    print("Restored %d bytes (%s) in %.2f s" %
+          (mem_size, options.format, elapsed))
+else:
+    m5.instantiate()
+
+    block_size = 64
+    period = 1000
+    fill_bytes = int(mem_size * options.fill) // block_size * block_size
+
+    def fill():
+        if fill_bytes:
+            yield system.tgen.createLinear(fill_bytes // block_size * period,
+                                           0, fill_bytes - 1, block_size,
+                                           period, period, 0, fill_bytes)
+        yield system.tgen.createExit(0)
+
+    system.tgen.start(fill())
+    m5.simulate()
+
+    start = time.time()
+    m5.checkpoint(ckpt_dir)
+    elapsed = time.time() - start
+
+    ckpt_bytes = sum(os.path.getsize(os.path.join(ckpt_dir, f))
+                     for f in os.listdir(ckpt_dir))
+    print("Checkpointed %d bytes (%s, %.0f%% written) in %.2f s, "
+          "%d bytes on disk" % (mem_size, options.format,
+                                options.fill * 100, elapsed, ckpt_bytes))
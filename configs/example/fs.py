@@ -352,6 +352,8 @@ elif len(bm) == 1 and options.dist:
                         options.ethernet_linkspeed,
                         options.ethernet_linkdelay,
                         options.etherdump);
+    root.etherlink.sync_repeat_max = options.dist_sync_repeat_max
+    root.etherlink.transport = options.dist_transport
 elif len(bm) == 1:
     root = Root(full_system=True, system=test_sys)
 else:
@@ -361,6 +363,19 @@ else:
 if options.timesync:
     root.time_sync_enable = True
 
+if options.disk_overlay_dir:
+    if not os.path.isdir(options.disk_overlay_dir):
+        os.makedirs(options.disk_overlay_dir)
+    for obj in root.descendants():
+        if isinstance(obj, CowDiskImage):
+            obj.overlay_file = os.path.join(options.disk_overlay_dir,
+                                            '%s.overlay' % obj.path())
+
+if options.disk_stream_io:
+    for obj in root.descendants():
+        if isinstance(obj, RawDiskImage):
+            obj.use_mmap = False
+
 if options.frame_capture:
     VncServer.frame_capture = True
 
@@ -0,0 +1,102 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import os
+import re
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import HostBench
+
+# This script measures host throughput of the O3 CPU and how often it
+# has to go to the heap for a new DynInst. It runs
+# tests/test-progs/block-bench, an integer sorting loop with many
+# data-dependent branches, on a DerivO3CPU in front of an ideal memory,
+# so a large share of the fetched instructions are squashed on the
+# wrong path. Besides the host MIPS it reports how many DynInsts were
+# created and how many heap allocations were made per committed
+# instruction. Running it on builds before and after a change to DynInst
+# allocation shows the effect on host throughput, e.g.
+#
+#   gem5.opt o3_alloc_bench.py
+#   gem5.opt o3_alloc_bench.py --iterations 4000 --rob-entries 384
+
+parser = HostBench.makeParser()
+
+HostBench.addBinaryOption(parser, "block-bench")
+parser.add_argument("--iterations", type=int, default=1000,
+                    help="Iterations of the sorting loop in the guest")
+parser.add_argument("--rob-entries", type=int, default=192,
+                    help="Number of reorder buffer entries")
+parser.add_argument("--mem-size", default="512MB",
+                    help="Size of the simulated memory")
+
+options = parser.parse_args()
+
+HostBench.checkBinary(options.binary, "block-bench")
+
+system = HostBench.makeSystem(options.mem_size, "timing")
+
+system.cpu = DerivO3CPU(numROBEntries = options.rob_entries)
+system.cpu.icache_port = system.membus.slave
+system.cpu.dcache_port = system.membus.slave
+HostBench.connectInterrupts(system, system.cpu)
+
+guest_out = os.path.join(m5.options.outdir, "block-bench.out")
+HostBench.setWorkload(system.cpu,
+                      [options.binary, str(options.iterations)], guest_out)
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+elapsed = HostBench.runToExit("block-bench", guest_out)
+
+m5.stats.dump()
+
+def readStat(name):
+    stats_file = os.path.join(m5.options.outdir, m5.options.stats_file)
+    pattern = re.compile(r"^system\.cpu\.%s\s+(\S+)" % re.escape(name))
+    with open(stats_file) as f:
+        for line in f:
+            match = pattern.match(line)
+            if match:
+                return float(match.group(1))
+    fatal("%s not found in %s", name, stats_file)
+
+insts = system.cpu.totalInsts()
+print("%d instructions in %.2f s" % (insts, elapsed))
+print("%.2f MIPS" % (insts / elapsed / 1e6))
+print("%.3f DynInsts per committed instruction" %
+      readStat("dynInstsPerInst"))
+print("%.6f heap allocations per committed instruction" %
+      readStat("dynInstHeapAllocsPerInst"))
@@ -0,0 +1,116 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import os
+import struct
+import time
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import HostBench
+from common import ObjectList
+
+# This script measures the host speed of a prefetcher on a recorded
+# access stream. A binary packet trace, e.g. the misses of an L1
+# captured by a MemTraceProbe with trace_format = 'binary' and
+# with_pc = True, is replayed as fast as possible into a cache using
+# the selected prefetcher, in front of an ideal memory. The host time
+# of the replay gives the rate at which the prefetcher tables are
+# looked up, e.g.
+#
+#   gem5.opt prefetcher_bench.py l1d_misses.trc \
+#       --prefetcher SignaturePathPrefetcherV2
+
+parser = HostBench.makeParser()
+
+parser.add_argument("trace", help="Binary packet trace to replay")
+parser.add_argument("--prefetcher", default="StridePrefetcher",
+                    choices=ObjectList.hwp_list.get_names(),
+                    help="Prefetcher to benchmark")
+parser.add_argument("--size", default="256kB",
+                    help="Size of the cache using the prefetcher")
+parser.add_argument("--assoc", type=int, default=8,
+                    help="Associativity of the cache using the prefetcher")
+parser.add_argument("--mem-size", default="4GB",
+                    help="Size of the memory covered by the trace")
+
+options = parser.parse_args()
+
+def count_records(trace):
+    # Follows the header layout of mem/packet_trace.cc
+    with open(trace, "rb") as f:
+        header = f.read(32)
+        if len(header) < 32 or header[:8] != b"gem5ptrc":
+            fatal("%s is not a binary packet trace", trace)
+        _, _, record_size, _, obj_id_len, num_id_strings = \
+            struct.unpack("<8sIIQII", header)
+        offset = len(header) + obj_id_len
+        f.seek(offset)
+        for _ in range(num_id_strings):
+            _, length = struct.unpack("<II", f.read(8))
+            offset += 8 + length
+            f.seek(offset)
+    offset = (offset + 7) // 8 * 8
+    return (os.path.getsize(trace) - offset) // record_size
+
+num_accesses = count_records(options.trace)
+
+# the ideal memory keeps the host time spent outside the cache short
+system = HostBench.makeSystem(options.mem_size, "timing", width = 64)
+
+system.tgen = PyTrafficGen()
+
+system.cache = Cache(size = options.size, assoc = options.assoc,
+                     tag_latency = 1, data_latency = 1,
+                     response_latency = 1, mshrs = 64, tgts_per_mshr = 16)
+system.cache.prefetcher = ObjectList.hwp_list.get(options.prefetcher)()
+system.tgen.port = system.cache.cpu_side
+system.cache.mem_side = system.membus.slave
+
+root = Root(full_system = False, system = system)
+
+m5.instantiate()
+
+def replay():
+    yield system.tgen.createTrace(0, options.trace)
+    yield system.tgen.createExit(0)
+
+system.tgen.start(replay())
+
+start = time.time()
+m5.simulate()
+elapsed = time.time() - start
+
+print("Replayed %d accesses through %s in %.2f s, %.0f accesses/s" %
+      (num_accesses, options.prefetcher, elapsed,
+       num_accesses / elapsed if elapsed else 0))
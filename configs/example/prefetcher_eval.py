@@ -0,0 +1,95 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import argparse
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import ObjectList
+
+# This script compares prefetchers on a recorded access stream without
+# running a timing simulation per prefetcher. The trace is a binary
+# packet trace with PCs, e.g. the misses of an L1 recorded by a
+# MemTraceProbe with trace_format = 'binary' and with_pc = True. All
+# the prefetchers given with --prefetcher see the trace in a single
+# pass, and stats.txt reports their coverage, accuracy and lateness,
+# e.g.
+#
+#   gem5.opt prefetcher_eval.py l1d_misses.trc --prefetcher BOPPrefetcher \
+#       --prefetcher SignaturePathPrefetcherV2 --prefetcher STeMSPrefetcher
+
+parser = argparse.ArgumentParser(
+  formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("trace", help="Binary packet trace to replay")
+parser.add_argument("--prefetcher", action="append", default=[],
+                    choices=ObjectList.hwp_list.get_names(),
+                    help="Prefetcher to evaluate, can be given several "
+                    "times")
+parser.add_argument("--cache-size", default="1MB",
+                    help="Size of the cache model of each prefetcher")
+parser.add_argument("--fill-latency", default="100ns",
+                    help="Latency from the issue of a prefetch to its fill")
+parser.add_argument("--cache-line-size", type=int, default=64,
+                    help="Cache line size in bytes")
+parser.add_argument("--max-accesses", type=int, default=0,
+                    help="Accesses to replay, 0 replays the whole trace")
+
+options = parser.parse_args()
+
+pf_types = options.prefetcher or ["StridePrefetcher"]
+
+system = System(cache_line_size = options.cache_line_size)
+system.clk_domain = SrcClockDomain(clock = "1GHz",
+                                   voltage_domain = VoltageDomain())
+
+# nothing is simulated behind the evaluator, a small memory is only
+# there to terminate the system port
+system.mem_ranges = [AddrRange("1MB")]
+system.mem = SimpleMemory(range = system.mem_ranges[0])
+system.system_port = system.mem.port
+
+system.evaluator = PrefetcherEvaluator(
+    trace_file = options.trace,
+    prefetchers = [ ObjectList.hwp_list.get(pf_type)()
+                    for pf_type in pf_types ],
+    cache_size = options.cache_size,
+    fill_latency = options.fill_latency,
+    max_accesses = options.max_accesses)
+
+root = Root(full_system = False, system = system)
+
+m5.instantiate()
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
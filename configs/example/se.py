@@ -242,6 +242,9 @@ for i in range(np):
             ObjectList.indirect_bp_list.get(options.indirect_bp_type)
         system.cpu[i].branchPred.indirectBranchPred = indirectBPClass()
 
+    if options.branch_trace:
+        CpuConfig.config_branch_trace(system.cpu[i])
+
     system.cpu[i].createThreads()
 
 if options.ruby:
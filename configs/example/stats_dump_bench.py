@@ -0,0 +1,128 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import os
+import time
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, fatal
+
+addToPath('../')
+
+from common import HostBench
+
+try:
+    from urllib.parse import urlsplit
+except ImportError:
+    # Python 2 fallback
+    from urlparse import urlsplit
+
+# This script measures how long periodic stat dumps take for a large
+# system. It builds a system of --cores atomic CPUs, each with private
+# L1 caches in front of a shared L2, runs a copy of
+# tests/test-progs/block-bench on every core and dumps the stats every
+# --period ticks. Only the time spent in m5.stats.dump() is counted. The
+# output format is picked with gem5's own --stats-file option, so
+# running the script once per format compares their dump cost and file
+# size, e.g.
+#
+#   gem5.opt --stats-file=stats.txt stats_dump_bench.py
+#   gem5.opt --stats-file=col://stats.col stats_dump_bench.py
+
+parser = HostBench.makeParser()
+
+HostBench.addBinaryOption(parser, "block-bench")
+parser.add_argument("--cores", type=int, default=64,
+                    help="Number of CPUs in the system")
+parser.add_argument("--dumps", type=int, default=100,
+                    help="Number of stat dumps to time")
+parser.add_argument("--period", type=int, default=1000000,
+                    help="Ticks simulated between two dumps")
+parser.add_argument("--mem-size", default="4GB",
+                    help="Size of the simulated memory")
+
+options = parser.parse_args()
+
+HostBench.checkBinary(options.binary, "block-bench")
+
+system = HostBench.makeSystem(options.mem_size, "atomic")
+
+system.l2bus = L2XBar()
+system.l2 = Cache(size = "8MB", assoc = 16, tag_latency = 20,
+                  data_latency = 20, response_latency = 20,
+                  mshrs = 64, tgts_per_mshr = 12)
+system.l2.cpu_side = system.l2bus.master
+system.l2.mem_side = system.membus.slave
+
+def l1Cache():
+    return Cache(size = "32kB", assoc = 8, tag_latency = 2,
+                 data_latency = 2, response_latency = 2,
+                 mshrs = 4, tgts_per_mshr = 20)
+
+# Keep the guests running for longer than all dump periods together.
+iterations = 1 << 30
+
+system.cpu = [ AtomicSimpleCPU(cpu_id = i) for i in range(options.cores) ]
+for i, cpu in enumerate(system.cpu):
+    cpu.icache = l1Cache()
+    cpu.dcache = l1Cache()
+    cpu.icache_port = cpu.icache.cpu_side
+    cpu.dcache_port = cpu.dcache.cpu_side
+    cpu.icache.mem_side = system.l2bus.slave
+    cpu.dcache.mem_side = system.l2bus.slave
+    HostBench.connectInterrupts(system, cpu)
+    HostBench.setWorkload(cpu, [options.binary, str(iterations)],
+                          os.path.join(m5.options.outdir,
+                                       "block-bench.%d.out" % i),
+                          pid = 100 + i)
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+elapsed = 0.0
+for i in range(options.dumps):
+    exit_event = m5.simulate(options.period)
+    if exit_event.getCause() != "simulate() limit reached":
+        fatal("Benchmark stopped early: %s", exit_event.getCause())
+
+    start = time.time()
+    m5.stats.dump()
+    elapsed += time.time() - start
+
+stats_url = urlsplit(m5.options.stats_file)
+stats_path = os.path.join(m5.options.outdir,
+                          stats_url.netloc + stats_url.path)
+stats_size = os.path.getsize(stats_path)
+
+print("%d dumps of %d cores in %.2f s (%s)" %
+      (options.dumps, options.cores, elapsed, m5.options.stats_file))
+print("%.2f ms per dump" % (elapsed / options.dumps * 1e3))
+print("%.2f MB written, %.2f kB per dump" %
+      (stats_size / 1e6, stats_size / 1e3 / options.dumps))
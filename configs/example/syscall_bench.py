@@ -0,0 +1,106 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import os
+import re
+
+import m5
+from m5.objects import *
+from m5.util import addToPath, convert, fatal
+
+addToPath('../')
+
+from common import HostBench
+
+# This script measures the host time SE mode spends on syscalls that
+# move data between guest memory and host file descriptors. It runs
+# tests/test-progs/syscall-bench, which loops over read, write, pread,
+# pwrite, readv and writev on a scratch file and maps the file with
+# mmap, on an atomic CPU without caches in front of an ideal memory.
+# Comparing runs with and without --memory-backdoors shows the effect
+# of copying guest buffers straight through the memory backdoor, e.g.
+#
+#   gem5.opt syscall_bench.py --size 64kB
+#   gem5.opt syscall_bench.py --size 64kB --memory-backdoors
+
+parser = HostBench.makeParser()
+
+HostBench.addBinaryOption(parser, "syscall-bench")
+parser.add_argument("--iterations", type=int, default=1000,
+                    help="Iterations of the read/write loop in the guest")
+parser.add_argument("--size", default="64kB",
+                    help="Size of the buffer moved by every syscall")
+parser.add_argument("--memory-backdoors", action="store_true",
+                    help="Let the CPU and the syscall emulation access "
+                    "memory through backdoors")
+parser.add_argument("--mem-size", default="512MB",
+                    help="Size of the simulated memory")
+
+options = parser.parse_args()
+
+HostBench.checkBinary(options.binary, "syscall-bench")
+
+# the ideal memory keeps the host time dominated by the syscalls
+system = HostBench.makeSystem(options.mem_size, "atomic")
+
+system.cpu = AtomicSimpleCPU(memory_backdoors = options.memory_backdoors)
+system.cpu.icache_port = system.membus.slave
+system.cpu.dcache_port = system.membus.slave
+HostBench.connectInterrupts(system, system.cpu)
+
+buf_bytes = int(convert.toMemorySize(options.size))
+scratch = os.path.join(m5.options.outdir, "syscall-bench.dat")
+guest_out = os.path.join(m5.options.outdir, "syscall-bench.out")
+HostBench.setWorkload(system.cpu,
+                      [options.binary, scratch, str(options.iterations),
+                       str(buf_bytes)], guest_out)
+
+root = Root(full_system = False, system = system)
+m5.instantiate()
+
+elapsed = HostBench.runToExit("syscall-bench", guest_out,
+                              check_code = False)
+
+results = {}
+with open(guest_out) as f:
+    for line in f:
+        match = re.match(r"(\w+): (\d+)", line)
+        if match:
+            results[match.group(1)] = int(match.group(2))
+
+syscalls = results.get("syscalls", 0)
+moved = results.get("bytes", 0)
+if not syscalls:
+    fatal("No results found in %s", guest_out)
+
+print("%d syscalls moving %d bytes in %.2f s (backdoors %s)" %
+      (syscalls, moved, elapsed,
+       "on" if options.memory_backdoors else "off"))
+print("%.2f us per syscall, %.1f MB/s" %
+      (elapsed * 1e6 / syscalls, moved / elapsed / 1e6))
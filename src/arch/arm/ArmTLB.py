@@ -49,6 +49,8 @@ class ArmTableWalker(ClockedObject):
     is_stage2 =  Param.Bool(False, "Is this object for stage 2 translation?")
     num_squash_per_cycle = Param.Unsigned(2,
             "Number of outstanding walks that can be squashed per cycle")
+    shared_tlb = Param.SharedTLB(NULL,
+        "Second level TLB probed before walking the translation tables")
 
     # The port to the memory system. This port is ultimately belonging
     # to the Stage2MMU, and shared by the two table walkers, but we
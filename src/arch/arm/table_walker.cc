@@ -56,7 +56,7 @@ using namespace ArmISA;
 TableWalker::TableWalker(const Params *p)
     : ClockedObject(p),
       stage2Mmu(NULL), port(NULL), masterId(Request::invldMasterId),
-      isStage2(p->is_stage2), tlb(NULL),
+      isStage2(p->is_stage2), tlb(NULL), sharedTlb(p->shared_tlb),
       currState(NULL), pending(false),
       numSquashable(p->num_squash_per_cycle),
       pendingReqs(0),
@@ -136,7 +136,7 @@ TableWalker::WalkerState::WalkerState() :
     pxnTable(false), hpd(false), stage2Req(false),
     stage2Tran(nullptr), timing(false), functional(false),
     mode(BaseTLB::Read), tranType(TLB::NormalTran), l2Desc(l1Desc),
-    delayed(false), tableWalker(nullptr)
+    delayed(false), tableWalker(nullptr), startTime(0), levels(0)
 {
 }
 
@@ -252,6 +252,7 @@ TableWalker::walk(const RequestPtr &_req, ThreadContext *_tc, uint16_t _asid,
     currState->tranType = tranType;
     currState->isSecure = secure;
     currState->physAddrRange = physAddrRange;
+    currState->levels = 0;
 
     /** @todo These should be cached or grabbed from cached copies in
      the TLB, all these miscreg reads are expensive */
@@ -322,6 +323,25 @@ TableWalker::walk(const RequestPtr &_req, ThreadContext *_tc, uint16_t _asid,
         ++statWalksShortDescriptor;
     }
 
+    if (!currState->functional && lookupSharedTlb()) {
+        if (!currState->timing) {
+            currState->tc = NULL;
+            currState->req = NULL;
+            return NoFault;
+        }
+
+        // Let the walk wrapper finish the translation from the TLB after
+        // the lookup latency
+        pendingQueue.push_back(currState);
+        currState = NULL;
+        pendingChange();
+        if (!pending && !doProcessEvent.scheduled()) {
+            schedule(doProcessEvent,
+                     clockEdge(sharedTlb->lookupLatency()));
+        }
+        return NoFault;
+    }
+
     if (!currState->timing) {
         Fault fault = NoFault;
         if (currState->aarch64)
@@ -358,6 +378,34 @@ TableWalker::walk(const RequestPtr &_req, ThreadContext *_tc, uint16_t _asid,
     return NoFault;
 }
 
+uint64_t
+TableWalker::sharedTlbContext() const
+{
+    // Every field gets its own bits, with room for 16-bit ASIDs and VMIDs
+    return (uint64_t)currState->asid | (uint64_t)currState->vmid << 16 |
+        (uint64_t)currState->isHyp << 32 |
+        (uint64_t)currState->isSecure << 33 |
+        (uint64_t)currState->el << 34 | (uint64_t)isStage2 << 36;
+}
+
+bool
+TableWalker::lookupSharedTlb()
+{
+    if (!sharedTlb)
+        return false;
+
+    const TlbEntry *te = sharedTlb->lookup<TlbEntry>(currState->vaddr,
+                                                     sharedTlbContext());
+    if (!te)
+        return false;
+
+    DPRINTF(TLB, "Shared TLB hit for address %#x\n", currState->vaddr);
+    statSharedTlbHits++;
+    TlbEntry entry = *te;
+    tlb->insert(currState->vaddr, entry);
+    return true;
+}
+
 void
 TableWalker::processWalkWrapper()
 {
@@ -2005,6 +2053,7 @@ TableWalker::fetchDescriptor(Addr descAddr, uint8_t *data, int numBytes,
     void (TableWalker::*doDescriptor)())
 {
     bool isTiming = currState->timing;
+    currState->levels++;
 
     DPRINTF(TLBVerbose, "Fetching descriptor at address: 0x%x stage2Req: %d\n",
             descAddr, currState->stage2Req);
@@ -2140,6 +2189,13 @@ TableWalker::insertTableEntry(DescriptorBase &descriptor, bool longDescriptor)
 
     // Insert the entry into the TLB
     tlb->insert(currState->vaddr, te);
+    if (!currState->functional) {
+        statWalkMemRefs.sample(currState->levels);
+        if (sharedTlb) {
+            sharedTlb->insert(currState->vaddr, te.N, sharedTlbContext(),
+                              te.global, te);
+        }
+    }
     if (!currState->timing) {
         currState->tc  = NULL;
         currState->req = NULL;
@@ -2291,6 +2347,19 @@ TableWalker::regStats()
         .flags(Stats::pdf | Stats::dist | Stats::nozero | Stats::nonan)
         ;
 
+    statWalkMemRefs
+        .init(8)
+        .name(name() + ".walkMemRefs")
+        .desc("Descriptor reads per completed table walk")
+        .flags(Stats::pdf | Stats::nozero | Stats::nonan)
+        ;
+
+    statSharedTlbHits
+        .name(name() + ".sharedTlbHits")
+        .desc("Table walks avoided by a hit in the shared TLB")
+        .flags(Stats::nozero)
+        ;
+
     statPageSizes // see DDI 0487A D4-1661
         .init(9)
         .name(name() + ".walkPageSizes")
@@ -44,6 +44,7 @@
 #include "arch/arm/miscregs.hh"
 #include "arch/arm/system.hh"
 #include "arch/arm/tlb.hh"
+#include "arch/generic/shared_tlb.hh"
 #include "mem/request.hh"
 #include "params/ArmTableWalker.hh"
 #include "sim/clocked_object.hh"
@@ -838,6 +839,9 @@ class TableWalker : public ClockedObject
     /** TLB that is initiating these table walks */
     TLB *tlb;
 
+    /** Second level TLB probed before walking, may be shared */
+    SharedTLB *sharedTlb;
+
     /** Cached copy of the sctlr as it existed when translation began */
     SCTLR sctlr;
 
@@ -868,6 +872,8 @@ class TableWalker : public ClockedObject
     Stats::Histogram statWalkWaitTime;
     Stats::Histogram statWalkServiceTime;
     Stats::Histogram statPendingWalks; // essentially "L" of queueing theory
+    Stats::Histogram statWalkMemRefs;
+    Stats::Scalar statSharedTlbHits;
     Stats::Vector statPageSizes;
     Stats::Vector2d statRequestOrigin;
 
@@ -911,6 +917,7 @@ class TableWalker : public ClockedObject
 
     void setTlb(TLB *_tlb) { tlb = _tlb; }
     TLB* getTlb() { return tlb; }
+    SharedTLB *getSharedTlb() const { return sharedTlb; }
     void setMMU(Stage2MMU *m, MasterID master_id);
     void memAttrs(ThreadContext *tc, TlbEntry &te, SCTLR sctlr,
                   uint8_t texcb, bool s);
@@ -923,6 +930,16 @@ class TableWalker : public ClockedObject
 
   private:
 
+    /** Address space identifier of the shared TLB entries of a walk */
+    uint64_t sharedTlbContext() const;
+
+    /**
+     * Look the current walk up in the shared TLB, and fill the TLB with
+     * the translation on a hit.
+     * @return Whether the walk can be avoided.
+     */
+    bool lookupSharedTlb();
+
     void doL1Descriptor();
     void doL1DescriptorWrapper();
     EventFunctionWrapper doL1DescEvent;
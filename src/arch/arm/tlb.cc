@@ -265,6 +265,11 @@ TLB::flushAllSecurity(bool secure_lookup, ExceptionLevel target_el,
 
     flushTlb++;
 
+    // The shared TLB does not track the security state and exception level
+    // of its entries, conservatively drop all of them
+    if (tableWalker->getSharedTlb())
+        tableWalker->getSharedTlb()->flushAll();
+
     // If there's a second stage TLB (and we're not it) then flush it as well
     // if we're currently in hyp mode
     if (!isStage2 && isHyp) {
@@ -297,6 +302,10 @@ TLB::flushAllNs(ExceptionLevel target_el, bool ignore_el)
 
     flushTlb++;
 
+    // See flushAllSecurity() about the shared TLB
+    if (tableWalker->getSharedTlb())
+        tableWalker->getSharedTlb()->flushAll();
+
     // If there's a second stage TLB (and we're not it) then flush it as well
     if (!isStage2 && !hyp) {
         stage2Tlb->flushAllNs(EL1, true);
@@ -336,6 +345,9 @@ TLB::flushAsid(uint64_t asn, bool secure_lookup, ExceptionLevel target_el)
         ++x;
     }
     flushTlbAsid++;
+
+    if (tableWalker->getSharedTlb())
+        tableWalker->getSharedTlb()->flushAll();
 }
 
 void
@@ -368,6 +380,9 @@ TLB::_flushMva(Addr mva, uint64_t asn, bool secure_lookup,
         te = lookup(mva, asn, vmid, hyp, secure_lookup, false, ignore_asn,
                     target_el);
     }
+
+    if (tableWalker->getSharedTlb())
+        tableWalker->getSharedTlb()->demapPage(mva);
 }
 
 void
@@ -44,14 +44,12 @@ BasicDecodeCache::decode(TheISA::Decoder *decoder,
     if (si && (si->machInst == mach_inst))
         return si;
 
-    auto iter = instMap.find(mach_inst);
-    if (iter != instMap.end()) {
-        si = iter->second;
+    si = instMap.lookup(mach_inst);
+    if (si)
         return si;
-    }
 
     si = decoder->decodeInst(mach_inst);
-    instMap[mach_inst] = si;
+    instMap.insert(mach_inst, si);
     return si;
 }
 
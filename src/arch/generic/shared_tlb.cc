@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "arch/generic/shared_tlb.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/TLB.hh"
+#include "params/SharedTLB.hh"
+
+SharedTLB::SharedTLB(const Params *p)
+    : SimObject(p), assoc(p->assoc),
+      numSets(p->assoc ? p->size / p->assoc : 0),
+      _lookupLatency(p->lookup_latency), entries(p->size), useSeq(0),
+      stats(*this)
+{
+    fatal_if(!assoc || p->size % assoc || !isPowerOf2(numSets),
+             "%s: the number of sets must be a non-zero power of 2.\n",
+             name());
+}
+
+unsigned
+SharedTLB::setIndex(Addr va, unsigned log_bytes) const
+{
+    const unsigned set_bits = floorLog2(numSets);
+    const Addr vpn = va >> log_bytes;
+    return (vpn ^ (vpn >> set_bits) ^ (vpn >> (2 * set_bits)) ^ log_bytes) &
+           (numSets - 1);
+}
+
+SharedTLB::Entry *
+SharedTLB::findEntry(Addr va, uint64_t context)
+{
+    for (const auto log_bytes : pageSizes) {
+        const unsigned first = setIndex(va, log_bytes) * assoc;
+        for (unsigned idx = first; idx < first + assoc; idx++) {
+            Entry &entry = entries[idx];
+            if (entry.valid && entry.logBytes == log_bytes &&
+                entry.vpn == (va >> log_bytes) && entry.context == context) {
+                return &entry;
+            }
+        }
+    }
+    return nullptr;
+}
+
+const SharedTLB::Payload *
+SharedTLB::lookupPayload(Addr va, uint64_t context)
+{
+    Entry *entry = findEntry(va, context);
+    if (!entry) {
+        stats.misses++;
+        return nullptr;
+    }
+
+    stats.hits++;
+    entry->lastUse = ++useSeq;
+    return entry->payload.get();
+}
+
+void
+SharedTLB::insertPayload(Addr va, unsigned log_bytes, uint64_t context,
+                         bool global, std::unique_ptr<Payload> payload)
+{
+    // Another walker may have filled the same translation already
+    Entry *entry = findEntry(va, context);
+    if (!entry || entry->logBytes != log_bytes) {
+        const unsigned first = setIndex(va, log_bytes) * assoc;
+        entry = &entries[first];
+        for (unsigned idx = first; idx < first + assoc; idx++) {
+            if (!entries[idx].valid) {
+                entry = &entries[idx];
+                break;
+            }
+            if (entries[idx].lastUse < entry->lastUse)
+                entry = &entries[idx];
+        }
+        if (entry->valid) {
+            DPRINTF(TLB, "%s: evicting the translation of %#x.\n", name(),
+                    entry->vpn << entry->logBytes);
+            stats.evictions++;
+        }
+    }
+
+    entry->valid = true;
+    entry->global = global;
+    entry->logBytes = log_bytes;
+    entry->vpn = va >> log_bytes;
+    entry->context = context;
+    entry->lastUse = ++useSeq;
+    entry->payload = std::move(payload);
+    stats.inserts++;
+
+    if (std::find(pageSizes.begin(), pageSizes.end(), log_bytes) ==
+        pageSizes.end()) {
+        pageSizes.push_back(log_bytes);
+    }
+}
+
+void
+SharedTLB::flushAll()
+{
+    DPRINTF(TLB, "%s: invalidating all entries.\n", name());
+    for (auto &entry : entries) {
+        entry.valid = false;
+        entry.payload.reset();
+    }
+    stats.flushes++;
+}
+
+void
+SharedTLB::flushNonGlobal()
+{
+    DPRINTF(TLB, "%s: invalidating all non global entries.\n", name());
+    for (auto &entry : entries) {
+        if (!entry.global) {
+            entry.valid = false;
+            entry.payload.reset();
+        }
+    }
+    stats.flushes++;
+}
+
+void
+SharedTLB::demapPage(Addr va)
+{
+    for (const auto log_bytes : pageSizes) {
+        const unsigned first = setIndex(va, log_bytes) * assoc;
+        for (unsigned idx = first; idx < first + assoc; idx++) {
+            Entry &entry = entries[idx];
+            if (entry.valid && entry.logBytes == log_bytes &&
+                entry.vpn == (va >> log_bytes)) {
+                entry.valid = false;
+                entry.payload.reset();
+            }
+        }
+    }
+}
+
+SharedTLB::SharedTLBStats::SharedTLBStats(SharedTLB &tlb)
+    : Stats::Group(&tlb),
+    hits(this, "hits", "Number of lookups that found a translation"),
+    misses(this, "misses",
+           "Number of lookups that did not find a translation"),
+    missRate(this, "miss_rate", "Miss rate of the lookups"),
+    inserts(this, "inserts", "Number of translations inserted"),
+    evictions(this, "evictions", "Number of valid translations replaced"),
+    flushes(this, "flushes", "Number of full or non global flushes")
+{
+}
+
+void
+SharedTLB::SharedTLBStats::regStats()
+{
+    Stats::Group::regStats();
+
+    missRate = misses / (hits + misses);
+}
+
+SharedTLB *
+SharedTLBParams::create()
+{
+    return new SharedTLB(this);
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a second level TLB that can be shared by the page table
+ * walkers of several (possibly differently architected) first level TLBs.
+ */
+
+#ifndef __ARCH_GENERIC_SHARED_TLB_HH__
+#define __ARCH_GENERIC_SHARED_TLB_HH__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/cast.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "sim/sim_object.hh"
+
+struct SharedTLBParams;
+
+/**
+ * A set associative, LRU replaced second level TLB. The walkers probe it
+ * before walking the page table and fill it with every translation they
+ * complete, so that a miss in a first level TLB that hits here costs a
+ * single lookup latency instead of a page walk.
+ *
+ * The translations themselves are opaque to this object: each entry holds
+ * an ISA specific payload, and is tagged with the virtual page, the page
+ * size and a context identifier (e.g., the page table base or the ASID and
+ * VMID) computed by the walker that filled it. Lookups probe one hashed
+ * set per page size in use.
+ */
+class SharedTLB : public SimObject
+{
+  public:
+    /** ISA specific translation state stored alongside an entry. */
+    struct Payload
+    {
+        virtual ~Payload() {}
+    };
+
+    /** Convenience payload holding a copy of an ISA TLB entry. */
+    template <class Entry>
+    struct EntryPayload : public Payload
+    {
+        Entry entry;
+
+        EntryPayload(const Entry &_entry) : entry(_entry) {}
+    };
+
+  protected:
+    struct Entry
+    {
+        bool valid;
+        bool global;
+        unsigned logBytes;
+        Addr vpn;
+        uint64_t context;
+        uint64_t lastUse;
+        std::unique_ptr<Payload> payload;
+
+        Entry() : valid(false), global(false), logBytes(0), vpn(0),
+                  context(0), lastUse(0)
+        {}
+    };
+
+    const unsigned assoc;
+    const unsigned numSets;
+    const Cycles _lookupLatency;
+
+    std::vector<Entry> entries;
+
+    /** Page sizes of the translations inserted so far. */
+    std::vector<unsigned> pageSizes;
+
+    /** Counter used to order the entries for LRU replacement. */
+    uint64_t useSeq;
+
+    unsigned setIndex(Addr va, unsigned log_bytes) const;
+    Entry *findEntry(Addr va, uint64_t context);
+
+    struct SharedTLBStats : public Stats::Group
+    {
+        SharedTLBStats(SharedTLB &tlb);
+
+        void regStats() override;
+
+        Stats::Scalar hits;
+        Stats::Scalar misses;
+        Stats::Formula missRate;
+        Stats::Scalar inserts;
+        Stats::Scalar evictions;
+        Stats::Scalar flushes;
+    } stats;
+
+  public:
+    typedef SharedTLBParams Params;
+    SharedTLB(const Params *p);
+
+    /** Latency of a lookup, in cycles of the walker probing it. */
+    Cycles lookupLatency() const { return _lookupLatency; }
+
+    /**
+     * Look up the translation of an address.
+     *
+     * @param va Virtual address to translate.
+     * @param context Address space the translation must belong to.
+     * @return The payload of the matching entry, NULL on a miss.
+     */
+    const Payload *lookupPayload(Addr va, uint64_t context);
+
+    /**
+     * Insert a translation, replacing the LRU entry of its set if needed.
+     *
+     * @param va Virtual address within the translated page.
+     * @param log_bytes Log2 of the size of the page.
+     * @param context Address space the translation belongs to.
+     * @param global Whether the entry survives flushNonGlobal().
+     * @param payload ISA specific translation state.
+     */
+    void insertPayload(Addr va, unsigned log_bytes, uint64_t context,
+                       bool global, std::unique_ptr<Payload> payload);
+
+    /** Typed wrapper of lookupPayload() for EntryPayload payloads. */
+    template <class T>
+    const T *
+    lookup(Addr va, uint64_t context)
+    {
+        const Payload *payload = lookupPayload(va, context);
+        return payload ?
+            &safe_cast<const EntryPayload<T> *>(payload)->entry : nullptr;
+    }
+
+    /** Typed wrapper of insertPayload() for EntryPayload payloads. */
+    template <class T>
+    void
+    insert(Addr va, unsigned log_bytes, uint64_t context, bool global,
+           const T &entry)
+    {
+        insertPayload(va, log_bytes, context, global,
+                      std::unique_ptr<Payload>(new EntryPayload<T>(entry)));
+    }
+
+    /** Invalidate every entry. */
+    void flushAll();
+
+    /** Invalidate every entry that is not global. */
+    void flushNonGlobal();
+
+    /** Invalidate the translations of an address in all the contexts. */
+    void demapPage(Addr va);
+};
+
+#endif // __ARCH_GENERIC_SHARED_TLB_HH__
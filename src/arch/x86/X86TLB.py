@@ -38,6 +38,7 @@ from m5.proxy import *
 
 from m5.objects.BaseTLB import BaseTLB
 from m5.objects.ClockedObject import ClockedObject
+from m5.objects.ReplacementPolicies import *
 
 class X86PagetableWalker(ClockedObject):
     type = 'X86PagetableWalker'
@@ -47,12 +48,32 @@ class X86PagetableWalker(ClockedObject):
     system = Param.System(Parent.any, "system object")
     num_squash_per_cycle = Param.Unsigned(4,
             "Number of outstanding walks that can be squashed per cycle")
+    # Paging-structure caches let long mode walks skip the upper levels of
+    # the page table; a size of 0 disables the corresponding cache.
+    pml4_cache_entries = Param.Unsigned(0,
+            "Number of entries of the PML4 entry cache")
+    pdp_cache_entries = Param.Unsigned(0,
+            "Number of entries of the PDP entry cache")
+    pde_cache_entries = Param.Unsigned(0,
+            "Number of entries of the PDE cache")
+    shared_tlb = Param.SharedTLB(NULL,
+            "Second level TLB probed before walking the page table")
 
 class X86TLB(BaseTLB):
     type = 'X86TLB'
     cxx_class = 'X86ISA::TLB'
     cxx_header = 'arch/x86/tlb.hh'
     size = Param.Unsigned(64, "TLB size")
+    # With a non-zero associativity the TLB is set associative, looks
+    # translations up with one hashed set probe per page size in use, and
+    # replaces them with replacement_policy. Policies that derive their
+    # geometry from the parent (e.g., DIPRP and DRRIPRP) need their size
+    # and assoc parameters set explicitly, since the TLB size is in
+    # entries rather than bytes.
+    assoc = Param.Unsigned(0, "TLB associativity (0 for a fully "
+                           "associative TLB with LRU replacement)")
+    replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the set associative TLB")
     system = Param.System(Parent.any, "system object")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
@@ -679,12 +679,12 @@ Decoder::InstCacheMap Decoder::instCacheMap;
 StaticInstPtr
 Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
-    auto iter = instMap->find(mach_inst);
-    if (iter != instMap->end())
-        return iter->second;
+    StaticInstPtr si = instMap->lookup(mach_inst);
+    if (si)
+        return si;
 
-    StaticInstPtr si = decodeInst(mach_inst);
-    (*instMap)[mach_inst] = si;
+    si = decodeInst(mach_inst);
+    instMap->insert(mach_inst, si);
     return si;
 }
 
@@ -64,6 +64,55 @@
 
 namespace X86ISA {
 
+// Bits of the virtual address below the tags of the paging-structure caches
+static const unsigned walkCacheShift[] = {39, 30, 21};
+
+const Walker::WalkCache::Entry *
+Walker::WalkCache::lookup(Addr tag)
+{
+    for (auto &entry : entries) {
+        if (entry.valid && entry.tag == tag) {
+            entry.lastUse = ++useSeq;
+            return &entry;
+        }
+    }
+    return NULL;
+}
+
+void
+Walker::WalkCache::insert(const Entry &entry)
+{
+    if (entries.empty())
+        return;
+
+    Entry *victim = &entries[0];
+    for (auto &candidate : entries) {
+        if (candidate.valid && candidate.tag == entry.tag) {
+            victim = &candidate;
+            break;
+        }
+        if (!candidate.valid || candidate.lastUse < victim->lastUse)
+            victim = &candidate;
+    }
+    *victim = entry;
+    victim->valid = true;
+    victim->lastUse = ++useSeq;
+}
+
+void
+Walker::WalkCache::flush()
+{
+    for (auto &entry : entries)
+        entry.valid = false;
+}
+
+void
+Walker::flushWalkCaches()
+{
+    for (auto &cache : walkCaches)
+        cache.flush();
+}
+
 Fault
 Walker::start(ThreadContext * _tc, BaseTLB::Translation *_translation,
               const RequestPtr &_req, BaseTLB::Mode _mode)
@@ -111,24 +160,29 @@ Walker::recvTimingResp(PacketPtr pkt)
     WalkerState * senderWalk = senderState->senderWalk;
     bool walkComplete = senderWalk->recvPacket(pkt);
     delete senderState;
-    if (walkComplete) {
-        std::list<WalkerState *>::iterator iter;
-        for (iter = currStates.begin(); iter != currStates.end(); iter++) {
-            WalkerState * walkerState = *(iter);
-            if (walkerState == senderWalk) {
-                iter = currStates.erase(iter);
-                break;
-            }
+    if (walkComplete)
+        retireWalk(senderWalk);
+    return true;
+}
+
+void
+Walker::retireWalk(WalkerState *walk)
+{
+    std::list<WalkerState *>::iterator iter;
+    for (iter = currStates.begin(); iter != currStates.end(); iter++) {
+        WalkerState * walkerState = *(iter);
+        if (walkerState == walk) {
+            iter = currStates.erase(iter);
+            break;
         }
-        delete senderWalk;
-        // Since we block requests when another is outstanding, we
-        // need to check if there is a waiting request to be serviced
-        if (currStates.size() && !startWalkWrapperEvent.scheduled())
-            // delay sending any new requests until we are finished
-            // with the responses
-            schedule(startWalkWrapperEvent, clockEdge());
     }
-    return true;
+    delete walk;
+    // Since we block requests when another is outstanding, we
+    // need to check if there is a waiting request to be serviced
+    if (currStates.size() && !startWalkWrapperEvent.scheduled())
+        // delay sending any new requests until we are finished
+        // with the responses
+        schedule(startWalkWrapperEvent, clockEdge());
 }
 
 void
@@ -222,12 +276,68 @@ Walker::startWalkWrapper()
         currState->startWalk();
 }
 
+void
+Walker::regStats()
+{
+    ClockedObject::regStats();
+
+    walks
+        .name(name() + ".walks")
+        .desc("Number of page table walks");
+
+    walkLatency
+        .init(16)
+        .name(name() + ".walkLatency")
+        .desc("Latency of the timing page table walks (ticks)")
+        .flags(Stats::pdf);
+
+    walkMemRefs
+        .init(8)
+        .name(name() + ".walkMemRefs")
+        .desc("Memory reads and writes issued per page table walk")
+        .flags(Stats::pdf);
+
+    walkCacheHits
+        .init(NumWalkCaches)
+        .name(name() + ".walkCacheHits")
+        .desc("Long mode walks started from a paging-structure cache hit")
+        .subname(PML4Cache, "pml4")
+        .subname(PDPCache, "pdp")
+        .subname(PDECache, "pde");
+
+    walkCacheMisses
+        .name(name() + ".walkCacheMisses")
+        .desc("Long mode walks that missed in all paging-structure caches");
+
+    sharedTLBHits
+        .name(name() + ".sharedTLBHits")
+        .desc("Walks avoided by a hit in the shared TLB");
+}
+
 Fault
 Walker::WalkerState::startWalk()
 {
     Fault fault = NoFault;
     assert(!started);
     started = true;
+    startTick = curTick();
+    memRefs = 0;
+    walker->walks++;
+    if (lookupSharedTLB()) {
+        if (timing) {
+            // Account for the lookup latency as an access in flight, so
+            // that a squash waits for it to complete
+            inflight++;
+            walker->schedule(new EventFunctionWrapper([this]{
+                    sharedTLBHitDone();
+                    walker->retireWalk(this);
+                }, name() + ".sharedTLBHitDone", true),
+                walker->clockEdge(walker->sharedTLB->lookupLatency()));
+        } else {
+            walker->tlb->insert(entry.vaddr, entry);
+        }
+        return fault;
+    }
     setupWalk(req->getVaddr());
     if (timing) {
         nextState = state;
@@ -251,6 +361,46 @@ Walker::WalkerState::startWalk()
     return fault;
 }
 
+bool
+Walker::WalkerState::lookupSharedTLB()
+{
+    if (functional || !walker->sharedTLB)
+        return false;
+
+    const TlbEntry *shared = walker->sharedTLB->lookup<TlbEntry>(
+        req->getVaddr(), tc->readMiscRegNoEffect(MISCREG_CR3));
+    if (!shared)
+        return false;
+
+    DPRINTF(PageTableWalker, "Shared TLB hit for address %#x.\n",
+            req->getVaddr());
+    walker->sharedTLBHits++;
+    // Keep a copy, the shared entry may be replaced before the lookup
+    // latency has passed
+    entry = *shared;
+    return true;
+}
+
+void
+Walker::WalkerState::sharedTLBHitDone()
+{
+    assert(inflight);
+    inflight--;
+    if (squashed)
+        return;
+
+    walker->walkLatency.sample(curTick() - startTick);
+    // Only fill the TLB now, a flush during the lookup latency would
+    // otherwise have removed the entry before the translation below. The
+    // translation is then just for the permission checks.
+    walker->tlb->insert(entry.vaddr, entry);
+    bool delayedResponse;
+    Fault fault = walker->tlb->translate(req, tc, NULL, mode,
+                                         delayedResponse, true);
+    assert(!delayedResponse);
+    translation->finish(fault, req, tc, mode);
+}
+
 Fault
 Walker::WalkerState::startFunctional(Addr &addr, unsigned &logBytes)
 {
@@ -308,6 +458,9 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             break;
         }
         entry.noExec = pte.nx;
+        walkNX = pte.nx;
+        fillWalkCache(PML4Cache, (uint64_t)pte & (mask(40) << 12),
+                      uncacheable);
         nextState = LongPDP;
         break;
       case LongPDP:
@@ -323,6 +476,9 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             fault = pageFault(pte.p);
             break;
         }
+        walkNX = walkNX || pte.nx;
+        fillWalkCache(PDPCache, (uint64_t)pte & (mask(40) << 12),
+                      uncacheable);
         nextState = LongPD;
         break;
       case LongPD:
@@ -342,6 +498,9 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             entry.logBytes = 12;
             nextRead =
                 ((uint64_t)pte & (mask(40) << 12)) + vaddr.longl1 * dataSize;
+            walkNX = walkNX || pte.nx;
+            fillWalkCache(PDECache, (uint64_t)pte & (mask(40) << 12),
+                          uncacheable);
             nextState = LongPTE;
             break;
         } else {
@@ -509,9 +668,16 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
         panic("Unknown page table walker state %d!\n");
     }
     if (doEndWalk) {
-        if (doTLBInsert)
-            if (!functional)
+        if (doTLBInsert) {
+            if (!functional) {
                 walker->tlb->insert(entry.vaddr, entry);
+                if (walker->sharedTLB) {
+                    walker->sharedTLB->insert(entry.vaddr, entry.logBytes,
+                        tc->readMiscRegNoEffect(MISCREG_CR3), entry.global,
+                        entry);
+                }
+            }
+        }
         endWalk();
     } else {
         PacketPtr oldRead = read;
@@ -522,9 +688,11 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
             nextRead, oldRead->getSize(), flags, walker->masterId);
         read = new Packet(request, MemCmd::ReadReq);
         read->allocate();
+        memRefs++;
         // If we need to write, adjust the read packet to write the modified
         // value back to memory.
         if (doWrite) {
+            memRefs++;
             write = oldRead;
             write->setLE<uint64_t>(pte);
             write->cmd = MemCmd::WriteReq;
@@ -542,6 +710,66 @@ Walker::WalkerState::endWalk()
     nextState = Ready;
     delete read;
     read = NULL;
+    if (!functional)
+        walker->walkMemRefs.sample(memRefs);
+}
+
+void
+Walker::WalkerState::fillWalkCache(unsigned level, Addr table,
+                                   bool uncacheable)
+{
+    if (functional)
+        return;
+
+    WalkCache::Entry cached;
+    cached.tag = entry.vaddr >> walkCacheShift[level];
+    cached.table = table;
+    cached.uncacheable = uncacheable;
+    cached.writable = entry.writable;
+    cached.user = entry.user;
+    cached.noExec = entry.noExec;
+    cached.nx = walkNX;
+    walker->walkCaches[level].insert(cached);
+}
+
+bool
+Walker::WalkerState::skipCachedLevels(Addr vaddr, Addr &topAddr,
+                                      bool &uncacheable)
+{
+    VAddr addr = vaddr;
+    // Start from the deepest level that caches the address
+    for (int level = PDECache; level >= PML4Cache; level--) {
+        const WalkCache::Entry *cached =
+            walker->walkCaches[level].lookup(vaddr >> walkCacheShift[level]);
+        // An execute access would fault on a skipped level with NX set
+        if (!cached || (cached->nx && mode == BaseTLB::Execute && enableNX))
+            continue;
+
+        walker->walkCacheHits[level]++;
+        entry.writable = cached->writable;
+        entry.user = cached->user;
+        entry.noExec = cached->noExec;
+        walkNX = cached->nx;
+        uncacheable = cached->uncacheable;
+        switch (level) {
+          case PML4Cache:
+            state = LongPDP;
+            topAddr = cached->table + addr.longl3 * dataSize;
+            break;
+          case PDPCache:
+            state = LongPD;
+            topAddr = cached->table + addr.longl2 * dataSize;
+            break;
+          case PDECache:
+            state = LongPTE;
+            entry.logBytes = 12;
+            topAddr = cached->table + addr.longl1 * dataSize;
+            break;
+        }
+        return true;
+    }
+    walker->walkCacheMisses++;
+    return false;
 }
 
 void
@@ -553,11 +781,15 @@ Walker::WalkerState::setupWalk(Addr vaddr)
     Efer efer = tc->readMiscRegNoEffect(MISCREG_EFER);
     dataSize = 8;
     Addr topAddr;
+    bool uncacheable = cr3.pcd;
+    walkNX = false;
     if (efer.lma) {
         // Do long mode.
         state = LongPML4;
         topAddr = (cr3.longPdtb << 12) + addr.longl4 * dataSize;
         enableNX = efer.nxe;
+        if (!functional)
+            skipCachedLevels(vaddr, topAddr, uncacheable);
     } else {
         // We're in some flavor of legacy mode.
         CR4 cr4 = tc->readMiscRegNoEffect(MISCREG_CR4);
@@ -584,7 +816,7 @@ Walker::WalkerState::setupWalk(Addr vaddr)
     entry.vaddr = vaddr;
 
     Request::Flags flags = Request::PHYSICAL;
-    if (cr3.pcd)
+    if (uncacheable)
         flags.set(Request::UNCACHEABLE);
 
     RequestPtr request = std::make_shared<Request>(
@@ -592,6 +824,7 @@ Walker::WalkerState::setupWalk(Addr vaddr)
 
     read = new Packet(request, MemCmd::ReadReq);
     read->allocate();
+    memRefs++;
 }
 
 bool
@@ -630,6 +863,7 @@ Walker::WalkerState::recvPacket(PacketPtr pkt)
     if (inflight == 0 && read == NULL && writes.size() == 0) {
         state = Ready;
         nextState = Waiting;
+        walker->walkLatency.sample(curTick() - startTick);
         if (timingFault == NoFault) {
             /*
              * Finish the translation. Now that we know the right entry is
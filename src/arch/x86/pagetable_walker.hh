@@ -40,8 +40,10 @@
 
 #include <vector>
 
+#include "arch/generic/shared_tlb.hh"
 #include "arch/x86/pagetable.hh"
 #include "arch/x86/tlb.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/packet.hh"
 #include "params/X86PagetableWalker.hh"
@@ -110,6 +112,12 @@ namespace X86ISA
             bool retrying;
             bool started;
             bool squashed;
+            // Tick the walk started at, to sample its latency
+            Tick startTick;
+            // Number of reads and writes issued by the walk
+            unsigned memRefs;
+            // Whether any of the entries walked so far has the NX bit set
+            bool walkNX;
           public:
             WalkerState(Walker * _walker, BaseTLB::Translation *_translation,
                         const RequestPtr &_req, bool _isFunctional = false) :
@@ -117,7 +125,8 @@ namespace X86ISA
                 nextState(Ready), inflight(0),
                 translation(_translation),
                 functional(_isFunctional), timing(false),
-                retrying(false), started(false), squashed(false)
+                retrying(false), started(false), squashed(false),
+                startTick(0), memRefs(0), walkNX(false)
             {
             }
             void initState(ThreadContext * _tc, BaseTLB::Mode _mode,
@@ -131,9 +140,14 @@ namespace X86ISA
             bool isTiming();
             void retry();
             void squash();
+            void sharedTLBHitDone();
             std::string name() const {return walker->name();}
 
           private:
+            bool lookupSharedTLB();
+            bool skipCachedLevels(Addr vaddr, Addr &topAddr,
+                                  bool &uncacheable);
+            void fillWalkCache(unsigned level, Addr table, bool uncacheable);
             void setupWalk(Addr vaddr);
             Fault stepWalk(PacketPtr &write);
             void sendPackets();
@@ -148,6 +162,59 @@ namespace X86ISA
         // State for functional accesses (only need one of these per walker)
         WalkerState funcState;
 
+        /**
+         * A fully associative, LRU replaced paging-structure cache. Each
+         * entry maps the upper bits of a virtual address to the physical
+         * address of the next level table, along with the permissions
+         * accumulated by the walk up to that level, so that long mode
+         * walks can skip the upper levels of the page table.
+         */
+        class WalkCache
+        {
+          public:
+            struct Entry
+            {
+                bool valid;
+                Addr tag;
+                Addr table;
+                bool uncacheable;
+                bool writable;
+                bool user;
+                bool noExec;
+                bool nx;
+                uint64_t lastUse;
+
+                Entry() : valid(false), tag(0), table(0), uncacheable(false),
+                          writable(false), user(false), noExec(false),
+                          nx(false), lastUse(0)
+                {}
+            };
+
+            WalkCache(unsigned size) : entries(size), useSeq(0) {}
+
+            const Entry *lookup(Addr tag);
+            void insert(const Entry &entry);
+            void flush();
+
+          private:
+            std::vector<Entry> entries;
+            uint64_t useSeq;
+        };
+
+        // Levels of the paging-structure caches, named after the table
+        // whose entries they hold.
+        enum WalkCacheLevel {
+            PML4Cache,
+            PDPCache,
+            PDECache,
+            NumWalkCaches
+        };
+
+        std::vector<WalkCache> walkCaches;
+
+        // Optional second level TLB, possibly shared with other walkers.
+        SharedTLB *sharedTLB;
+
         struct WalkerSenderState : public Packet::SenderState
         {
             WalkerState * senderWalk;
@@ -176,6 +243,16 @@ namespace X86ISA
         // Wrapper for checking for squashes before starting a translation.
         void startWalkWrapper();
 
+        // Remove a finished walk and start the next one, if any.
+        void retireWalk(WalkerState *walk);
+
+        Stats::Scalar walks;
+        Stats::Histogram walkLatency;
+        Stats::Histogram walkMemRefs;
+        Stats::Vector walkCacheHits;
+        Stats::Scalar walkCacheMisses;
+        Stats::Scalar sharedTLBHits;
+
         /**
          * Event used to call startWalkWrapper.
          **/
@@ -193,6 +270,13 @@ namespace X86ISA
             tlb = _tlb;
         }
 
+        SharedTLB *getSharedTLB() const { return sharedTLB; }
+
+        // Invalidate the paging-structure caches.
+        void flushWalkCaches();
+
+        void regStats() override;
+
         typedef X86PagetableWalkerParams Params;
 
         const Params *
@@ -203,7 +287,11 @@ namespace X86ISA
 
         Walker(const Params *params) :
             ClockedObject(params), port(name() + ".port", this),
-            funcState(this, NULL, NULL, true), tlb(NULL), sys(params->system),
+            funcState(this, NULL, NULL, true),
+            walkCaches{WalkCache(params->pml4_cache_entries),
+                       WalkCache(params->pdp_cache_entries),
+                       WalkCache(params->pde_cache_entries)},
+            sharedTLB(params->shared_tlb), tlb(NULL), sys(params->system),
             masterId(sys->getMasterId(this)),
             numSquashable(params->num_squash_per_cycle),
             startWalkWrapperEvent([this]{ startWalkWrapper(); }, name())
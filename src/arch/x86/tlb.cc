@@ -37,6 +37,7 @@
 
 #include "arch/x86/tlb.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -47,6 +48,7 @@
 #include "arch/x86/regs/misc.hh"
 #include "arch/x86/regs/msr.hh"
 #include "arch/x86/x86_traits.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
 #include "debug/TLB.hh"
@@ -61,14 +63,35 @@ namespace X86ISA {
 
 TLB::TLB(const Params *p)
     : BaseTLB(p), configAddress(0), size(p->size),
-      tlb(size), lruSeq(0), m5opRange(p->system->m5opRange())
+      tlb(size), lruSeq(0), assoc(p->assoc),
+      numSets(assoc ? size / assoc : 0),
+      replacementPolicy(p->replacement_policy),
+      m5opRange(p->system->m5opRange())
 {
     if (!size)
         fatal("TLBs must have a non-zero size.\n");
 
     for (int x = 0; x < size; x++) {
         tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
+    }
+
+    if (assoc) {
+        fatal_if(size % assoc || !isPowerOf2(numSets),
+                 "The number of TLB sets must be a power of 2.\n");
+        fatal_if(!replacementPolicy,
+                 "A set associative TLB needs a replacement policy.\n");
+
+        replEntries.resize(size);
+        validEntries.resize(size, false);
+        for (unsigned x = 0; x < size; x++) {
+            replEntries[x].setPosition(x / assoc, x % assoc);
+            replEntries[x].replacementData =
+                replacementPolicy->instantiateEntry();
+        }
+    } else {
+        for (int x = 0; x < size; x++) {
+            freeList.push_back(&tlb[x]);
+        }
     }
 
     walker = p->walker;
@@ -97,12 +120,20 @@ TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
     // If somebody beat us to it, just use that existing entry.
-    TlbEntry *newEntry = trie.lookup(vpn);
+    TlbEntry *newEntry = assoc ? lookupSetAssoc(vpn, false) :
+                                 trie.lookup(vpn);
     if (newEntry) {
-        assert(newEntry->vaddr == vpn);
+        assert(assoc || newEntry->vaddr == vpn);
         return newEntry;
     }
 
+    // Insertions are the result of misses, only the walk (or page table
+    // lookup) knows the page size though
+    missesByPageSize[entry.logBytes < 21 ? 0 : entry.logBytes < 30 ? 1 : 2]++;
+
+    if (assoc)
+        return insertSetAssoc(vpn, entry);
+
     if (freeList.empty())
         evictLRU();
 
@@ -120,16 +151,121 @@ TLB::insert(Addr vpn, const TlbEntry &entry)
 TlbEntry *
 TLB::lookup(Addr va, bool update_lru)
 {
+    if (assoc)
+        return lookupSetAssoc(va, update_lru);
+
     TlbEntry *entry = trie.lookup(va);
     if (entry && update_lru)
         entry->lruSeq = nextSeq();
     return entry;
 }
 
+unsigned
+TLB::setIndex(Addr va, unsigned log_bytes) const
+{
+    const unsigned set_bits = floorLog2(numSets);
+    const Addr vpn = va >> log_bytes;
+    return (vpn ^ (vpn >> set_bits) ^ (vpn >> (2 * set_bits)) ^ log_bytes) &
+           (numSets - 1);
+}
+
+bool
+TLB::entryValid(unsigned idx) const
+{
+    return assoc ? validEntries[idx] : tlb[idx].trieHandle != NULL;
+}
+
+TlbEntry *
+TLB::lookupSetAssoc(Addr va, bool update_lru)
+{
+    // Probe the set of the address for every page size in use
+    for (const auto log_bytes : pageSizes) {
+        const unsigned first = setIndex(va, log_bytes) * assoc;
+        for (unsigned idx = first; idx < first + assoc; idx++) {
+            TlbEntry &entry = tlb[idx];
+            if (validEntries[idx] && entry.logBytes == log_bytes &&
+                !((entry.vaddr ^ va) >> log_bytes)) {
+                if (update_lru) {
+                    entry.lruSeq = nextSeq();
+                    replacementPolicy->touch(replEntries[idx].replacementData);
+                }
+                return &entry;
+            }
+        }
+    }
+    return NULL;
+}
+
+TlbEntry *
+TLB::insertSetAssoc(Addr vpn, const TlbEntry &entry)
+{
+    // If somebody beat us to it, just use that existing entry.
+    TlbEntry *newEntry = lookupSetAssoc(vpn, false);
+    if (newEntry)
+        return newEntry;
+
+    // Use a free way if there is one, otherwise let the replacement policy
+    // choose the victim
+    const unsigned set = setIndex(vpn, entry.logBytes);
+    const unsigned first = set * assoc;
+    unsigned victim = first;
+    while (victim < first + assoc && validEntries[victim])
+        victim++;
+    if (victim == first + assoc) {
+        ReplacementCandidates candidates;
+        for (unsigned idx = first; idx < first + assoc; idx++)
+            candidates.push_back(&replEntries[idx]);
+        victim = replacementPolicy->getVictim(candidates) - &replEntries[0];
+        DPRINTF(TLB, "Evicting the translation of %#x.\n",
+                tlb[victim].vaddr);
+    }
+
+    newEntry = &tlb[victim];
+    *newEntry = entry;
+    newEntry->lruSeq = nextSeq();
+    newEntry->vaddr = vpn;
+    validEntries[victim] = true;
+
+    // Signatures used by the set dueling and SHiP policies; there is no
+    // PC associated to the translations
+    const std::shared_ptr<ReplacementData> &data =
+        replEntries[victim].replacementData;
+    data->setindex = set;
+    data->tag = vpn >> entry.logBytes;
+    data->pc = 0;
+    replacementPolicy->reset(data);
+
+    if (std::find(pageSizes.begin(), pageSizes.end(), entry.logBytes) ==
+        pageSizes.end()) {
+        pageSizes.push_back(entry.logBytes);
+    }
+
+    return newEntry;
+}
+
+void
+TLB::invalidateSetAssoc(unsigned idx)
+{
+    validEntries[idx] = false;
+    replacementPolicy->invalidate(replEntries[idx].replacementData);
+}
+
 void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
+    walker->flushWalkCaches();
+    if (walker->getSharedTLB())
+        walker->getSharedTLB()->flushAll();
+
+    if (assoc) {
+        for (unsigned i = 0; i < size; i++) {
+            if (validEntries[i])
+                invalidateSetAssoc(i);
+        }
+        return;
+    }
+
     for (unsigned i = 0; i < size; i++) {
         if (tlb[i].trieHandle) {
             trie.remove(tlb[i].trieHandle);
@@ -149,6 +285,18 @@ void
 TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
+    walker->flushWalkCaches();
+    if (walker->getSharedTLB())
+        walker->getSharedTLB()->flushNonGlobal();
+
+    if (assoc) {
+        for (unsigned i = 0; i < size; i++) {
+            if (validEntries[i] && !tlb[i].global)
+                invalidateSetAssoc(i);
+        }
+        return;
+    }
+
     for (unsigned i = 0; i < size; i++) {
         if (tlb[i].trieHandle && !tlb[i].global) {
             trie.remove(tlb[i].trieHandle);
@@ -161,6 +309,18 @@ TLB::flushNonGlobal()
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
+    // Like INVLPG, drop all the paging-structure cache entries
+    walker->flushWalkCaches();
+    if (walker->getSharedTLB())
+        walker->getSharedTLB()->demapPage(va);
+
+    if (assoc) {
+        TlbEntry *entry = lookupSetAssoc(va, false);
+        if (entry)
+            invalidateSetAssoc(entry - &tlb[0]);
+        return;
+    }
+
     TlbEntry *entry = trie.lookup(va);
     if (entry) {
         trie.remove(entry->trieHandle);
@@ -539,19 +699,31 @@ TLB::regStats()
         .name(name() + ".wrMisses")
         .desc("TLB misses on write requests");
 
+    missesByPageSize
+        .init(3)
+        .name(name() + ".missesByPageSize")
+        .desc("TLB misses by size of the page they were filled with")
+        .subname(0, "4KiB")
+        .subname(1, "2MiB")
+        .subname(2, "1GiB");
+
 }
 
 void
 TLB::serialize(CheckpointOut &cp) const
 {
     // Only store the entries in use.
-    uint32_t _size = size - freeList.size();
+    uint32_t _size = 0;
+    for (uint32_t x = 0; x < size; x++) {
+        if (entryValid(x))
+            _size++;
+    }
     SERIALIZE_SCALAR(_size);
     SERIALIZE_SCALAR(lruSeq);
 
     uint32_t _count = 0;
     for (uint32_t x = 0; x < size; x++) {
-        if (tlb[x].trieHandle != NULL)
+        if (entryValid(x))
             tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
     }
 }
@@ -568,6 +740,15 @@ TLB::unserialize(CheckpointIn &cp)
 
     UNSERIALIZE_SCALAR(lruSeq);
 
+    if (assoc) {
+        for (uint32_t x = 0; x < _size; x++) {
+            TlbEntry entry;
+            entry.unserializeSection(cp, csprintf("Entry%d", x));
+            insertSetAssoc(entry.vaddr, entry);
+        }
+        return;
+    }
+
     for (uint32_t x = 0; x < _size; x++) {
         TlbEntry *newEntry = freeList.front();
         freeList.pop_front();
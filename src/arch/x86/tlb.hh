@@ -44,6 +44,7 @@
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
 #include "base/trie.hh"
+#include "mem/cache/replacement_policies/base.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
 #include "sim/stats.hh"
@@ -76,8 +77,6 @@ namespace X86ISA
 
       protected:
 
-        EntryList::iterator lookupIt(Addr va, bool update_lru = true);
-
         Walker * walker;
 
       public:
@@ -99,6 +98,50 @@ namespace X86ISA
         TlbEntryTrie trie;
         uint64_t lruSeq;
 
+        /**
+         * Associativity of the set associative organization, or 0 if the
+         * TLB is fully associative (trie lookup and LRU replacement).
+         */
+        const unsigned assoc;
+
+        /** Number of sets of the set associative organization. */
+        const unsigned numSets;
+
+        /** Replacement policy of the set associative organization. */
+        BaseReplacementPolicy *replacementPolicy;
+
+        /** Position and replacement data of each entry. */
+        std::vector<ReplaceableEntry> replEntries;
+
+        /** Whether each entry holds a valid translation. */
+        std::vector<bool> validEntries;
+
+        /**
+         * Page sizes (log2 of bytes) inserted so far, in insertion
+         * order. A set associative lookup probes one set per page size.
+         */
+        std::vector<unsigned> pageSizes;
+
+        /**
+         * Get the set of a page in the set associative organization. The
+         * page number is folded so that strided pages spread over the sets,
+         * and the page size is mixed in so that pages of different sizes
+         * don't always collide.
+         *
+         * @param va An address in the page.
+         * @param log_bytes The page size (log2 of bytes).
+         * @return The set index.
+         */
+        unsigned setIndex(Addr va, unsigned log_bytes) const;
+
+        /** Whether an entry holds a valid translation. */
+        bool entryValid(unsigned idx) const;
+
+        /** Set associative versions of lookup, insert and invalidation. */
+        TlbEntry *lookupSetAssoc(Addr va, bool update_lru);
+        TlbEntry *insertSetAssoc(Addr vpn, const TlbEntry &entry);
+        void invalidateSetAssoc(unsigned idx);
+
         AddrRange m5opRange;
 
         // Statistics
@@ -106,6 +149,7 @@ namespace X86ISA
         Stats::Scalar wrAccesses;
         Stats::Scalar rdMisses;
         Stats::Scalar wrMisses;
+        Stats::Vector missesByPageSize;
 
         Fault translateInt(bool read, RequestPtr req, ThreadContext *tc);
 
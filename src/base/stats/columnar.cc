@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/columnar.hh"
+
+#include <cassert>
+#include <cstring>
+#include <ostream>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "sim/byteswap.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+namespace Stats {
+
+Columnar::Columnar(const string &filename, bool desc, bool formulas)
+    : enableDescriptions(desc), enableFormula(formulas),
+      file(simout.create(filename, true, true)), schemaWritten(false)
+{
+    fatal_if(!file, "Unable to open columnar stat file '%s'.\n",
+             filename);
+}
+
+Columnar::~Columnar()
+{
+    simout.close(file);
+}
+
+void
+Columnar::begin()
+{
+    assert(path.empty());
+    row.clear();
+}
+
+void
+Columnar::end()
+{
+    assert(path.empty());
+
+    if (!schemaWritten) {
+        assert(names.size() == row.size());
+        writeSchema();
+        schemaWritten = true;
+        // The names are only needed until the schema is on disk.
+        names.clear();
+        names.shrink_to_fit();
+        descs.clear();
+        descs.shrink_to_fit();
+    } else {
+        fatal_if(row.size() != lastRow.size(),
+                 "The number of columnar stats changed between dumps "
+                 "(%i != %i).\n", row.size(), lastRow.size());
+    }
+
+    writeRow();
+    row.swap(lastRow);
+    file->stream()->flush();
+}
+
+bool
+Columnar::valid() const
+{
+    return file && file->stream()->good();
+}
+
+void
+Columnar::beginGroup(const char *name)
+{
+    if (path.empty()) {
+        path.push(name);
+    } else {
+        path.push(csprintf("%s.%s", path.top(), name));
+    }
+}
+
+void
+Columnar::endGroup()
+{
+    assert(!path.empty());
+    path.pop();
+}
+
+string
+Columnar::statName(const string &name) const
+{
+    if (path.empty())
+        return name;
+    else
+        return csprintf("%s.%s", path.top(), name);
+}
+
+string
+Columnar::subName(const vector<string> &subnames, size_type index)
+{
+    if (index < subnames.size() && !subnames[index].empty())
+        return subnames[index];
+    else
+        return csprintf("%i", index);
+}
+
+void
+Columnar::addColumn(const string &name, const string &desc, double value)
+{
+    if (!schemaWritten) {
+        names.push_back(name);
+        if (enableDescriptions)
+            descs.push_back(desc);
+    }
+    row.push_back(value);
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addColumn(schemaWritten ? "" : statName(info.name), info.desc,
+              info.result());
+}
+
+void
+Columnar::appendVector(const VectorInfo &info)
+{
+    const VResult &result = info.result();
+    const string base = schemaWritten ? "" : statName(info.name);
+
+    for (size_type i = 0; i < result.size(); ++i) {
+        addColumn(schemaWritten ? "" :
+                  csprintf("%s::%s", base, subName(info.subnames, i)),
+                  info.desc, result[i]);
+    }
+
+    if (info.flags.isSet(total)) {
+        addColumn(schemaWritten ? "" : base + "::total", info.desc,
+                  info.total());
+    }
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    appendVector(info);
+}
+
+void
+Columnar::appendDist(const string &name, const string &desc,
+                     const DistData &data)
+{
+    const bool schema = !schemaWritten;
+
+    addColumn(schema ? name + "::samples" : "", desc, data.samples);
+    addColumn(schema ? name + "::sum" : "", desc, data.sum);
+    addColumn(schema ? name + "::squares" : "", desc, data.squares);
+
+    if (data.type == Deviation)
+        return;
+
+    addColumn(schema ? name + "::min_value" : "", desc, data.min_val);
+    addColumn(schema ? name + "::max_value" : "", desc, data.max_val);
+    addColumn(schema ? name + "::underflows" : "", desc, data.underflow);
+    addColumn(schema ? name + "::overflows" : "", desc, data.overflow);
+
+    // Histograms rescale their buckets at run time, so the bucket
+    // bounds are stored as columns rather than encoded in the names.
+    addColumn(schema ? name + "::bucket_min" : "", desc, data.min);
+    addColumn(schema ? name + "::bucket_size" : "", desc, data.bucket_size);
+    for (size_type i = 0; i < data.cvec.size(); ++i) {
+        addColumn(schema ? csprintf("%s::bucket%i", name, i) : "",
+                  desc, data.cvec[i]);
+    }
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    appendDist(schemaWritten ? "" : statName(info.name), info.desc,
+               info.data);
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const string base = schemaWritten ? "" : statName(info.name);
+    for (size_type i = 0; i < info.size(); ++i) {
+        appendDist(schemaWritten ? "" :
+                   csprintf("%s::%s", base, subName(info.subnames, i)),
+                   info.desc, info.data[i]);
+    }
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const string base = schemaWritten ? "" : statName(info.name);
+    for (size_type x = 0; x < info.x; ++x) {
+        for (size_type y = 0; y < info.y; ++y) {
+            addColumn(schemaWritten ? "" :
+                      csprintf("%s::%s::%s", base,
+                               subName(info.subnames, x),
+                               subName(info.y_subnames, y)),
+                      info.desc, info.cvec[x * info.y + y]);
+        }
+    }
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    if (!enableFormula || !info.flags.isSet(display))
+        return;
+
+    appendVector(info);
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    warn_once("Columnar stat files don't support sparse histograms.\n");
+}
+
+void
+Columnar::writeU32(uint32_t value)
+{
+    value = htole(value);
+    file->stream()->write((const char *)&value, sizeof(value));
+}
+
+void
+Columnar::writeU64(uint64_t value)
+{
+    value = htole(value);
+    file->stream()->write((const char *)&value, sizeof(value));
+}
+
+void
+Columnar::writeString(const string &str)
+{
+    writeU32(str.size());
+    file->stream()->write(str.data(), str.size());
+}
+
+void
+Columnar::writeSchema()
+{
+    ostream &os = *file->stream();
+
+    os.write("gem5scol", 8);
+    writeU32(version);
+    writeU32(enableDescriptions ? flagDescriptions : 0);
+    writeU64(names.size());
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        writeString(names[i]);
+        if (enableDescriptions)
+            writeString(descs[i]);
+    }
+}
+
+void
+Columnar::writeRow()
+{
+    const size_t columns = row.size();
+    const bool first = lastRow.empty();
+
+    changed.assign((columns + 7) / 8, 0);
+    changedValues.clear();
+
+    for (size_t i = 0; i < columns; ++i) {
+        // Compare the bit patterns so that NaN results (e.g., formulas
+        // dividing by zero) don't count as a change on every dump.
+        uint64_t cur, last = 0;
+        memcpy(&cur, &row[i], sizeof(cur));
+        if (!first)
+            memcpy(&last, &lastRow[i], sizeof(last));
+
+        if (first || cur != last) {
+            changed[i / 8] |= 1 << (i % 8);
+            changedValues.push_back(row[i]);
+        }
+    }
+
+    ostream &os = *file->stream();
+    writeU64(curTick());
+    os.write((const char *)changed.data(), changed.size());
+    for (double value : changedValues) {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        writeU64(bits);
+    }
+}
+
+std::unique_ptr<Output>
+initColumnar(const std::string &filename, bool desc, bool formulas)
+{
+    return std::unique_ptr<Output>(
+        new Columnar(filename, desc, formulas));
+}
+
+}; // namespace Stats
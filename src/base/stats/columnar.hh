@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <cstdint>
+#include <memory>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/stats/info.hh"
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+/**
+ * Columnar binary stat output.
+ *
+ * Every displayed stat is flattened into one or more double-precision
+ * columns (one per scalar, vector element, 2d cell, distribution field
+ * or bucket). The column schema is written once, on the first dump;
+ * every dump after that appends a row holding the current tick, a
+ * bitmap of the columns that changed since the previous dump and the
+ * values of those columns only. Since the schema is fixed after the
+ * first dump, later dumps never format stat names, which makes frequent
+ * periodic dumps considerably cheaper than with the text format.
+ *
+ * File layout (all integers and doubles little endian):
+ *   header: "gem5scol", uint32 version, uint32 flags, uint64 columns
+ *   schema: per column, uint32 length + name (+ uint32 length + desc
+ *           when descriptions are enabled)
+ *   rows:   uint64 tick, ceil(columns / 8) bytes of changed-bitmap
+ *           (LSB first), one double per changed column
+ *
+ * util/columnar_stats.py reads the format back into arrays.
+ */
+class Columnar : public Output
+{
+  public:
+    /** File format version written to the header. */
+    static const uint32_t version = 1;
+
+    /** Header flag: the schema includes stat descriptions. */
+    static const uint32_t flagDescriptions = 0x1;
+
+    Columnar(const std::string &filename, bool desc, bool formulas);
+
+    ~Columnar();
+
+    Columnar() = delete;
+    Columnar(const Columnar &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** Prefix a stat name with the current group path. */
+    std::string statName(const std::string &name) const;
+
+    /** Name of the element of a vector stat in the schema. */
+    static std::string subName(const std::vector<std::string> &subnames,
+                               size_type index);
+
+    /**
+     * Append a column to the current row. The name and description
+     * are only recorded while the schema is still being built.
+     */
+    void addColumn(const std::string &name, const std::string &desc,
+                   double value);
+
+    /** Append the vector elements (and total) of a vector stat. */
+    void appendVector(const VectorInfo &info);
+
+    /** Append the fields and buckets of a distribution. */
+    void appendDist(const std::string &name, const std::string &desc,
+                    const DistData &data);
+
+    /** Write the file header and column schema. */
+    void writeSchema();
+
+    /** Write the difference between the current and previous row. */
+    void writeRow();
+
+    void writeU32(uint32_t value);
+    void writeU64(uint64_t value);
+    void writeString(const std::string &str);
+
+  protected:
+    const bool enableDescriptions;
+    const bool enableFormula;
+
+    OutputStream *file;
+
+    /** Object/group path. */
+    std::stack<std::string> path;
+
+    /** True once the schema has been written. */
+    bool schemaWritten;
+
+    /** Column names and descriptions collected during the first dump. */
+    std::vector<std::string> names;
+    std::vector<std::string> descs;
+
+    /** Values visited during the current and the previous dump. */
+    std::vector<double> row;
+    std::vector<double> lastRow;
+
+    /** Scratch buffers used to encode a row. */
+    std::vector<uint8_t> changed;
+    std::vector<double> changedValues;
+};
+
+std::unique_ptr<Output> initColumnar(
+    const std::string &filename, bool desc = true, bool formulas = true);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_COLUMNAR_HH__
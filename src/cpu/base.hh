@@ -42,6 +42,7 @@
 #ifndef __CPU_BASE_HH__
 #define __CPU_BASE_HH__
 
+#include <memory>
 #include <vector>
 
 // Before we do anything else, check if this build is the NULL ISA,
@@ -167,6 +168,17 @@ class BaseCPU : public ClockedObject
         return [port](PacketPtr pkt)->void { port->sendFunctional(pkt); };
     }
 
+    /**
+     * Returns a delegate port proxies can use to find a backdoor for a
+     * physical range. CPUs that don't hold on to backdoors return an
+     * empty function, so their proxies always send functional packets.
+     */
+    virtual PortProxy::BackdoorFunc
+    getBackdoorFunc()
+    {
+        return nullptr;
+    }
+
     /**
      * Purely virtual method that returns a reference to the instruction
      * port. All subclasses must implement this method.
@@ -466,8 +478,24 @@ class BaseCPU : public ClockedObject
      *
      * @param inst Instruction that just committed
      * @param pc PC of the instruction that just committed
+     * @param tid Thread the instruction belongs to
      */
-    virtual void probeInstCommit(const StaticInstPtr &inst, Addr pc);
+    virtual void probeInstCommit(const StaticInstPtr &inst, Addr pc,
+                                 ThreadID tid);
+
+    /**
+     * Information about a committed instruction or micro-op, for
+     * listeners that need to tell threads apart.
+     */
+    struct CommittedInst
+    {
+        /** The thread the instruction belongs to. */
+        ThreadID tid;
+        /** The PC of the instruction. */
+        Addr pc;
+        /** The instruction. */
+        const StaticInstPtr &inst;
+    };
 
    protected:
     /**
@@ -498,6 +526,9 @@ class BaseCPU : public ClockedObject
     /** Retired branches (any type) */
     ProbePoints::PMUUPtr ppRetiredBranches;
 
+    /** Every committed instruction and micro-op, with its thread */
+    std::unique_ptr<ProbePointArg<CommittedInst>> ppCommittedInsts;
+
     /** CPU cycle counter even if any thread Context is suspended*/
     ProbePoints::PMUUPtr ppAllCycles;
 
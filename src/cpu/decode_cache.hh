@@ -30,6 +30,8 @@
 #define __CPU_DECODE_CACHE_HH__
 
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "arch/isa_traits.hh"
 #include "arch/types.hh"
@@ -44,9 +46,69 @@ namespace TheISA
 namespace DecodeCache
 {
 
-/// Hash for decoded instructions.
+/**
+ * Hash for decoded instructions. Lookups first go through a small
+ * direct-mapped cache indexed by the hash of the machine instruction,
+ * which holds the most recently used decodings and avoids walking the
+ * buckets of the hash map for the common case of a hot loop.
+ */
 template <typename EMI>
-using InstMap = std::unordered_map<EMI, StaticInstPtr>;
+class InstMap
+{
+  protected:
+    /// Number of entries in the direct-mapped front cache.
+    static const size_t FrontEntries = 4096;
+
+    struct FrontEntry
+    {
+        EMI emi;
+        StaticInstPtr si;
+    };
+
+    std::vector<FrontEntry> front;
+    std::unordered_map<EMI, StaticInstPtr> map;
+
+    FrontEntry &
+    frontEntry(const EMI &emi)
+    {
+        return front[std::hash<EMI>()(emi) & (FrontEntries - 1)];
+    }
+
+  public:
+    InstMap() : front(FrontEntries) {}
+
+    /// Look up a machine instruction.
+    /// @param emi The machine instruction to look up.
+    /// @retval The decoded instruction, or nullptr if it is not cached.
+    StaticInstPtr
+    lookup(const EMI &emi)
+    {
+        FrontEntry &entry = frontEntry(emi);
+        if (entry.si && entry.emi == emi)
+            return entry.si;
+
+        auto it = map.find(emi);
+        if (it == map.end())
+            return nullptr;
+
+        entry.emi = emi;
+        entry.si = it->second;
+        return it->second;
+    }
+
+    /// Add a decoded machine instruction to the cache.
+    /// @param emi The machine instruction.
+    /// @param si The corresponding decoded instruction.
+    void
+    insert(const EMI &emi, const StaticInstPtr &si)
+    {
+        map[emi] = si;
+
+        FrontEntry &entry = frontEntry(emi);
+        entry.emi = emi;
+        entry.si = si;
+    }
+};
 
 /// A sparse map from an Addr to a Value, stored in page chunks.
 template<class Value>
@@ -60,17 +122,26 @@ class AddrMap
     // A map of cache pages which allows a sparse mapping.
     typedef typename std::unordered_map<Addr, CachePage *> PageMap;
     typedef typename PageMap::iterator PageIt;
-    // Mini cache of recent lookups.
-    PageIt recent[2];
+
+    // Mini cache of recent lookups. The page pointers are cached rather
+    // than map iterators, as the latter are invalidated when the map
+    // is rehashed.
+    struct RecentPage {
+        Addr addr;
+        CachePage *page;
+    };
+    RecentPage recent[2];
     PageMap pageMap;
 
     /// Update the mini cache of recent lookups.
-    /// @param recentest The most recent result;
+    /// @param page_addr The address of the most recent page.
+    /// @param page The most recent page.
     void
-    update(PageIt recentest)
+    update(Addr page_addr, CachePage *page)
     {
         recent[1] = recent[0];
-        recent[0] = recentest;
+        recent[0].addr = page_addr;
+        recent[0].page = page;
     }
 
     /// Attempt to find the CacheePage which goes with a particular
@@ -83,29 +154,24 @@ class AddrMap
         Addr page_addr = addr & ~(TheISA::PageBytes - 1);
 
         // Check against recent lookups.
-        if (recent[0] != pageMap.end()) {
-            if (recent[0]->first == page_addr)
-                return recent[0]->second;
-            if (recent[1] != pageMap.end() &&
-                    recent[1]->first == page_addr) {
-                update(recent[1]);
-                // recent[1] has just become recent[0].
-                return recent[0]->second;
-            }
+        if (recent[0].addr == page_addr)
+            return recent[0].page;
+        if (recent[1].addr == page_addr) {
+            std::swap(recent[0], recent[1]);
+            return recent[0].page;
         }
 
         // Actually look in the has_map.
         PageIt it = pageMap.find(page_addr);
         if (it != pageMap.end()) {
-            update(it);
+            update(page_addr, it->second);
             return it->second;
         }
 
         // Didn't find an existing page, so add a new one.
         CachePage *newPage = new CachePage;
-        page_addr = page_addr & ~(TheISA::PageBytes - 1);
-        typename PageMap::value_type to_insert(page_addr, newPage);
-        update(pageMap.insert(to_insert).first);
+        pageMap[page_addr] = newPage;
+        update(page_addr, newPage);
         return newPage;
     }
 
@@ -113,7 +179,8 @@ class AddrMap
     /// Constructor
     AddrMap()
     {
-        recent[0] = recent[1] = pageMap.end();
+        // Page addresses are aligned, so MaxAddr never matches one.
+        recent[0] = recent[1] = { MaxAddr, nullptr };
     }
 
     Value &
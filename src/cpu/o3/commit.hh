@@ -196,6 +196,9 @@ class DefaultCommit
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop the instructions commit holds on to. */
+    void clearInsts();
+
     /** Has the stage drained? */
     bool isDrained() const;
 
@@ -407,6 +407,16 @@ DefaultCommit<Impl>::drainSanityCheck() const
     rob->drainSanityCheck();
 }
 
+template <class Impl>
+void
+DefaultCommit<Impl>::clearInsts()
+{
+    for (ThreadID tid = 0; tid < numThreads; tid++)
+        squashAfterInst[tid] = nullptr;
+
+    rob->clearInsts();
+}
+
 template <class Impl>
 bool
 DefaultCommit<Impl>::isDrained() const
@@ -92,6 +92,7 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 #ifndef NDEBUG
       instcount(0),
 #endif
+      dynInstPool(new DynInstPool),
       removeInstsThisCycle(false),
       fetch(this, params),
       decode(this, params),
@@ -364,6 +365,52 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 template <class Impl>
 FullO3CPU<Impl>::~FullO3CPU()
 {
+    releaseInsts();
+    for (void *block : dynInstPool->freeList)
+        ::operator delete(block);
+    dynInstPool->freeList.clear();
+
+    // Instructions still referenced from outside the pipeline, e.g., by
+    // the sender state of packets in flight, keep the pool alive and the
+    // last of them deletes it.
+    if (dynInstPool->live == 0) {
+        delete dynInstPool;
+    } else {
+        warn("%s: %d instructions still referenced on destruction\n",
+             name(), dynInstPool->live);
+        dynInstPool->orphaned = true;
+    }
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::releaseInsts()
+{
+    instList.clear();
+    removeList = std::queue<ListIt>();
+
+    // Advancing a time buffer through its whole length clears every
+    // entry of it.
+    for (unsigned i = 0; i < timeBuffer.getSize(); ++i)
+        timeBuffer.advance();
+    for (unsigned i = 0; i < fetchQueue.getSize(); ++i)
+        fetchQueue.advance();
+    for (unsigned i = 0; i < decodeQueue.getSize(); ++i)
+        decodeQueue.advance();
+    for (unsigned i = 0; i < renameQueue.getSize(); ++i)
+        renameQueue.advance();
+    for (unsigned i = 0; i < iewQueue.getSize(); ++i)
+        iewQueue.advance();
+
+    fetch.clearInsts();
+    decode.clearInsts();
+    rename.clearInsts();
+    iew.clearInsts();
+    commit.clearInsts();
+
+    // The checker holds on to instructions it has yet to verify.
+    if (checker)
+        checker->switchOut();
 }
 
 template <class Impl>
@@ -446,6 +493,28 @@ FullO3CPU<Impl>::regStats()
         .precision(6);
     totalIpc =  sum(committedInsts) / numCycles;
 
+    dynInstsCreated
+        .name(name() + ".dynInstsCreated")
+        .desc("Number of dynamic instructions created");
+
+    dynInstHeapAllocs
+        .name(name() + ".dynInstHeapAllocs")
+        .desc("Number of dynamic instructions not served from the "
+              "recycled instruction pool");
+
+    dynInstsPerInst
+        .name(name() + ".dynInstsPerInst")
+        .desc("Dynamic instructions created per committed instruction")
+        .precision(6);
+    dynInstsPerInst = dynInstsCreated / sum(committedInsts);
+
+    dynInstHeapAllocsPerInst
+        .name(name() + ".dynInstHeapAllocsPerInst")
+        .desc("Dynamic instruction heap allocations per committed "
+              "instruction")
+        .precision(6);
+    dynInstHeapAllocsPerInst = dynInstHeapAllocs / sum(committedInsts);
+
     this->fetch.regStats();
     this->decode.regStats();
     this->rename.regStats();
@@ -1531,7 +1600,7 @@ FullO3CPU<Impl>::instDone(ThreadID tid, const DynInstPtr &inst)
     thread[tid]->numOps++;
     committedOps[tid]++;
 
-    probeInstCommit(inst->staticInst, inst->instAddr());
+    probeInstCommit(inst->staticInst, inst->instAddr(), tid);
 }
 
 template <class Impl>
@@ -85,6 +85,42 @@ class BaseO3CPU : public BaseCPU
     void regStats();
 };
 
+/**
+ * Storage for the DynInsts of a CPU. Each instruction records the pool
+ * it came from, so the pool can outlive its CPU if some instructions
+ * are still referenced (e.g., by packets in flight) when the CPU is
+ * destroyed. The last of those instructions then deletes the pool.
+ */
+struct DynInstPool
+{
+    /** Storage of destroyed DynInsts, ready to be reused. */
+    std::vector<void *> freeList;
+
+    /** Size of the storage handed out for each DynInst. */
+    size_t blockSize = 0;
+
+    /** Number of DynInsts currently using storage from the pool. */
+    size_t live = 0;
+
+    /** Has the owning CPU been destroyed? */
+    bool orphaned = false;
+
+    /** Hand the storage of a destroyed DynInst back to the pool. */
+    void
+    release(void *block)
+    {
+        assert(live > 0);
+        --live;
+        if (!orphaned) {
+            freeList.push_back(block);
+            return;
+        }
+        ::operator delete(block);
+        if (live == 0)
+            delete this;
+    }
+};
+
 /**
  * FullO3CPU class, has each of the stages (fetch through commit)
  * within it, as well as all of the time buffers between stages.  The
@@ -531,12 +567,39 @@ class FullO3CPU : public BaseO3CPU
     /** Debug function to print all instructions on the list. */
     void dumpInsts();
 
+    /**
+     * Get storage for a new DynInst, reusing the storage of a destroyed
+     * one when possible.
+     */
+    void *
+    allocDynInst(size_t size)
+    {
+        ++dynInstsCreated;
+        ++dynInstPool->live;
+        assert(dynInstPool->blockSize == 0 ||
+               size == dynInstPool->blockSize);
+        if (!dynInstPool->freeList.empty()) {
+            void *block = dynInstPool->freeList.back();
+            dynInstPool->freeList.pop_back();
+            return block;
+        }
+        ++dynInstHeapAllocs;
+        dynInstPool->blockSize = size;
+        return ::operator new(size);
+    }
+
+    /** Drop every instruction held by the CPU and its stages. */
+    void releaseInsts();
+
   public:
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
 #endif
 
+    /** Storage for the DynInsts of this CPU. */
+    DynInstPool *dynInstPool;
+
     /** List of all the instructions in flight. */
     std::list<DynInstPtr> instList;
 
@@ -769,6 +832,14 @@ class FullO3CPU : public BaseO3CPU
     Stats::Formula ipc;
     /** Stat for the total IPC. */
     Stats::Formula totalIpc;
+    /** Stat for the number of DynInsts created. */
+    Stats::Scalar dynInstsCreated;
+    /** Stat for the number of DynInsts that needed fresh heap storage. */
+    Stats::Scalar dynInstHeapAllocs;
+    /** Stat for the DynInsts created per committed instruction. */
+    Stats::Formula dynInstsPerInst;
+    /** Stat for the DynInst heap allocations per committed instruction. */
+    Stats::Formula dynInstHeapAllocsPerInst;
 
     //number of integer register file accesses
     Stats::Scalar intRegfileReads;
@@ -127,6 +127,9 @@ class DefaultDecode
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop all instructions held by decode. */
+    void clearInsts();
+
     /** Has the stage drained? */
     bool isDrained() const;
 
@@ -217,6 +217,17 @@ DefaultDecode<Impl>::drainSanityCheck() const
     }
 }
 
+template <class Impl>
+void
+DefaultDecode<Impl>::clearInsts()
+{
+    for (ThreadID tid = 0; tid < numThreads; ++tid) {
+        insts[tid] = std::queue<DynInstPtr>();
+        skidBuffer[tid] = std::queue<DynInstPtr>();
+        squashInst[tid] = nullptr;
+    }
+}
+
 template <class Impl>
 bool
 DefaultDecode<Impl>::isDrained() const
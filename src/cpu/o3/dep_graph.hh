@@ -49,13 +49,14 @@ class DependencyEntry
 {
   public:
     DependencyEntry()
-        : inst(NULL), next(NULL)
+        : inst(NULL), next(-1)
     { }
 
     DynInstPtr inst;
     //Might want to include data about what arch. register the
     //dependence is waiting on.
-    DependencyEntry<DynInstPtr> *next;
+    /** Index of the next node in the table, -1 at the end of a list. */
+    int next;
 };
 
 /** Array of linked list that maintains the dependencies between
@@ -66,6 +67,12 @@ class DependencyEntry
  * the producing instruction of that register.  Instructions are put
  * on the list upon reaching the IQ, and are removed from the list
  * either when the producer completes, or the instruction is squashed.
+ *
+ * All nodes live in one flat table and are linked by index. The first
+ * numEntries nodes are the heads of the lists and the consumer nodes
+ * follow them. Removed consumer nodes go onto a free list, so once the
+ * table has grown to the largest number of waiting consumers, adding
+ * and removing dependents doesn't allocate any more.
 */
 template <class DynInstPtr>
 class DependencyGraph
@@ -75,7 +82,8 @@ class DependencyGraph
 
     /** Default construction.  Must call resize() prior to use. */
     DependencyGraph()
-        : numEntries(0), memAllocCounter(0), nodesTraversed(0), nodesRemoved(0)
+        : numEntries(0), freeEntries(-1), memAllocCounter(0),
+          nodesTraversed(0), nodesRemoved(0)
     { }
 
     ~DependencyGraph();
@@ -107,24 +115,35 @@ class DependencyGraph
     bool empty() const;
 
     /** Checks if there are any dependents on a specific register. */
-    bool empty(PhysRegIndex idx) const { return !dependGraph[idx].next; }
+    bool empty(PhysRegIndex idx) const { return dependGraph[idx].next < 0; }
 
     /** Debugging function to dump out the dependency graph.
      */
     void dump();
 
   private:
-    /** Array of linked lists.  Each linked list is a list of all the
+    /** Take a consumer node off the free list, growing the table if
+     *  there is none. This may move the nodes, so it returns an index.
+     */
+    int allocEntry();
+
+    /** Put a consumer node back onto the free list. */
+    void freeEntry(int entry);
+
+    /** Table of linked lists.  Each linked list is a list of all the
      *  instructions that depend upon a given register.  The actual
      *  register's index is used to index into the graph; ie all
      *  instructions in flight that are dependent upon r34 will be
-     *  in the linked list of dependGraph[34].
+     *  in the linked list starting at dependGraph[34].
      */
     std::vector<DepEntry> dependGraph;
 
     /** Number of linked lists; identical to the number of registers. */
     int numEntries;
 
+    /** First node of the free list, -1 if it is empty. */
+    int freeEntries;
+
     // Debug variable, remove when done testing.
     unsigned memAllocCounter;
 
@@ -145,35 +164,57 @@ void
 DependencyGraph<DynInstPtr>::resize(int num_entries)
 {
     numEntries = num_entries;
+    dependGraph.clear();
     dependGraph.resize(numEntries);
+    freeEntries = -1;
 }
 
 template <class DynInstPtr>
-void
-DependencyGraph<DynInstPtr>::reset()
+int
+DependencyGraph<DynInstPtr>::allocEntry()
 {
-    // Clear the dependency graph
-    DepEntry *curr;
-    DepEntry *prev;
+    int entry = freeEntries;
+    if (entry < 0) {
+        entry = dependGraph.size();
+        dependGraph.emplace_back();
+    } else {
+        freeEntries = dependGraph[entry].next;
+    }
 
-    for (int i = 0; i < numEntries; ++i) {
-        curr = dependGraph[i].next;
+    ++memAllocCounter;
 
-        while (curr) {
-            memAllocCounter--;
+    return entry;
+}
 
-            prev = curr;
-            curr = prev->next;
-            prev->inst = NULL;
+template <class DynInstPtr>
+void
+DependencyGraph<DynInstPtr>::freeEntry(int entry)
+{
+    assert(entry >= numEntries);
 
-            delete prev;
-        }
+    dependGraph[entry].inst = NULL;
+    dependGraph[entry].next = freeEntries;
+    freeEntries = entry;
 
-        if (dependGraph[i].inst) {
-            dependGraph[i].inst = NULL;
+    --memAllocCounter;
+}
+
+template <class DynInstPtr>
+void
+DependencyGraph<DynInstPtr>::reset()
+{
+    // Clear the dependency graph
+    for (int i = 0; i < numEntries; ++i) {
+        int curr = dependGraph[i].next;
+
+        while (curr >= 0) {
+            int next = dependGraph[curr].next;
+            freeEntry(curr);
+            curr = next;
         }
 
-        dependGraph[i].next = NULL;
+        dependGraph[i].inst = NULL;
+        dependGraph[i].next = -1;
     }
 }
 
@@ -187,14 +228,12 @@ DependencyGraph<DynInstPtr>::insert(PhysRegIndex idx,
 
     // First create the entry that will be added to the head of the
     // dependency chain.
-    DepEntry *new_entry = new DepEntry;
-    new_entry->next = dependGraph[idx].next;
-    new_entry->inst = new_inst;
+    int new_entry = allocEntry();
+    dependGraph[new_entry].next = dependGraph[idx].next;
+    dependGraph[new_entry].inst = new_inst;
 
     // Then actually add it to the chain.
     dependGraph[idx].next = new_entry;
-
-    ++memAllocCounter;
 }
 
 
@@ -203,52 +242,44 @@ void
 DependencyGraph<DynInstPtr>::remove(PhysRegIndex idx,
                                     const DynInstPtr &inst_to_remove)
 {
-    DepEntry *prev = &dependGraph[idx];
-    DepEntry *curr = dependGraph[idx].next;
+    int prev = idx;
+    int curr = dependGraph[idx].next;
 
-    // Make sure curr isn't NULL.  Because this instruction is being
+    // Make sure curr isn't empty.  Because this instruction is being
     // removed from a dependency list, it must have been placed there at
     // an earlier time.  The dependency chain should not be empty,
     // unless the instruction dependent upon it is already ready.
-    if (curr == NULL) {
+    if (curr < 0) {
         return;
     }
 
     nodesRemoved++;
 
     // Find the instruction to remove within the dependency linked list.
-    while (curr->inst != inst_to_remove) {
+    while (dependGraph[curr].inst != inst_to_remove) {
         prev = curr;
-        curr = curr->next;
+        curr = dependGraph[curr].next;
         nodesTraversed++;
 
-        assert(curr != NULL);
+        assert(curr >= 0);
     }
 
     // Now remove this instruction from the list.
-    prev->next = curr->next;
+    dependGraph[prev].next = dependGraph[curr].next;
 
-    --memAllocCounter;
-
-    // Could push this off to the destructor of DependencyEntry
-    curr->inst = NULL;
-
-    delete curr;
+    freeEntry(curr);
 }
 
 template <class DynInstPtr>
 DynInstPtr
 DependencyGraph<DynInstPtr>::pop(PhysRegIndex idx)
 {
-    DepEntry *node;
-    node = dependGraph[idx].next;
+    int node = dependGraph[idx].next;
     DynInstPtr inst = NULL;
-    if (node) {
-        inst = node->inst;
-        dependGraph[idx].next = node->next;
-        node->inst = NULL;
-        memAllocCounter--;
-        delete node;
+    if (node >= 0) {
+        inst = std::move(dependGraph[node].inst);
+        dependGraph[idx].next = dependGraph[node].next;
+        freeEntry(node);
     }
     return inst;
 }
@@ -268,11 +299,9 @@ template <class DynInstPtr>
 void
 DependencyGraph<DynInstPtr>::dump()
 {
-    DepEntry *curr;
-
     for (int i = 0; i < numEntries; ++i)
     {
-        curr = &dependGraph[i];
+        const DepEntry *curr = &dependGraph[i];
 
         if (curr->inst) {
             cprintf("dependGraph[%i]: producer: %s [sn:%lli] consumer: ",
@@ -281,8 +310,8 @@ DependencyGraph<DynInstPtr>::dump()
             cprintf("dependGraph[%i]: No producer. consumer: ", i);
         }
 
-        while (curr->next != NULL) {
-            curr = curr->next;
+        while (curr->next >= 0) {
+            curr = &dependGraph[curr->next];
 
             cprintf("%s [sn:%lli] ",
                     curr->inst->pcState(), curr->inst->seqNum);
@@ -43,6 +43,7 @@
 #define __CPU_O3_DYN_INST_HH__
 
 #include <array>
+#include <cstddef>
 
 #include "arch/isa_traits.hh"
 #include "config/the_isa.hh"
@@ -86,6 +87,17 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /**
+     * Dynamic instructions are created and destroyed at a high rate, so
+     * their storage is recycled through a pool owned by the CPU. Each
+     * allocation is prefixed with the owning CPU so that it can be
+     * returned to the right pool when the instruction goes away.
+     */
+    static void *operator new(size_t size, O3CPU *cpu);
+    static void *operator new(size_t size);
+    static void operator delete(void *p, O3CPU *cpu);
+    static void operator delete(void *p);
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -99,6 +111,11 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     /** Initializes variables. */
     void initVars();
 
+    /** Space in front of each instruction recording its owning pool. */
+    static constexpr size_t poolHeaderSize = alignof(std::max_align_t);
+    static_assert(poolHeaderSize >= sizeof(DynInstPool *),
+                  "The pool header must be able to hold a pool pointer.");
+
   protected:
     /** Explicitation of dependent names. */
     using BaseDynInst<Impl>::cpu;
@@ -99,6 +99,48 @@ template <class Impl>BaseO3DynInst<Impl>::~BaseO3DynInst()
 };
 
 
+template <class Impl>
+void *
+BaseO3DynInst<Impl>::operator new(size_t size, O3CPU *cpu)
+{
+    uint8_t *block =
+        static_cast<uint8_t *>(cpu->allocDynInst(size + poolHeaderSize));
+    *reinterpret_cast<DynInstPool **>(block) = cpu->dynInstPool;
+    return block + poolHeaderSize;
+}
+
+template <class Impl>
+void *
+BaseO3DynInst<Impl>::operator new(size_t size)
+{
+    uint8_t *block =
+        static_cast<uint8_t *>(::operator new(size + poolHeaderSize));
+    *reinterpret_cast<DynInstPool **>(block) = nullptr;
+    return block + poolHeaderSize;
+}
+
+template <class Impl>
+void
+BaseO3DynInst<Impl>::operator delete(void *p, O3CPU *cpu)
+{
+    operator delete(p);
+}
+
+template <class Impl>
+void
+BaseO3DynInst<Impl>::operator delete(void *p)
+{
+    if (!p)
+        return;
+
+    uint8_t *block = static_cast<uint8_t *>(p) - poolHeaderSize;
+    DynInstPool *pool = *reinterpret_cast<DynInstPool **>(block);
+    if (pool)
+        pool->release(block);
+    else
+        ::operator delete(block);
+}
+
 template <class Impl>
 void
 BaseO3DynInst<Impl>::initVars()
@@ -255,6 +255,9 @@ class DefaultFetch
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop the instructions waiting to go to decode. */
+    void clearInsts();
+
     /** Has the stage drained? */
     bool isDrained() const;
 
@@ -453,6 +453,14 @@ DefaultFetch<Impl>::drainSanityCheck() const
     branchPred->drainSanityCheck();
 }
 
+template <class Impl>
+void
+DefaultFetch<Impl>::clearInsts()
+{
+    for (ThreadID tid = 0; tid < numThreads; ++tid)
+        fetchQueue[tid].clear();
+}
+
 template <class Impl>
 bool
 DefaultFetch<Impl>::isDrained() const
@@ -1107,7 +1115,7 @@ DefaultFetch<Impl>::buildInst(ThreadID tid, StaticInstPtr staticInst,
 
     // Create a new DynInst from the instruction fetched.
     DynInstPtr instruction =
-        new DynInst(staticInst, curMacroop, thisPC, nextPC, seq, cpu);
+        new (cpu) DynInst(staticInst, curMacroop, thisPC, nextPC, seq, cpu);
     instruction->setTid(tid);
 
     instruction->setThreadState(cpu->thread[tid]);
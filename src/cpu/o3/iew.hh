@@ -166,6 +166,9 @@ class DefaultIEW
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop all instructions held by IEW, the IQ and the LSQ. */
+    void clearInsts();
+
     /** Has the stage drained? */
     bool isDrained() const;
 
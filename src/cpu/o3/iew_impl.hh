@@ -428,6 +428,19 @@ DefaultIEW<Impl>::drainSanityCheck() const
     ldstQueue.drainSanityCheck();
 }
 
+template <class Impl>
+void
+DefaultIEW<Impl>::clearInsts()
+{
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        insts[tid] = std::queue<DynInstPtr>();
+        skidBuffer[tid] = std::queue<DynInstPtr>();
+    }
+
+    instQueue.clearInsts();
+    ldstQueue.clearInsts();
+}
+
 template <class Impl>
 void
 DefaultIEW<Impl>::takeOverFrom()
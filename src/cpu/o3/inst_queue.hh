@@ -150,6 +150,9 @@ class InstructionQueue
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop all instructions in the IQ and its dependency tracking. */
+    void clearInsts();
+
     /** Takes over execution from another CPU's thread. */
     void takeOverFrom();
 
@@ -362,39 +365,31 @@ class InstructionQueue
 
     typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
-
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
-     */
-    std::list<ListOrderEntry> listOrder;
-
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    static_assert(Num_OpClasses <= 64,
+                  "The ready queue bitmap needs a bit per op class.");
 
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
+    /** Bitmap of the op classes whose ready queue is non-empty. */
+    uint64_t readyQueues;
 
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
+    /** Sequence number of the oldest instruction of each non-empty ready
+     *  queue. Kept alongside the queues so that select can compare ages
+     *  without dereferencing the instructions themselves.
      */
-    ListOrderIt readyIt[Num_OpClasses];
+    InstSeqNum readyOldest[Num_OpClasses];
+
+    /** Put an instruction onto the ready queue of its op class. */
+    void pushReadyInst(const DynInstPtr &inst);
 
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
+    /** Remove the oldest instruction from the ready queue of an op class. */
+    void popReadyInst(OpClass op_class);
 
     /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
+     * Find the op class whose oldest ready instruction is the oldest among
+     * a set of ready queues.
+     * @param queues Bitmap of the candidate (non-empty) ready queues.
+     * @return The selected op class, or Num_OpClasses if queues is empty.
      */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    OpClass selectOldestQueue(uint64_t queues) const;
 
     DependencyGraph<DynInstPtr> dependGraph;
 
@@ -45,6 +45,7 @@
 #include <limits>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "cpu/o3/fu_pool.hh"
 #include "cpu/o3/inst_queue.hh"
@@ -418,11 +419,9 @@ InstructionQueue<Impl>::resetState()
     for (int i = 0; i < Num_OpClasses; ++i) {
         while (!readyInsts[i].empty())
             readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
     }
+    readyQueues = 0;
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -475,6 +474,17 @@ InstructionQueue<Impl>::drainSanityCheck() const
         memDepUnit[tid].drainSanityCheck();
 }
 
+template <class Impl>
+void
+InstructionQueue<Impl>::clearInsts()
+{
+    resetState();
+    instsToExecute.clear();
+    dependGraph.reset();
+    for (ThreadID tid = 0; tid < numThreads; ++tid)
+        memDepUnit[tid].clearInsts();
+}
+
 template <class Impl>
 void
 InstructionQueue<Impl>::takeOverFrom()
@@ -559,17 +569,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return readyQueues != 0;
 }
 
 template <class Impl>
@@ -693,55 +693,52 @@ InstructionQueue<Impl>::getInstToExecute()
 
 template <class Impl>
 void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+InstructionQueue<Impl>::pushReadyInst(const DynInstPtr &inst)
 {
-    assert(!readyInsts[op_class].empty());
-
-    ListOrderEntry queue_entry;
+    OpClass op_class = inst->opClass();
+    const uint64_t bit = ULL(1) << op_class;
 
-    queue_entry.queueType = op_class;
+    readyInsts[op_class].push(inst);
 
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
+    // Only the age of the queue's oldest instruction matters to select.
+    if (!(readyQueues & bit) || inst->seqNum < readyOldest[op_class]) {
+        readyOldest[op_class] = inst->seqNum;
+    }
+    readyQueues |= bit;
+}
 
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
+template <class Impl>
+void
+InstructionQueue<Impl>::popReadyInst(OpClass op_class)
+{
+    assert(!readyInsts[op_class].empty());
 
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
-        }
+    readyInsts[op_class].pop();
 
-        list_it++;
+    if (readyInsts[op_class].empty()) {
+        readyQueues &= ~(ULL(1) << op_class);
+    } else {
+        readyOldest[op_class] = readyInsts[op_class].top()->seqNum;
     }
-
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
 }
 
 template <class Impl>
-void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
+OpClass
+InstructionQueue<Impl>::selectOldestQueue(uint64_t queues) const
 {
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
+    OpClass oldest = Num_OpClasses;
+
+    while (queues) {
+        OpClass op_class = (OpClass)findLsbSet(queues);
+        queues &= queues - 1;
+
+        if (oldest == Num_OpClasses ||
+            readyOldest[op_class] < readyOldest[oldest]) {
+            oldest = op_class;
+        }
     }
 
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    return oldest;
 }
 
 template <class Impl>
@@ -787,20 +784,16 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
-    // This will avoid trying to schedule a certain op class if there are no
+    // Repeatedly pick the ready queue holding the oldest instruction and
+    // try to get a FU that can do what this op needs. A queue whose FUs
+    // are all busy is not considered again for the rest of the cycle,
+    // which avoids trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    uint64_t candidates = readyQueues;
 
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    while (total_issued < totalWidth && candidates) {
+        OpClass op_class = selectOldestQueue(candidates);
 
         assert(!readyInsts[op_class].empty());
 
@@ -814,19 +807,11 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
+        assert(issuing_inst->seqNum == readyOldest[op_class]);
 
         if (issuing_inst->isSquashed()) {
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
-
-            listOrder.erase(order_it++);
+            popReadyInst(op_class);
+            candidates &= readyQueues | ~(ULL(1) << op_class);
 
             ++iqSquashedInstsIssued;
 
@@ -887,14 +872,8 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                     tid, issuing_inst->pcState(),
                     issuing_inst->seqNum);
 
-            readyInsts[op_class].pop();
-
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
-            }
+            popReadyInst(op_class);
+            candidates &= readyQueues | ~(ULL(1) << op_class);
 
             issuing_inst->setIssued();
             ++total_issued;
@@ -913,12 +892,11 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             statIssuedInstType[tid][op_class]++;
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
+            candidates &= ~(ULL(1) << op_class);
         }
     }
 
@@ -1083,17 +1061,7 @@ InstructionQueue<Impl>::addReadyMemInst(const DynInstPtr &ready_inst)
 {
     OpClass op_class = ready_inst->opClass();
 
-    readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    pushReadyInst(ready_inst);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
@@ -1470,17 +1438,7 @@ InstructionQueue<Impl>::addIfReady(const DynInstPtr &inst)
                 "the ready list, PC %s opclass:%i [sn:%llu].\n",
                 inst->pcState(), op_class, inst->seqNum);
 
-        readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        pushReadyInst(inst);
     }
 }
 
@@ -1516,18 +1474,12 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
-
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%llu] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
+    cprintf("Ready queues: ");
 
-        ++list_order_it;
-        ++i;
+    for (int i = 0; i < Num_OpClasses; ++i) {
+        if (readyQueues & (ULL(1) << i)) {
+            cprintf("OpClass:%i [sn:%llu] ", i, readyOldest[i]);
+        }
     }
 
     cprintf("\n");
@@ -832,6 +832,8 @@ class LSQ
 
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
+    /** Drop all instructions in the load and store queues. */
+    void clearInsts();
     /** Has the LSQ drained? */
     bool isDrained() const;
     /** Takes over execution from another CPU's thread. */
@@ -143,6 +143,14 @@ LSQ<Impl>::drainSanityCheck() const
         thread[tid].drainSanityCheck();
 }
 
+template <class Impl>
+void
+LSQ<Impl>::clearInsts()
+{
+    for (ThreadID tid = 0; tid < numThreads; tid++)
+        thread[tid].clearInsts();
+}
+
 template <class Impl>
 bool
 LSQ<Impl>::isDrained() const
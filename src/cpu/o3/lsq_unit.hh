@@ -243,6 +243,9 @@ class LSQUnit
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop all instructions in the load and store queue. */
+    void clearInsts();
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
@@ -261,6 +261,21 @@ LSQUnit<Impl>::drainSanityCheck() const
     assert(!retryPkt);
 }
 
+template<class Impl>
+void
+LSQUnit<Impl>::clearInsts()
+{
+    // Entries keep their instruction until they are reused, so clear
+    // all of them rather than just the valid ones.
+    for (int i = 0; i < loadQueue.capacity(); ++i)
+        loadQueue[i].clear();
+    for (int i = 0; i < storeQueue.capacity(); ++i)
+        storeQueue[i].clear();
+    loadQueue.flush();
+    storeQueue.flush();
+    memDepViolator = nullptr;
+}
+
 template<class Impl>
 void
 LSQUnit<Impl>::takeOverFrom()
@@ -109,6 +109,9 @@ class MemDepUnit
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop all instructions tracked by the unit. */
+    void clearInsts();
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
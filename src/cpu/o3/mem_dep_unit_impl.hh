@@ -150,6 +150,16 @@ MemDepUnit<MemDepPred, Impl>::drainSanityCheck() const
     assert(memDepHash.empty());
 }
 
+template <class MemDepPred, class Impl>
+void
+MemDepUnit<MemDepPred, Impl>::clearInsts()
+{
+    for (int i = 0; i < Impl::MaxThreads; ++i)
+        instList[i].clear();
+    instsToReplay.clear();
+    memDepHash.clear();
+}
+
 template <class MemDepPred, class Impl>
 void
 MemDepUnit<MemDepPred, Impl>::takeOverFrom()
@@ -185,6 +185,9 @@ class DefaultRename
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop all instructions held by rename. */
+    void clearInsts();
+
     /** Has the stage drained? */
     bool isDrained() const;
 
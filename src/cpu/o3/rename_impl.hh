@@ -367,6 +367,17 @@ DefaultRename<Impl>::drainSanityCheck() const
     }
 }
 
+template <class Impl>
+void
+DefaultRename<Impl>::clearInsts()
+{
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
+        insts[tid].clear();
+        skidBuffer[tid].clear();
+        serializeInst[tid] = nullptr;
+    }
+}
+
 template <class Impl>
 void
 DefaultRename<Impl>::squash(const InstSeqNum &squash_seq_num, ThreadID tid)
@@ -97,6 +97,9 @@ class ROB
     /** Perform sanity checks after a drain. */
     void drainSanityCheck() const;
 
+    /** Drop all instructions in the ROB. */
+    void clearInsts();
+
     /** Takes over another CPU's thread. */
     void takeOverFrom();
 
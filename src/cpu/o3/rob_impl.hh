@@ -138,6 +138,15 @@ ROB<Impl>::drainSanityCheck() const
     assert(isEmpty());
 }
 
+template <class Impl>
+void
+ROB<Impl>::clearInsts()
+{
+    for (ThreadID tid = 0; tid < Impl::MaxThreads; tid++)
+        instList[tid].clear();
+    resetState();
+}
+
 template <class Impl>
 void
 ROB<Impl>::takeOverFrom()
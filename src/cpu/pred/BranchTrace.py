@@ -0,0 +1,58 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+
+class BranchTraceProbe(SimObject):
+    type = 'BranchTraceProbe'
+    cxx_header = "cpu/pred/branch_trace_probe.hh"
+
+    # Records every branch committed by the predictor unit, along with
+    # the number of instructions retired in between, in a compact
+    # binary trace that BranchTraceReplayer can replay through any
+    # predictor. Instantiate it as a child of the CPU to trace.
+    bpred = Param.BranchPredictor(Parent.branchPred,
+        "Branch predictor unit to trace")
+    cpu = Param.BaseCPU(Parent.any, "CPU retiring the traced instructions")
+
+    # branch trace output file, defaults to the name of the probe
+    trace_file = Param.String("", "Branch trace output file")
+
+class BranchTraceReplayer(SimObject):
+    type = 'BranchTraceReplayer'
+    cxx_header = "cpu/pred/branch_trace_replayer.hh"
+
+    # Replays a branch trace through each of the predictors without
+    # simulating a CPU and exits the simulation once done. The stats
+    # report the MPKI and the predictions per host second of each
+    # predictor.
+    trace_file = Param.String("Branch trace to replay")
+    predictors = VectorParam.BranchPredictor(
+        "Branch predictor units to evaluate")
+    max_branches = Param.UInt64(0,
+        "Maximum number of branches to replay, 0 for the whole trace")
@@ -155,6 +155,9 @@ BPredUnit::regProbePoints()
 {
     ppBranches = pmuProbePoint("Branches");
     ppMisses = pmuProbePoint("Misses");
+
+    ppCommittedBranches.reset(new ProbePointArg<CommittedBranch>(
+        getProbeManager(), "CommittedBranches"));
 }
 
 void
@@ -211,6 +214,7 @@ BPredUnit::predict(const StaticInstPtr &inst, const InstSeqNum &seqNum,
 
     PredictorHistory predict_record(seqNum, pc.instAddr(), pred_taken,
                                     bp_history, indirect_history, tid, inst);
+    predict_record.fallThrough = pc.npc();
 
     // Now lookup in the BTB or RAS.
     if (pred_taken) {
@@ -360,6 +364,13 @@ BPredUnit::update(const InstSeqNum &done_sn, ThreadID tid)
             iPred->commit(done_sn, tid, predHist[tid].back().indirectHistory);
         }
 
+        if (ppCommittedBranches->hasListeners()) {
+            const PredictorHistory &hist = predHist[tid].back();
+            ppCommittedBranches->notify({tid, hist.pc, hist.fallThrough,
+                                         hist.target, hist.predTaken,
+                                         hist.inst});
+        }
+
         predHist[tid].pop_back();
     }
 }
@@ -43,6 +43,7 @@
 #define __CPU_PRED_BPRED_UNIT_HH__
 
 #include <deque>
+#include <memory>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -190,6 +191,26 @@ class BPredUnit : public SimObject
 
     void dump();
 
+    /**
+     * A branch committed by the predictor unit, as passed to the
+     * CommittedBranches probe point.
+     */
+    struct CommittedBranch
+    {
+        /** The thread id. */
+        ThreadID tid;
+        /** The PC of the branch. */
+        Addr pc;
+        /** The PC of the next sequential instruction. */
+        Addr fallThrough;
+        /** The PC of the next instruction executed. */
+        Addr target;
+        /** Whether or not the branch was taken. */
+        bool taken;
+        /** The branch instruction. */
+        const StaticInstPtr &inst;
+    };
+
   private:
     struct PredictorHistory {
         /**
@@ -204,7 +225,7 @@ class BPredUnit : public SimObject
               indirectHistory(indirect_history), RASTarget(0), RASIndex(0),
               tid(_tid), predTaken(pred_taken), usedRAS(0), pushedRAS(0),
               wasCall(0), wasReturn(0), wasIndirect(0), target(MaxAddr),
-              inst(inst)
+              fallThrough(MaxAddr), inst(inst)
         {}
 
         bool operator==(const PredictorHistory &entry) const {
@@ -257,6 +278,9 @@ class BPredUnit : public SimObject
          */
         Addr target;
 
+        /** PC of the next sequential instruction */
+        Addr fallThrough;
+
         /** The branch instrction */
         const StaticInstPtr inst;
     };
@@ -341,6 +365,12 @@ class BPredUnit : public SimObject
     ProbePoints::PMUUPtr ppMisses;
 
     /** @} */
+
+    /**
+     * Branches committed by the predictor unit, in program order for
+     * each thread. Used to capture branch traces.
+     */
+    std::unique_ptr<ProbePointArg<CommittedBranch>> ppCommittedBranches;
 };
 
 #endif // __CPU_PRED_BPRED_UNIT_HH__
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+using namespace std;
+
+const char BranchTraceStream::magic[8] =
+    {'g', 'e', 'm', '5', 'b', 't', 'r', 'c'};
+
+namespace
+{
+
+/**
+ * Fixed part of the trace header. It is followed by the object id and
+ * padding up to the alignment of the records.
+ */
+struct BranchTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t objIdLen;
+    uint32_t reserved;
+};
+
+} // anonymous namespace
+
+BranchTraceOutputStream::BranchTraceOutputStream(const string &filename)
+    : fileName(filename), file(fopen(filename.c_str(), "wb"))
+{
+    if (!file)
+        panic("Could not open %s for writing\n", filename);
+
+    buffer.reserve(bufferRecords);
+}
+
+BranchTraceOutputStream::~BranchTraceOutputStream()
+{
+    flushBuffer();
+
+    if (fclose(file))
+        panic("Failed to close %s\n", fileName);
+}
+
+void
+BranchTraceOutputStream::writeHeader(const string &obj_id)
+{
+    BranchTraceHeader header;
+    memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.recordSize = sizeof(BranchTraceRecord);
+    header.objIdLen = obj_id.size();
+    header.reserved = 0;
+
+    vector<uint8_t> data((const uint8_t *)&header,
+                         (const uint8_t *)&header + sizeof(header));
+    data.insert(data.end(), obj_id.begin(), obj_id.end());
+
+    // align the records to their natural alignment in the file
+    data.resize(roundUp(data.size(), alignof(BranchTraceRecord)));
+
+    writeData(data.data(), data.size());
+}
+
+void
+BranchTraceOutputStream::flushBuffer()
+{
+    writeData(buffer.data(), buffer.size() * sizeof(BranchTraceRecord));
+    buffer.clear();
+}
+
+void
+BranchTraceOutputStream::writeData(const void *data, size_t len)
+{
+    if (fwrite(data, 1, len, file) != len)
+        panic("Failed to write to %s\n", fileName);
+}
+
+BranchTraceInputStream::BranchTraceInputStream(const string &filename)
+    : fileName(filename), data(nullptr), fileSize(0), records(nullptr),
+      numRecords(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        panic("Could not open %s for reading\n", filename);
+
+    struct stat sb;
+    if (fstat(fd, &sb) || sb.st_size < (off_t)sizeof(BranchTraceHeader))
+        panic("Branch trace %s is truncated\n", filename);
+    fileSize = sb.st_size;
+
+    data = (const uint8_t *)mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE,
+                                 fd, 0);
+    close(fd);
+    if (data == (const uint8_t *)MAP_FAILED)
+        panic("Could not map branch trace %s\n", filename);
+
+    // the trace is read sequentially, let the kernel read ahead
+    madvise((void *)data, fileSize, MADV_SEQUENTIAL);
+
+    BranchTraceHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, magic, sizeof(magic)))
+        panic("%s is not a binary branch trace\n", filename);
+    if (header.version != version ||
+        header.recordSize != sizeof(BranchTraceRecord)) {
+        panic("Branch trace %s has unsupported version %d\n", filename,
+              header.version);
+    }
+
+    size_t offset = sizeof(header);
+    if (offset + header.objIdLen > fileSize)
+        panic("Branch trace %s is truncated\n", filename);
+    _objId.assign((const char *)data + offset, header.objIdLen);
+    offset = roundUp(offset + header.objIdLen, alignof(BranchTraceRecord));
+    if (offset > fileSize)
+        panic("Branch trace %s is truncated\n", filename);
+
+    records = (const BranchTraceRecord *)(data + offset);
+    numRecords = (fileSize - offset) / sizeof(BranchTraceRecord);
+}
+
+BranchTraceInputStream::~BranchTraceInputStream()
+{
+    munmap((void *)data, fileSize);
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a compact binary branch trace format. Each committed
+ * branch is stored as a fixed-size record after a small header, so
+ * that traces can be replayed through any branch predictor straight
+ * from a memory-mapped file.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_HH__
+#define __CPU_PRED_BRANCH_TRACE_HH__
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * A single committed branch in a binary branch trace.
+ */
+struct BranchTraceRecord
+{
+    /** Flags describing the branch */
+    enum Flags : uint8_t
+    {
+        Taken = 0x01,
+        Conditional = 0x02,
+        Direct = 0x04,
+        Call = 0x08,
+        Return = 0x10
+    };
+
+    /** PC of the branch */
+    uint64_t pc;
+    /** PC of the next instruction executed after the branch */
+    uint64_t target;
+    /** Instructions committed since the previous record */
+    uint32_t instDelta;
+    /** Distance from the branch to the next sequential instruction */
+    uint16_t instSize;
+    /** Combination of Flags */
+    uint8_t flags;
+    /** Hardware thread that committed the branch */
+    uint8_t tid;
+};
+
+static_assert(sizeof(BranchTraceRecord) == 24,
+              "Unexpected branch trace record size");
+
+/**
+ * A BranchTraceStream provides the shared functionality of the input
+ * and output streams, i.e. the description of the file header.
+ */
+class BranchTraceStream
+{
+  protected:
+    /// Use the ASCII characters gem5btrc as our magic number
+    static const char magic[8];
+
+    /// Version of the file format
+    static const uint32_t version = 1;
+
+    BranchTraceStream() {}
+
+  private:
+    /**
+     * Hide the copy constructor and assignment operator.
+     * @{
+     */
+    BranchTraceStream(const BranchTraceStream&);
+    BranchTraceStream& operator=(const BranchTraceStream&);
+    /** @} */
+};
+
+/**
+ * A BranchTraceOutputStream buffers records in memory and writes them
+ * to the file in large blocks.
+ */
+class BranchTraceOutputStream : public BranchTraceStream
+{
+  public:
+    /**
+     * Create an output stream for a given file name.
+     *
+     * @param filename Path to the file to create or truncate
+     */
+    BranchTraceOutputStream(const std::string &filename);
+
+    /**
+     * Flush all buffered records and close the file.
+     */
+    ~BranchTraceOutputStream();
+
+    /**
+     * Write the trace header. This must be done once, before any
+     * record is written.
+     *
+     * @param obj_id Name of the object that captured the trace
+     */
+    void writeHeader(const std::string &obj_id);
+
+    /**
+     * Append a record to the trace.
+     *
+     * @param record Record to write
+     */
+    void
+    write(const BranchTraceRecord &record)
+    {
+        buffer.push_back(record);
+        if (buffer.size() == bufferRecords)
+            flushBuffer();
+    }
+
+  private:
+    /** Write the buffered records to the file. */
+    void flushBuffer();
+
+    /** Write raw data to the file. */
+    void writeData(const void *data, size_t len);
+
+    /// Number of records per buffer
+    static const size_t bufferRecords = 1 << 16;
+
+    /// Hold on to the file name for error messages
+    const std::string fileName;
+
+    /// Underlying file
+    FILE *file;
+
+    /// Records not yet written to the file
+    std::vector<BranchTraceRecord> buffer;
+};
+
+/**
+ * A BranchTraceInputStream maps a binary branch trace into memory and
+ * gives direct access to its records.
+ */
+class BranchTraceInputStream : public BranchTraceStream
+{
+  public:
+    /**
+     * Create an input stream for a given file name and parse the
+     * header of the trace.
+     *
+     * @param filename Path to the file to read from
+     */
+    BranchTraceInputStream(const std::string &filename);
+
+    /**
+     * Unmap the trace.
+     */
+    ~BranchTraceInputStream();
+
+    /** @return The number of records in the trace */
+    uint64_t size() const { return numRecords; }
+
+    /** @return The record at the given position */
+    const BranchTraceRecord &
+    operator[](uint64_t idx) const
+    {
+        return records[idx];
+    }
+
+    /** @return The name of the object that captured the trace */
+    const std::string &objId() const { return _objId; }
+
+  private:
+    /// Hold on to the file name for error messages
+    const std::string fileName;
+
+    /// The mapped file
+    const uint8_t *data;
+
+    /// Size of the mapped file
+    size_t fileSize;
+
+    /// First record in the mapped file
+    const BranchTraceRecord *records;
+
+    /// Number of records in the file
+    uint64_t numRecords;
+
+    /// Name of the object that captured the trace
+    std::string _objId;
+};
+
+#endif //__CPU_PRED_BRANCH_TRACE_HH__
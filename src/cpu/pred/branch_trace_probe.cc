@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace_probe.hh"
+
+#include "base/callback.hh"
+#include "base/output.hh"
+#include "cpu/base.hh"
+#include "params/BranchTraceProbe.hh"
+#include "sim/core.hh"
+
+BranchTraceProbe::BranchTraceProbe(const BranchTraceProbeParams *p)
+    : SimObject(p),
+      bpred(p->bpred),
+      cpu(p->cpu),
+      traceStream(new BranchTraceOutputStream(simout.resolve(
+          p->trace_file != "" ? p->trace_file : name() + ".trc"))),
+      threads(cpu->numThreads)
+{
+    // Register a callback to compensate for the destructor not
+    // being called. The callback forces the stream to flush and
+    // closes the output file.
+    registerExitCallback(
+        new MakeCallback<BranchTraceProbe,
+                         &BranchTraceProbe::closeStreams>(this));
+}
+
+void
+BranchTraceProbe::regProbeListeners()
+{
+    listeners.emplace_back(new BranchListener(
+        *this, bpred->getProbeManager(), "CommittedBranches"));
+    listeners.emplace_back(new InstListener(
+        *this, cpu->getProbeManager(), "CommittedInsts"));
+}
+
+void
+BranchTraceProbe::startup()
+{
+    traceStream->writeHeader(bpred->name());
+}
+
+void
+BranchTraceProbe::handleInst(const BaseCPU::CommittedInst &inst)
+{
+    ThreadState &state = threads[inst.tid];
+
+    // Count macro-ops, like the RetiredInsts probe point does
+    if (!inst.inst->isMicroop() || inst.inst->isLastMicroop())
+        state.insts++;
+
+    if (inst.inst->isControl()) {
+        state.pending.push_back({inst.pc, state.insts});
+        state.insts = 0;
+    }
+}
+
+void
+BranchTraceProbe::handleBranch(const BPredUnit::CommittedBranch &branch)
+{
+    // Branches the predictor never reports (e.g., mispredicted branches
+    // on a simple CPU) add their instructions to the next record
+    ThreadState &state = threads[branch.tid];
+    uint64_t insts = 0;
+    while (!state.pending.empty()) {
+        const RetiredBranch retired = state.pending.front();
+        state.pending.pop_front();
+        insts += retired.instDelta;
+        if (retired.pc == branch.pc)
+            break;
+    }
+
+    BranchTraceRecord record;
+    record.pc = branch.pc;
+    record.target = branch.target;
+    record.instDelta = std::min<uint64_t>(insts, UINT32_MAX);
+    record.instSize = branch.fallThrough - branch.pc;
+    record.flags =
+        (branch.taken ? BranchTraceRecord::Taken : 0) |
+        (branch.inst->isCondCtrl() ? BranchTraceRecord::Conditional : 0) |
+        (branch.inst->isDirectCtrl() ? BranchTraceRecord::Direct : 0) |
+        (branch.inst->isCall() ? BranchTraceRecord::Call : 0) |
+        (branch.inst->isReturn() ? BranchTraceRecord::Return : 0);
+    record.tid = branch.tid;
+
+    traceStream->write(record);
+}
+
+void
+BranchTraceProbe::closeStreams()
+{
+    traceStream.reset();
+}
+
+BranchTraceProbe *
+BranchTraceProbeParams::create()
+{
+    return new BranchTraceProbe(this);
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a probe listener that captures the branches committed
+ * by a branch predictor unit in a binary branch trace.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_PROBE_HH__
+#define __CPU_PRED_BRANCH_TRACE_PROBE_HH__
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "cpu/base.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/branch_trace.hh"
+#include "sim/probe/probe.hh"
+#include "sim/sim_object.hh"
+
+struct BranchTraceProbeParams;
+
+/**
+ * The branch trace probe listens to the CommittedBranches probe point
+ * of a branch predictor unit and to the CommittedInsts probe point of
+ * its CPU, so that each branch record also carries the number of
+ * instructions its thread committed since the previous branch. The
+ * resulting trace can be replayed through any predictor by the
+ * BranchTraceReplayer.
+ *
+ * The predictor learns that a branch committed some time after the CPU
+ * retired it, so the instruction count of each branch is taken when the
+ * CPU retires it and queued until the predictor reports it.
+ */
+class BranchTraceProbe : public SimObject
+{
+  public:
+    BranchTraceProbe(const BranchTraceProbeParams *p);
+
+    void regProbeListeners() override;
+
+    void startup() override;
+
+  protected:
+    /** Listener forwarding the committed branches to the probe */
+    class BranchListener
+        : public ProbeListenerArgBase<BPredUnit::CommittedBranch>
+    {
+      public:
+        BranchListener(BranchTraceProbe &_parent, ProbeManager *pm,
+                       const std::string &name)
+            : ProbeListenerArgBase(pm, name), parent(_parent) {}
+
+        void
+        notify(const BPredUnit::CommittedBranch &branch) override
+        {
+            parent.handleBranch(branch);
+        }
+
+      private:
+        BranchTraceProbe &parent;
+    };
+
+    /** Listener forwarding the instructions retired by the CPU */
+    class InstListener
+        : public ProbeListenerArgBase<BaseCPU::CommittedInst>
+    {
+      public:
+        InstListener(BranchTraceProbe &_parent, ProbeManager *pm,
+                     const std::string &name)
+            : ProbeListenerArgBase(pm, name), parent(_parent) {}
+
+        void
+        notify(const BaseCPU::CommittedInst &inst) override
+        {
+            parent.handleInst(inst);
+        }
+
+      private:
+        BranchTraceProbe &parent;
+    };
+
+    /** A control instruction retired by the CPU */
+    struct RetiredBranch
+    {
+        /** The PC of the branch. */
+        Addr pc;
+        /** Instructions retired since the previous branch. */
+        uint64_t instDelta;
+    };
+
+    /** Retirement state of a thread */
+    struct ThreadState
+    {
+        /** Instructions retired since the last branch */
+        uint64_t insts = 0;
+
+        /** Retired branches the predictor has not reported yet */
+        std::deque<RetiredBranch> pending;
+    };
+
+    /** Count a retired instruction, noting it if it is a branch. */
+    void handleInst(const BaseCPU::CommittedInst &inst);
+
+    /** Append a committed branch to the trace. */
+    void handleBranch(const BPredUnit::CommittedBranch &branch);
+
+    /**
+     * Callback to flush and close the output stream on exit. If
+     * we were calling the destructor it could be done there.
+     */
+    void closeStreams();
+
+    /** Branch predictor unit providing the committed branches */
+    BPredUnit *bpred;
+
+    /** CPU providing the retired instruction count */
+    BaseCPU *cpu;
+
+    /** Trace output stream */
+    std::unique_ptr<BranchTraceOutputStream> traceStream;
+
+    /** Retirement state of each thread of the CPU */
+    std::vector<ThreadState> threads;
+
+    /** Attached listeners */
+    std::vector<std::unique_ptr<ProbeListener>> listeners;
+};
+
+#endif //__CPU_PRED_BRANCH_TRACE_PROBE_HH__
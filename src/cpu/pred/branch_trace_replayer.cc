@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/pred/branch_trace_replayer.hh"
+
+#include <algorithm>
+#include <chrono>
+
+#include "arch/types.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "params/BranchTraceReplayer.hh"
+#include "sim/sim_exit.hh"
+
+namespace
+{
+
+/**
+ * Stand-in for a traced branch. The predictors only look at the
+ * control flags of the instruction, which are rebuilt from the
+ * record flags.
+ */
+class TraceBranchInst : public StaticInst
+{
+  public:
+    TraceBranchInst(uint8_t trace_flags)
+        : StaticInst("trace_branch", TheISA::ExtMachInst(), No_OpClass)
+    {
+        const bool cond = trace_flags & BranchTraceRecord::Conditional;
+        const bool direct = trace_flags & BranchTraceRecord::Direct;
+        flags[IsControl] = true;
+        flags[IsCondControl] = cond;
+        flags[IsUncondControl] = !cond;
+        flags[IsDirectControl] = direct;
+        flags[IsIndirectControl] = !direct;
+        flags[IsCall] = trace_flags & BranchTraceRecord::Call;
+        flags[IsReturn] = trace_flags & BranchTraceRecord::Return;
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Traced branches cannot be executed\n");
+    }
+
+    void
+    advancePC(TheISA::PCState &pc_state) const override
+    {
+        pc_state.set(pc_state.npc());
+    }
+
+  protected:
+    std::string
+    generateDisassembly(Addr pc,
+                        const Loader::SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+} // anonymous namespace
+
+BranchTraceReplayer::BranchTraceReplayer(const BranchTraceReplayerParams *p)
+    : SimObject(p),
+      trace(simout.resolve(p->trace_file)),
+      predictors(p->predictors),
+      maxBranches(p->max_branches),
+      replayEvent([this]{ replay(); }, name())
+{
+    fatal_if(predictors.empty(), "%s: No predictor to replay the trace "
+             "through\n", name());
+
+    for (int i = 0; i < branchInsts.size(); ++i)
+        branchInsts[i] = new TraceBranchInst(i);
+}
+
+void
+BranchTraceReplayer::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+void
+BranchTraceReplayer::regStats()
+{
+    SimObject::regStats();
+
+    branches
+        .name(name() + ".branches")
+        .desc("Number of branches replayed")
+        ;
+
+    insts
+        .name(name() + ".insts")
+        .desc("Number of instructions covered by the replayed branches")
+        ;
+
+    mispredicts
+        .init(predictors.size())
+        .name(name() + ".mispredicts")
+        .desc("Number of mispredicted branches")
+        .flags(Stats::total)
+        ;
+
+    mpki
+        .name(name() + ".mpki")
+        .desc("Mispredicted branches per thousand instructions")
+        ;
+    mpki = mispredicts * 1000 / insts;
+
+    hostSeconds
+        .init(predictors.size())
+        .name(name() + ".hostSeconds")
+        .desc("Host time spent replaying the trace (s)")
+        ;
+
+    predictionRate
+        .name(name() + ".predictionRate")
+        .desc("Predictions per host second")
+        ;
+    predictionRate = branches / hostSeconds;
+
+    for (int i = 0; i < predictors.size(); ++i) {
+        mispredicts.subname(i, predictors[i]->name());
+        hostSeconds.subname(i, predictors[i]->name());
+    }
+}
+
+void
+BranchTraceReplayer::replay()
+{
+    const uint64_t num_branches = maxBranches ?
+        std::min(maxBranches, trace.size()) : trace.size();
+
+    ThreadID max_tid = 0;
+    for (uint64_t i = 0; i < num_branches; ++i) {
+        insts += trace[i].instDelta;
+        max_tid = std::max<ThreadID>(max_tid, trace[i].tid);
+    }
+    branches = num_branches;
+
+    for (const auto bp : predictors) {
+        const auto bp_params =
+            dynamic_cast<const BranchPredictorParams *>(bp->params());
+        fatal_if(max_tid >= bp_params->numThreads, "%s: The trace has "
+                 "branches from thread %d, but %s only has %d threads\n",
+                 name(), max_tid, bp->name(), bp_params->numThreads);
+    }
+
+    // The predictors draw from the global random number generator, so
+    // they are replayed one after the other rather than on several
+    // host threads. Going through the whole trace for one predictor at
+    // a time also keeps its tables warm in the host caches.
+    for (int i = 0; i < predictors.size(); ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        mispredicts[i] = replayPredictor(predictors[i]);
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        hostSeconds[i] = elapsed.count();
+
+        inform("%s: %s mispredicted %d of %d branches, %.3f MPKI\n",
+               name(), predictors[i]->name(), mispredicts[i].value(),
+               num_branches, mispredicts[i].value() * 1000 / insts.value());
+    }
+
+    exitSimLoop("branch trace replay complete");
+}
+
+uint64_t
+BranchTraceReplayer::replayPredictor(BPredUnit *bp)
+{
+    const uint64_t num_branches = branches.value();
+    uint64_t num_mispredicts = 0;
+
+    for (InstSeqNum seq_num = 0; seq_num < num_branches; ++seq_num) {
+        const BranchTraceRecord &record = trace[seq_num];
+        const StaticInstPtr &inst =
+            branchInsts[record.flags & ~BranchTraceRecord::Taken];
+        const bool taken = record.flags & BranchTraceRecord::Taken;
+
+        TheISA::PCState pc(record.pc);
+        pc.npc(record.pc + record.instSize);
+
+        const bool pred_taken = bp->predict(inst, seq_num, pc, record.tid);
+        if (pred_taken != taken ||
+            (taken && pc.instAddr() != record.target)) {
+            ++num_mispredicts;
+            bp->squash(seq_num, TheISA::PCState(record.target), taken,
+                       record.tid);
+        }
+        bp->update(seq_num, record.tid);
+    }
+
+    return num_mispredicts;
+}
+
+BranchTraceReplayer *
+BranchTraceReplayerParams::create()
+{
+    return new BranchTraceReplayer(this);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a trace-driven branch predictor evaluation harness.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_REPLAYER_HH__
+#define __CPU_PRED_BRANCH_TRACE_REPLAYER_HH__
+
+#include <array>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/branch_trace.hh"
+#include "cpu/static_inst.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+struct BranchTraceReplayerParams;
+
+/**
+ * The branch trace replayer feeds a branch trace captured by the
+ * BranchTraceProbe through a set of branch predictor units, without
+ * simulating a CPU. Each branch is predicted, squashed when the
+ * direction or target is wrong, and committed before the next one,
+ * i.e. the predictors see a perfectly in-order pipeline. Once all
+ * predictors have seen the whole trace, the simulation exits and the
+ * statistics hold the MPKI and the replay speed of each predictor.
+ */
+class BranchTraceReplayer : public SimObject
+{
+  public:
+    BranchTraceReplayer(const BranchTraceReplayerParams *p);
+
+    void startup() override;
+
+    void regStats() override;
+
+  protected:
+    /** Replay the trace through all predictors and exit. */
+    void replay();
+
+    /**
+     * Replay the trace through a single predictor.
+     *
+     * @param bp Predictor to replay the trace through
+     * @return The number of mispredicted branches
+     */
+    uint64_t replayPredictor(BPredUnit *bp);
+
+    /** The trace being replayed */
+    BranchTraceInputStream trace;
+
+    /** Predictors the trace is replayed through */
+    const std::vector<BPredUnit *> predictors;
+
+    /** Maximum number of branches to replay, 0 for the whole trace */
+    const uint64_t maxBranches;
+
+    /**
+     * Instructions standing in for the traced branches, indexed by
+     * the record flags without the Taken bit.
+     */
+    std::array<StaticInstPtr, BranchTraceRecord::Return << 1> branchInsts;
+
+    /** Event replaying the trace once the simulation starts */
+    EventFunctionWrapper replayEvent;
+
+    /** Stat for the number of branches replayed. */
+    Stats::Scalar branches;
+    /** Stat for the number of instructions covered by the trace. */
+    Stats::Scalar insts;
+    /** Stat for the number of mispredicted branches per predictor. */
+    Stats::Vector mispredicts;
+    /** Stat for the mispredictions per kilo-instruction per predictor. */
+    Stats::Formula mpki;
+    /** Stat for the host time spent replaying per predictor. */
+    Stats::Vector hostSeconds;
+    /** Stat for the predictions per host second per predictor. */
+    Stats::Formula predictionRate;
+};
+
+#endif //__CPU_PRED_BRANCH_TRACE_REPLAYER_HH__
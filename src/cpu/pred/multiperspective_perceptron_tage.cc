@@ -220,11 +220,7 @@ MPP_TAGE::updatePathAndGlobalHistory(
         path >>= 1;
         updateGHist(tHist.gHist, dir, tHist.globalHistory, tHist.ptGhist);
         tHist.pathHist = (tHist.pathHist << 1) ^ pathbit;
-        for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
-        }
+        updateFoldedHistories(tHist);
     }
 }
 
@@ -235,8 +231,7 @@ MPP_TAGE::isHighConfidence(TAGEBase::BranchInfo *bi) const
         return (abs(2 * gtable[bi->hitBank][bi->hitBankIndex].ctr + 1)) >=
                ((1 << tagTableCounterBits) - 1);
     } else {
-        int bim = (btablePrediction[bi->bimodalIndex] << 1)
-            + btableHysteresis[bi->bimodalIndex >> logRatioBiModalHystEntries];
+        int bim = getBimodalCtr(bi->bimodalIndex);
         return (bim == 0) || (bim == 3);
     }
 
@@ -124,12 +124,23 @@ TAGEBase::init()
         history.computeTags[1] = new FoldedHistory[nHistoryTables+1];
 
         initFoldedHistories(history);
+
+        // updateFoldedHistories() relies on this
+        for (int i = 1; i <= nHistoryTables; i++) {
+            assert(history.computeTags[0][i].origLength ==
+                   history.computeIndices[i].origLength);
+            assert(history.computeTags[1][i].origLength ==
+                   history.computeIndices[i].origLength);
+        }
     }
 
+    // Predict not taken, with the hysteresis set
     const uint64_t bimodalTableSize = ULL(1) << logTagTableSizes[0];
-    btablePrediction.resize(bimodalTableSize, false);
-    btableHysteresis.resize(bimodalTableSize >> logRatioBiModalHystEntries,
-                            true);
+    btable.resize(bimodalTableSize, 0);
+    for (uint64_t i = 0; i < bimodalTableSize;
+         i += ULL(1) << logRatioBiModalHystEntries) {
+        btable[i] = 2;
+    }
 
     gtable = new TageEntry*[nHistoryTables + 1];
     buildTageTables();
@@ -154,6 +165,30 @@ TAGEBase::initFoldedHistories(ThreadHistory & history)
     }
 }
 
+void
+TAGEBase::updateFoldedHistories(ThreadHistory & history)
+{
+    const uint8_t *h = history.gHist;
+    for (int i = 1; i <= nHistoryTables; i++) {
+        const uint8_t out = h[history.computeIndices[i].origLength];
+        history.computeIndices[i].update(h[0], out);
+        history.computeTags[0][i].update(h[0], out);
+        history.computeTags[1][i].update(h[0], out);
+    }
+}
+
+void
+TAGEBase::restoreFoldedHistories(ThreadHistory & history,
+                                 const BranchInfo *bi)
+{
+    for (int i = 1; i <= nHistoryTables; i++) {
+        history.computeIndices[i].comp = bi->ci[i];
+        history.computeTags[0][i].comp = bi->ct0[i];
+        history.computeTags[1][i].comp = bi->ct1[i];
+    }
+    updateFoldedHistories(history);
+}
+
 void
 TAGEBase::buildTageTables()
 {
@@ -184,14 +219,7 @@ TAGEBase::btbUpdate(ThreadID tid, Addr branch_pc, BranchInfo* &bi)
         DPRINTF(Tage, "BTB miss resets prediction: %lx\n", branch_pc);
         assert(tHist.gHist == &tHist.globalHistory[tHist.ptGhist]);
         tHist.gHist[0] = 0;
-        for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].comp = bi->ci[i];
-            tHist.computeTags[0][i].comp = bi->ct0[i];
-            tHist.computeTags[1][i].comp = bi->ct1[i];
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
-        }
+        restoreFoldedHistories(tHist, bi);
     }
 }
 
@@ -284,7 +312,15 @@ TAGEBase::unsignedCtrUpdate(uint8_t & ctr, bool up, unsigned nbits)
 bool
 TAGEBase::getBimodePred(Addr pc, BranchInfo* bi) const
 {
-    return btablePrediction[bi->bimodalIndex];
+    return btable[bi->bimodalIndex] & 1;
+}
+
+int
+TAGEBase::getBimodalCtr(int index) const
+{
+    const int hyst_index = (index >> logRatioBiModalHystEntries) <<
+                           logRatioBiModalHystEntries;
+    return ((btable[index] & 1) << 1) | ((btable[hyst_index] >> 1) & 1);
 }
 
 
@@ -293,8 +329,7 @@ TAGEBase::getBimodePred(Addr pc, BranchInfo* bi) const
 void
 TAGEBase::baseUpdate(Addr pc, bool taken, BranchInfo* bi)
 {
-    int inter = (btablePrediction[bi->bimodalIndex] << 1)
-        + btableHysteresis[bi->bimodalIndex >> logRatioBiModalHystEntries];
+    int inter = getBimodalCtr(bi->bimodalIndex);
     if (taken) {
         if (inter < 3)
             inter++;
@@ -303,8 +338,10 @@ TAGEBase::baseUpdate(Addr pc, bool taken, BranchInfo* bi)
     }
     const bool pred = inter >> 1;
     const bool hyst = inter & 1;
-    btablePrediction[bi->bimodalIndex] = pred;
-    btableHysteresis[bi->bimodalIndex >> logRatioBiModalHystEntries] = hyst;
+    const int hyst_index = (bi->bimodalIndex >> logRatioBiModalHystEntries) <<
+                           logRatioBiModalHystEntries;
+    btable[bi->bimodalIndex] = (btable[bi->bimodalIndex] & ~1) | pred;
+    btable[hyst_index] = (btable[hyst_index] & ~2) | (hyst << 1);
     DPRINTF(Tage, "Updating branch %lx, pred:%d, hyst:%d\n", pc, pred, hyst);
 }
 
@@ -599,17 +636,14 @@ TAGEBase::updateHistories(ThreadID tid, Addr branch_pc, bool taken,
     }
 
     //prepare next index and tag computations for user branchs
-    for (int i = 1; i <= nHistoryTables; i++)
-    {
-        if (speculative) {
+    if (speculative) {
+        for (int i = 1; i <= nHistoryTables; i++) {
             bi->ci[i]  = tHist.computeIndices[i].comp;
             bi->ct0[i] = tHist.computeTags[0][i].comp;
             bi->ct1[i] = tHist.computeTags[1][i].comp;
         }
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
     }
+    updateFoldedHistories(tHist);
     DPRINTF(Tage, "Updating global histories with branch:%lx; taken?:%d, "
             "path Hist: %x; pointer:%d\n", branch_pc, taken, tHist.pathHist,
             tHist.ptGhist);
@@ -633,14 +667,7 @@ TAGEBase::squash(ThreadID tid, bool taken, TAGEBase::BranchInfo *bi,
     tHist.ptGhist = bi->ptGhist;
     tHist.gHist = &(tHist.globalHistory[tHist.ptGhist]);
     tHist.gHist[0] = (taken ? 1 : 0);
-    for (int i = 1; i <= nHistoryTables; i++) {
-        tHist.computeIndices[i].comp = bi->ci[i];
-        tHist.computeTags[0][i].comp = bi->ct0[i];
-        tHist.computeTags[1][i].comp = bi->ct1[i];
-        tHist.computeIndices[i].update(tHist.gHist);
-        tHist.computeTags[0][i].update(tHist.gHist);
-        tHist.computeTags[1][i].update(tHist.gHist);
-    }
+    restoreFoldedHistories(tHist, bi);
 }
 
 void
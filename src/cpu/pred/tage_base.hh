@@ -65,14 +65,16 @@ class TAGEBase : public SimObject
   protected:
     // Prediction Structures
 
-    // Tage Entry
+    // Tage Entry. The fields are ordered so that an entry packs into a
+    // single 32-bit word, and cache lines hold a whole number of entries.
     struct TageEntry
     {
-        int8_t ctr;
         uint16_t tag;
+        int8_t ctr;
         uint8_t u;
-        TageEntry() : ctr(0), tag(0), u(0) { }
+        TageEntry() : tag(0), ctr(0), u(0) { }
     };
+    static_assert(sizeof(TageEntry) == 4, "TAGE entries must be packed");
 
     // Folded History Table - compressed history
     // to mix with instruction PC to index partially
@@ -99,8 +101,17 @@ class TAGEBase : public SimObject
 
         void update(uint8_t * h)
         {
-            comp = (comp << 1) | h[0];
-            comp ^= h[origLength] << outpoint;
+            update(h[0], h[origLength]);
+        }
+
+        /**
+         * Folds in the most recent outcome and folds out the outcome
+         * that is origLength branches old.
+         */
+        void update(uint8_t in, uint8_t out)
+        {
+            comp = (comp << 1) | in;
+            comp ^= out << outpoint;
             comp ^= (comp >> compLength);
             comp &= (ULL(1) << compLength) - 1;
         }
@@ -250,6 +261,13 @@ class TAGEBase : public SimObject
      */
     void baseUpdate(Addr pc, bool taken, BranchInfo* bi);
 
+    /**
+     * Gets the 2-bit counter of a bimodal entry, made of its prediction
+     * bit and of the hysteresis bit it shares with its neighbours.
+     * @param index Index of the entry in the bimodal table.
+     */
+    int getBimodalCtr(int index) const;
+
    /**
     * (Speculatively) updates the global branch history.
     * @param h Reference to pointer to global branch history.
@@ -426,8 +444,10 @@ class TAGEBase : public SimObject
     std::vector<unsigned> tagTableTagWidths;
     std::vector<int> logTagTableSizes;
 
-    std::vector<bool> btablePrediction;
-    std::vector<bool> btableHysteresis;
+    // Bimodal table, one byte per entry. Bit 0 holds the prediction, and
+    // bit 1 of the first entry of each group of
+    // 2^logRatioBiModalHystEntries entries holds their shared hysteresis.
+    std::vector<uint8_t> btable;
     TageEntry **gtable;
 
     // Keep per-thread histories to
@@ -460,6 +480,20 @@ class TAGEBase : public SimObject
      */
     virtual void initFoldedHistories(ThreadHistory & history);
 
+    /**
+     * Shifts the most recent outcome into the folded histories of all the
+     * tables. The index and tag histories of a table fold the same number
+     * of outcomes, so the outgoing one is read once for the three of them.
+     */
+    void updateFoldedHistories(ThreadHistory & history);
+
+    /**
+     * Restores the folded histories saved at prediction time, and then
+     * shifts the most recent outcome into them.
+     */
+    void restoreFoldedHistories(ThreadHistory & history,
+                                const BranchInfo *bi);
+
     int *histLengths;
     int *tableIndices;
     int *tableTags;
@@ -253,11 +253,7 @@ TAGE_SC_L_TAGE::updatePathAndGlobalHistory(
             // The 8KB implementation does not do this truncation
             tHist.pathHist = (tHist.pathHist & ((ULL(1) << pathHistBits) - 1));
         }
-        for (int i = 1; i <= nHistoryTables; i++) {
-            tHist.computeIndices[i].update(tHist.gHist);
-            tHist.computeTags[0][i].update(tHist.gHist);
-            tHist.computeTags[1][i].update(tHist.gHist);
-        }
+        updateFoldedHistories(tHist);
     }
 }
 
@@ -342,8 +338,7 @@ TAGE_SC_L_TAGE::getBimodePred(Addr pc, TAGEBase::BranchInfo* tage_bi) const
     TAGE_SC_L_TAGE::BranchInfo *bi =
         static_cast<TAGE_SC_L_TAGE::BranchInfo *>(tage_bi);
 
-    int bim = (btablePrediction[bi->bimodalIndex] << 1)
-        + btableHysteresis[bi->bimodalIndex >> logRatioBiModalHystEntries];
+    int bim = getBimodalCtr(bi->bimodalIndex);
 
     bi->highConf = (bim == 0) || (bim == 3);
     bi->lowConf = ! bi->highConf;
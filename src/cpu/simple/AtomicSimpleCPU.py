@@ -59,6 +59,16 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    memory_backdoors = Param.Bool(False, "Serve instruction fetches, "
+        "plain data reads and port proxy copies through memory backdoors "
+        "when the memory system grants them (e.g. for fast-forwarding "
+        "without caches)")
+    basic_block_cache = Param.Bool(False, "Replay the decoding of "
+        "basic blocks that were run before instead of fetching and "
+        "decoding them again (needs memory_backdoors, only used while "
+        "fetches are served through a backdoor)")
+    basic_block_cache_size = Param.Unsigned(16384, "Number of basic "
+        "blocks to cache before flushing them all")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
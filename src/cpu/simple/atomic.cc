@@ -80,6 +80,9 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
+      useBackdoors(p->memory_backdoors),
+      ifetchBackdoor(nullptr), dataBackdoor(nullptr),
+      replayStep(0), blockDecoderUpdates(0),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
       dcache_access(false), dcache_latency(0),
@@ -90,6 +93,14 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
     data_read_req = std::make_shared<Request>();
     data_write_req = std::make_shared<Request>();
     data_amo_req = std::make_shared<Request>();
+
+    if (p->basic_block_cache) {
+        fatal_if(!useBackdoors, "%s: The basic block cache needs "
+                 "memory_backdoors to be enabled.\n", name());
+        fatal_if(numThreads > 1, "%s: The basic block cache doesn't "
+                 "support multiple threads.\n", name());
+        blockCache.reset(new BasicBlockCache(p->basic_block_cache_size));
+    }
 }
 
 
@@ -150,6 +161,10 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // Memory and the decoder context may have been changed behind our
+    // back, e.g. by restoring a checkpoint.
+    flushBlockCache();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -198,6 +213,8 @@ AtomicSimpleCPU::switchOut()
     assert(!tickEvent.scheduled());
     assert(_status == BaseSimpleCPU::Running || _status == Idle);
     assert(isCpuDrained());
+
+    flushBlockCache();
 }
 
 
@@ -208,6 +225,8 @@ AtomicSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
 
     // The tick event should have been descheduled by drain()
     assert(!tickEvent.scheduled());
+
+    flushBlockCache();
 }
 
 void
@@ -271,12 +290,64 @@ AtomicSimpleCPU::suspendContext(ThreadID thread_num)
     BaseCPU::suspendContext(thread_num);
 }
 
+PortProxy::BackdoorFunc
+AtomicSimpleCPU::getBackdoorFunc()
+{
+    if (!useBackdoors)
+        return nullptr;
+
+    return [this](const AddrRange &range) -> MemBackdoorPtr {
+        for (MemBackdoorPtr bd : { dataBackdoor, ifetchBackdoor }) {
+            if (bd && range.isSubset(bd->range()))
+                return bd;
+        }
+        return nullptr;
+    };
+}
+
 Tick
 AtomicSimpleCPU::sendPacket(MasterPort &port, const PacketPtr &pkt)
 {
     return port.sendAtomic(pkt);
 }
 
+Tick
+AtomicSimpleCPU::sendReadPacket(MasterPort &port, const PacketPtr &pkt,
+                                MemBackdoorPtr &backdoor)
+{
+    assert(pkt->cmd == MemCmd::ReadReq);
+
+    if (backdoor && backdoor->readable() &&
+        pkt->getAddrRange().isSubset(backdoor->range())) {
+        const AddrRange &range = backdoor->range();
+        memcpy(pkt->getPtr<uint8_t>(),
+               backdoor->ptr() + (pkt->getAddr() - range.start()),
+               pkt->getSize());
+        pkt->makeResponse();
+        return 0;
+    }
+
+    // Only ever hold on to the first backdoor handed out on each side
+    // so that exactly one invalidation callback refers to it.
+    if (!useBackdoors || backdoor)
+        return sendPacket(port, pkt);
+
+    Tick latency = port.sendAtomicBackdoor(pkt, backdoor);
+    if (backdoor) {
+        if (backdoor->range().interleaved()) {
+            // Interleaved ranges don't map linearly onto the backing
+            // store, so don't use them.
+            backdoor = nullptr;
+        } else {
+            DPRINTF(SimpleCPU, "Using backdoor for range %s\n",
+                    backdoor->range().to_string());
+            backdoor->addInvalidationCallback(
+                [&backdoor](const MemBackdoor &) { backdoor = nullptr; });
+        }
+    }
+    return latency;
+}
+
 Tick
 AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
 {
@@ -302,6 +373,7 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
         for (auto &t_info : cpu->threadInfo) {
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
+        cpu->noteBlockWrite(pkt->getAddr(), pkt->getSize());
     }
 
     return 0;
@@ -329,6 +401,8 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
     }
+    if (pkt->isInvalidate() || pkt->isWrite())
+        cpu->noteBlockWrite(pkt->getAddr(), pkt->getSize());
 }
 
 bool
@@ -407,6 +481,10 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
 
             if (req->isLocalAccess()) {
                 dcache_latency += req->localAccessor(thread->getTC(), &pkt);
+            } else if (pkt.cmd == MemCmd::ReadReq && !req->isUncacheable() &&
+                       !req->isMasked()) {
+                dcache_latency += sendReadPacket(dcachePort, &pkt,
+                                                 dataBackdoor);
             } else {
                 dcache_latency += sendPacket(dcachePort, &pkt);
             }
@@ -518,6 +596,8 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
+
+                    noteBlockWrite(req->getPaddr(), req->getSize());
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -610,6 +690,7 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
             dcache_latency += req->localAccessor(thread->getTC(), &pkt);
         else {
             dcache_latency += sendPacket(dcachePort, &pkt);
+            noteBlockWrite(req->getPaddr(), req->getSize());
         }
 
         dcache_access = true;
@@ -670,11 +751,21 @@ AtomicSimpleCPU::tick()
 
         bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
-        if (needToFetch) {
+        // Take the decode from the block cache rather than fetching
+        // and decoding if we can.
+        bool replay = needToFetch && blockCache &&
+            replayBlockStep(t_info, pcState);
+        if (needToFetch && !replay) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
             fault = thread->itb->translateAtomic(ifetch_req, thread->getTC(),
                                                  BaseTLB::Execute);
+            if (fault != NoFault) {
+                if (recordBlock)
+                    finishBlock();
+            } else if (blockCache) {
+                replay = enterBlock(t_info, pcState);
+            }
         }
 
         if (fault == NoFault) {
@@ -682,7 +773,7 @@ AtomicSimpleCPU::tick()
             bool icache_access = false;
             dcache_access = false; // assume no dcache access
 
-            if (needToFetch) {
+            if (needToFetch && !replay) {
                 // This is commented out because the decoder would act like
                 // a tiny cache otherwise. It wouldn't be flushed when needed
                 // like the I cache. It should be flushed, and when that works
@@ -694,13 +785,17 @@ AtomicSimpleCPU::tick()
                     Packet ifetch_pkt = Packet(ifetch_req, MemCmd::ReadReq);
                     ifetch_pkt.dataStatic(&inst);
 
-                    icache_latency = sendPacket(icachePort, &ifetch_pkt);
+                    icache_latency = sendReadPacket(icachePort, &ifetch_pkt,
+                                                    ifetchBackdoor);
 
                     assert(!ifetch_pkt.isError());
 
                     // ifetch_req is initialized to read the instruction directly
                     // into the CPU object's inst field.
                 //}
+
+                if (recordBlock)
+                    recordFetch();
             }
 
             preExecute();
@@ -728,6 +823,20 @@ AtomicSimpleCPU::tick()
                 }
 
                 postExecute();
+
+                // Don't let a block run past anything that may change the
+                // flow of control or how the code that follows it is
+                // translated and decoded.
+                if ((recordBlock || replayBlock) &&
+                    (fault != NoFault || curStaticInst->isControl() ||
+                     curStaticInst->isSerializeAfter() ||
+                     curStaticInst->isNonSpeculative() ||
+                     curStaticInst->isSquashAfter())) {
+                    if (recordBlock)
+                        finishBlock();
+                    if (replayBlock)
+                        leaveBlock(t_info);
+                }
             }
 
             // @todo remove me after debugging with legion done
@@ -765,6 +874,238 @@ AtomicSimpleCPU::tick()
         reschedule(tickEvent, curTick() + latency, true);
 }
 
+bool
+AtomicSimpleCPU::inIfetchBackdoor(Addr paddr, Addr size) const
+{
+    return ifetchBackdoor && ifetchBackdoor->readable() &&
+        RangeSize(paddr, size).isSubset(ifetchBackdoor->range());
+}
+
+bool
+AtomicSimpleCPU::replayBlockStep(SimpleExecContext &t_info,
+                                 const TheISA::PCState &pc)
+{
+    if (t_info.thread->decoderUpdates != blockDecoderUpdates) {
+        // The context the decoder works in changed, e.g. the x86
+        // operating mode, so the cached decodes may not hold any more.
+        flushBlockCache();
+        blockDecoderUpdates = t_info.thread->decoderUpdates;
+    }
+
+    if (!replayBlock)
+        return false;
+
+    if (replayStep < replayBlock->steps.size()) {
+        const BasicBlockCache::Step &step = replayBlock->steps[replayStep];
+        if (step.fetchOffset == t_info.fetchOffset && step.pc == pc)
+            return true;
+    }
+
+    leaveBlock(t_info);
+    return false;
+}
+
+bool
+AtomicSimpleCPU::enterBlock(SimpleExecContext &t_info,
+                            const TheISA::PCState &pc)
+{
+    // Blocks start on instruction boundaries and are only used while
+    // fetches come through the backdoor.
+    const Addr paddr = ifetch_req->getPaddr();
+    if (recordBlock || t_info.fetchOffset ||
+        !inIfetchBackdoor(paddr, sizeof(inst))) {
+        return false;
+    }
+
+    BasicBlockCache::BlockPtr block =
+        prevBlock ? prevBlock->successor(pc) : nullptr;
+    if (block && block->paddr == paddr)
+        ++blockCacheChainHits;
+    else
+        block = blockCache->lookup(pc, paddr);
+
+    if (block) {
+        const size_t size = block->bytes.size();
+        if (inIfetchBackdoor(paddr, size) &&
+            !memcmp(block->bytes.data(), ifetchBackdoor->ptr() +
+                    (paddr - ifetchBackdoor->range().start()), size)) {
+            ++blockCacheHits;
+            if (prevBlock)
+                prevBlock->link(block);
+            replayBlock = block;
+            replayStep = 0;
+            // The decoder won't see the bytes of the block, so make sure
+            // it doesn't hold on to any from before either.
+            t_info.thread->decoder.reset();
+            return true;
+        }
+
+        // The code was modified since the block was recorded.
+        ++blockCacheInvalidations;
+        blockCache->invalidate(block);
+    }
+
+    ++blockCacheMisses;
+    recordBlock = std::make_shared<BasicBlockCache::Block>();
+    recordBlock->vaddr = ifetch_req->getVaddr();
+    recordBlock->paddr = paddr;
+    t_info.thread->decoder.reset();
+    return false;
+}
+
+void
+AtomicSimpleCPU::recordFetch()
+{
+    const Addr vaddr = ifetch_req->getVaddr();
+    const Addr paddr = ifetch_req->getPaddr();
+    std::vector<uint8_t> &bytes = recordBlock->bytes;
+
+    // Stop at page boundaries, where the translation may change, and
+    // as soon as the fetches stop running straight through memory.
+    const Addr page = roundDown(recordBlock->vaddr, TheISA::PageBytes);
+    if (vaddr < recordBlock->vaddr ||
+        vaddr - recordBlock->vaddr > bytes.size() ||
+        paddr - recordBlock->paddr != vaddr - recordBlock->vaddr ||
+        roundDown(vaddr + sizeof(inst) - 1, TheISA::PageBytes) != page ||
+        !inIfetchBackdoor(paddr, sizeof(inst))) {
+        finishBlock();
+        return;
+    }
+
+    // Fetches may overlap, e.g. when several instructions are decoded
+    // from the same chunk.
+    const Addr have = bytes.size() - (vaddr - recordBlock->vaddr);
+    if (have < sizeof(inst)) {
+        const uint8_t *data = reinterpret_cast<const uint8_t *>(&inst);
+        bytes.insert(bytes.end(), data + have, data + sizeof(inst));
+    }
+}
+
+void
+AtomicSimpleCPU::finishBlock()
+{
+    BasicBlockCache::BlockPtr block = recordBlock;
+    recordBlock = nullptr;
+
+    // Only keep whole instructions so that leaving a block always
+    // leaves the decoder on an instruction boundary.
+    std::vector<BasicBlockCache::Step> &steps = block->steps;
+    while (!steps.empty() && !steps.back().inst)
+        steps.pop_back();
+    if (steps.empty())
+        return;
+
+    blockCache->insert(block);
+    if (prevBlock)
+        prevBlock->link(block);
+    prevBlock = block;
+}
+
+void
+AtomicSimpleCPU::leaveBlock(SimpleExecContext &t_info)
+{
+    prevBlock = replayBlock;
+    replayBlock = nullptr;
+
+    // The decoder hasn't seen any of the replayed bytes. If we are in
+    // the middle of an instruction, start over from its first fetch,
+    // nothing of it has been executed yet.
+    if (t_info.stayAtPC)
+        t_info.fetchOffset = 0;
+}
+
+void
+AtomicSimpleCPU::flushBlockCache()
+{
+    if (!blockCache)
+        return;
+
+    if (replayBlock)
+        leaveBlock(*threadInfo[curThread]);
+    blockCache->flush();
+    recordBlock = nullptr;
+    prevBlock = nullptr;
+}
+
+void
+AtomicSimpleCPU::noteBlockWrite(Addr paddr, Addr size)
+{
+    if (!blockCache)
+        return;
+
+    auto overlaps = [paddr, size](const BasicBlockCache::BlockPtr &block) {
+        return block && paddr < block->paddr + block->bytes.size() &&
+            block->paddr < paddr + size;
+    };
+
+    if (overlaps(replayBlock)) {
+        DPRINTF(SimpleCPU, "Write to %#x hit the block being replayed\n",
+                paddr);
+        ++blockCacheInvalidations;
+        blockCache->invalidate(replayBlock);
+        leaveBlock(*threadInfo[curThread]);
+        prevBlock = nullptr;
+    }
+
+    if (overlaps(recordBlock))
+        recordBlock = nullptr;
+}
+
+StaticInstPtr
+AtomicSimpleCPU::decodeFetched(TheISA::PCState &pc)
+{
+    if (replayBlock) {
+        const BasicBlockCache::Step &step = replayBlock->steps[replayStep++];
+        ++blockCacheReplayedSteps;
+        pc = step.nextPC;
+        return step.inst;
+    }
+
+    if (!recordBlock)
+        return BaseSimpleCPU::decodeFetched(pc);
+
+    BasicBlockCache::Step step;
+    step.pc = pc;
+    step.fetchOffset = threadInfo[curThread]->fetchOffset;
+    step.inst = BaseSimpleCPU::decodeFetched(pc);
+    step.nextPC = pc;
+    recordBlock->steps.push_back(step);
+    return step.inst;
+}
+
+void
+AtomicSimpleCPU::regStats()
+{
+    BaseSimpleCPU::regStats();
+
+    blockCacheHits
+        .name(name() + ".blockCache.hits")
+        .desc("Number of basic blocks replayed from the block cache")
+        ;
+
+    blockCacheChainHits
+        .name(name() + ".blockCache.chainHits")
+        .desc("Number of basic blocks found through the block they "
+              "followed")
+        ;
+
+    blockCacheMisses
+        .name(name() + ".blockCache.misses")
+        .desc("Number of basic blocks recorded")
+        ;
+
+    blockCacheInvalidations
+        .name(name() + ".blockCache.invalidations")
+        .desc("Number of basic blocks dropped because their code was "
+              "modified")
+        ;
+
+    blockCacheReplayedSteps
+        .name(name() + ".blockCache.replayedDecodes")
+        .desc("Number of decodes replayed from the block cache")
+        ;
+}
+
 void
 AtomicSimpleCPU::regProbePoints()
 {
@@ -41,8 +41,12 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <memory>
+
 #include "cpu/simple/base.hh"
+#include "cpu/simple/block_cache.hh"
 #include "cpu/simple/exec_context.hh"
+#include "mem/backdoor.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -65,6 +69,84 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     const bool simulate_data_stalls;
     const bool simulate_inst_stalls;
 
+    /**
+     * Service instruction fetches and plain data reads straight from a
+     * host pointer when the memory system hands out a backdoor for the
+     * accessed range, rather than sending a packet for every access.
+     */
+    const bool useBackdoors;
+
+    /** Backdoors granted on the instruction and data side. */
+    MemBackdoorPtr ifetchBackdoor;
+    MemBackdoorPtr dataBackdoor;
+
+    /**
+     * Decoded basic blocks, or nullptr if the block cache is disabled.
+     * Blocks are only recorded and replayed while instruction fetches
+     * are served through ifetchBackdoor, so skipping a fetch never
+     * skips any latency or side effect in the memory system.
+     */
+    std::unique_ptr<BasicBlockCache> blockCache;
+
+    /** Block being replayed and the index of its next step. */
+    BasicBlockCache::BlockPtr replayBlock;
+    size_t replayStep;
+
+    /** Block being recorded. */
+    BasicBlockCache::BlockPtr recordBlock;
+
+    /** Block recorded or replayed last, to chain the next one to. */
+    BasicBlockCache::BlockPtr prevBlock;
+
+    /** Decoder update count of the thread the cached blocks belong to. */
+    uint64_t blockDecoderUpdates;
+
+    /**
+     * Check whether the decode at pc can be replayed from the block
+     * being replayed, leaving the block if it can't. Called before
+     * every instruction fetch.
+     */
+    bool replayBlockStep(SimpleExecContext &t_info,
+                         const TheISA::PCState &pc);
+
+    /**
+     * Look for a block starting at pc once the first fetch of an
+     * instruction has been translated. Start replaying it if it still
+     * matches memory, otherwise start recording a new one.
+     *
+     * @return True if the fetch can be skipped.
+     */
+    bool enterBlock(SimpleExecContext &t_info, const TheISA::PCState &pc);
+
+    /** Add the bytes just fetched to the block being recorded. */
+    void recordFetch();
+
+    /** Stop recording and add the block to the cache. */
+    void finishBlock();
+
+    /** Stop replaying and go back to fetching and decoding. */
+    void leaveBlock(SimpleExecContext &t_info);
+
+    /** Drop all blocks, e.g. when the decoder context changed. */
+    void flushBlockCache();
+
+    /** Check that the bytes of a block can be read from the backdoor. */
+    bool inIfetchBackdoor(Addr paddr, Addr size) const;
+
+    /**
+     * Notice a write to physical memory, by this CPU or snooped from
+     * another one, and stop using a block it modifies.
+     */
+    void noteBlockWrite(Addr paddr, Addr size);
+
+    StaticInstPtr decodeFetched(TheISA::PCState &pc) override;
+
+    Stats::Scalar blockCacheHits;
+    Stats::Scalar blockCacheChainHits;
+    Stats::Scalar blockCacheMisses;
+    Stats::Scalar blockCacheInvalidations;
+    Stats::Scalar blockCacheReplayedSteps;
+
     // main simulation loop (one cycle)
     void tick();
 
@@ -103,6 +185,20 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     virtual Tick sendPacket(MasterPort &port, const PacketPtr &pkt);
 
+    /**
+     * Send a read packet, copying the data directly out of the given
+     * backdoor if it covers the request. If no backdoor is held yet
+     * the packet is sent in a way that lets the memory system grant
+     * one for subsequent accesses.
+     *
+     * @param port Port to send the packet through on a backdoor miss.
+     * @param pkt Read packet to service.
+     * @param backdoor Backdoor cached for this port.
+     * @return Latency of the access, zero when served by the backdoor.
+     */
+    Tick sendReadPacket(MasterPort &port, const PacketPtr &pkt,
+                        MemBackdoorPtr &backdoor);
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomicSnoop and ignores the packet instead of panicking. It
@@ -188,6 +284,12 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     void switchOut() override;
     void takeOverFrom(BaseCPU *oldCPU) override;
 
+    /**
+     * Let port proxies reuse the backdoors held by this CPU, which are
+     * only ever handed out when there are no caches on its path.
+     */
+    PortProxy::BackdoorFunc getBackdoorFunc() override;
+
     void verifyMemoryMode() const override;
 
     void activateContext(ThreadID thread_num) override;
@@ -229,6 +331,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     void regProbePoints() override;
 
+    void regStats() override;
+
     /**
      * Print state of address in memory system via PrintReq (for
      * debugging).
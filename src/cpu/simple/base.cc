@@ -494,21 +494,7 @@ BaseSimpleCPU::preExecute()
                                                   curMacroStaticInst);
     } else if (!curMacroStaticInst) {
         //We're not in the middle of a macro instruction
-        StaticInstPtr instPtr = NULL;
-
-        TheISA::Decoder *decoder = &(thread->decoder);
-
-        //Predecode, ie bundle up an ExtMachInst
-        //If more fetch data is needed, pass it in.
-        Addr fetchPC = (pcState.instAddr() & PCMask) + t_info.fetchOffset;
-        //if (decoder->needMoreBytes())
-            decoder->moreBytes(pcState, fetchPC, inst);
-        //else
-        //    decoder->process();
-
-        //Decode an instruction if one is ready. Otherwise, we'll have to
-        //fetch beyond the MachInst at the current pc.
-        instPtr = decoder->decode(pcState);
+        StaticInstPtr instPtr = decodeFetched(pcState);
         if (instPtr) {
             t_info.stayAtPC = false;
             thread->pcState(pcState);
@@ -557,6 +543,25 @@ BaseSimpleCPU::preExecute()
     }
 }
 
+StaticInstPtr
+BaseSimpleCPU::decodeFetched(TheISA::PCState &pcState)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    TheISA::Decoder *decoder = &(t_info.thread->decoder);
+
+    //Predecode, ie bundle up an ExtMachInst
+    //If more fetch data is needed, pass it in.
+    Addr fetchPC = (pcState.instAddr() & PCMask) + t_info.fetchOffset;
+    //if (decoder->needMoreBytes())
+        decoder->moreBytes(pcState, fetchPC, inst);
+    //else
+    //    decoder->process();
+
+    //Decode an instruction if one is ready. Otherwise, we'll have to
+    //fetch beyond the MachInst at the current pc.
+    return decoder->decode(pcState);
+}
+
 void
 BaseSimpleCPU::postExecute()
 {
@@ -643,7 +648,7 @@ BaseSimpleCPU::postExecute()
     }
 
     // Call CPU instruction commit probes
-    probeInstCommit(curStaticInst, instAddr);
+    probeInstCommit(curStaticInst, instAddr, curThread);
 }
 
 void
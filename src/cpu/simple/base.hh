@@ -127,6 +127,15 @@ class BaseSimpleCPU : public BaseCPU
     void postExecute();
     void advancePC(const Fault &fault);
 
+    /**
+     * Pass the fetched bytes in inst to the decoder and try to decode
+     * an instruction at pc, updating pc the way the decoder does.
+     *
+     * @return The decoded instruction, or nullptr if the decoder needs
+     *         the next fetch chunk first.
+     */
+    virtual StaticInstPtr decodeFetched(TheISA::PCState &pc);
+
     void haltContext(ThreadID thread_num) override;
 
     // statistics
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/simple/block_cache.hh"
+
+BasicBlockCache::BlockPtr
+BasicBlockCache::Block::successor(const TheISA::PCState &pc) const
+{
+    for (const auto &n : next) {
+        BlockPtr block = n.lock();
+        if (block && block->startPC() == pc)
+            return block;
+    }
+    return nullptr;
+}
+
+void
+BasicBlockCache::Block::link(const BlockPtr &block)
+{
+    if (next[0].lock() == block)
+        return;
+    next[1] = next[0];
+    next[0] = block;
+}
+
+BasicBlockCache::BlockPtr
+BasicBlockCache::lookup(const TheISA::PCState &pc, Addr paddr) const
+{
+    auto range = blocks.equal_range(pc.instAddr());
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->paddr == paddr && it->second->startPC() == pc)
+            return it->second;
+    }
+    return nullptr;
+}
+
+void
+BasicBlockCache::insert(const BlockPtr &block)
+{
+    if (blocks.size() >= maxBlocks)
+        flush();
+    blocks.emplace(block->startPC().instAddr(), block);
+}
+
+void
+BasicBlockCache::invalidate(const BlockPtr &block)
+{
+    auto range = blocks.equal_range(block->startPC().instAddr());
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == block) {
+            blocks.erase(it);
+            return;
+        }
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_SIMPLE_BLOCK_CACHE_HH__
+#define __CPU_SIMPLE_BLOCK_CACHE_HH__
+
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "arch/types.hh"
+#include "base/types.hh"
+#include "cpu/static_inst.hh"
+
+/**
+ * A cache of decoded basic blocks for the atomic CPU.
+ *
+ * A block records every call the CPU makes into the decoder while it
+ * runs through a straight line of code: the PC and fetch offset going
+ * in, and the instruction and updated PC coming out. Replaying a block
+ * hands the CPU the same results without fetching or decoding, while
+ * the CPU still executes, counts and traces one instruction at a time.
+ *
+ * Blocks never span a page and remember the physical address and the
+ * bytes they were decoded from, so the CPU can check that they still
+ * match memory before using them. Each block links to the blocks that
+ * were found to follow it, which saves a lookup when they are chained.
+ */
+class BasicBlockCache
+{
+  public:
+    /** One call into the decoder. */
+    struct Step
+    {
+        /** PC and fetch offset the decoder was called with. */
+        TheISA::PCState pc;
+        Addr fetchOffset;
+
+        /** Decoded instruction, nullptr if more bytes were needed. */
+        StaticInstPtr inst;
+
+        /** PC as updated by the decoder. */
+        TheISA::PCState nextPC;
+    };
+
+    struct Block;
+    typedef std::shared_ptr<Block> BlockPtr;
+
+    struct Block
+    {
+        /** Virtual and physical address of the first fetched byte. */
+        Addr vaddr;
+        Addr paddr;
+
+        /** Instruction bytes the block was decoded from. */
+        std::vector<uint8_t> bytes;
+
+        std::vector<Step> steps;
+
+        /** Blocks that have followed this one, most recent first. */
+        std::array<std::weak_ptr<Block>, 2> next;
+
+        const TheISA::PCState &startPC() const { return steps[0].pc; }
+
+        /** Return a linked successor starting at pc, if any. */
+        BlockPtr successor(const TheISA::PCState &pc) const;
+
+        /** Remember that block followed this one. */
+        void link(const BlockPtr &block);
+    };
+
+    /**
+     * @param max_blocks Number of blocks to hold before the whole cache
+     *                   is flushed to make room.
+     */
+    BasicBlockCache(size_t max_blocks) : maxBlocks(max_blocks) {}
+
+    /**
+     * Find the block starting at pc that was decoded from the given
+     * physical address, or return nullptr.
+     */
+    BlockPtr lookup(const TheISA::PCState &pc, Addr paddr) const;
+
+    /** Add a recorded block. */
+    void insert(const BlockPtr &block);
+
+    /** Drop a block that no longer matches memory. */
+    void invalidate(const BlockPtr &block);
+
+    /** Drop all blocks. */
+    void flush() { blocks.clear(); }
+
+    size_t size() const { return blocks.size(); }
+
+  private:
+    const size_t maxBlocks;
+
+    /** Blocks by the address of their first instruction. */
+    std::unordered_multimap<Addr, BlockPtr> blocks;
+};
+
+#endif // __CPU_SIMPLE_BLOCK_CACHE_HH__
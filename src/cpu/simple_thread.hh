@@ -138,6 +138,15 @@ class SimpleThread : public ThreadState, public ThreadContext
 
     TheISA::Decoder decoder;
 
+    /**
+     * Number of times the decoder was handed out through
+     * getDecoderPtr(). The ISAs only ask for it there to change the
+     * context it decodes in, so anything holding on to decoded
+     * instructions can compare this count to find out whether they may
+     * have gone stale.
+     */
+    uint64_t decoderUpdates = 0;
+
     // constructor: initialize SimpleThread from given process structure
     // FS
     SimpleThread(BaseCPU *_cpu, int _thread_num, System *_system,
@@ -229,7 +238,12 @@ class SimpleThread : public ThreadState, public ThreadContext
 
     BaseISA *getIsaPtr() override { return isa; }
 
-    TheISA::Decoder *getDecoderPtr() override { return &decoder; }
+    TheISA::Decoder *
+    getDecoderPtr() override
+    {
+        ++decoderUpdates;
+        return &decoder;
+    }
 
     System *getSystemPtr() override { return system; }
 
@@ -58,6 +58,7 @@ class PyTrafficGen(BaseTrafficGen):
         PyBindMethod("createRandom"),
         PyBindMethod("createDram"),
         PyBindMethod("createDramRot"),
+        PyBindMethod("createMulti"),
     ]
 
     @cxxMethod(override=True)
@@ -47,6 +47,7 @@
 #include "cpu/testers/traffic_gen/exit_gen.hh"
 #include "cpu/testers/traffic_gen/idle_gen.hh"
 #include "cpu/testers/traffic_gen/linear_gen.hh"
+#include "cpu/testers/traffic_gen/multi_gen.hh"
 #include "cpu/testers/traffic_gen/random_gen.hh"
 #include "cpu/testers/traffic_gen/stream_gen.hh"
 #include "debug/Checkpoint.hh"
@@ -77,14 +78,18 @@ BaseTrafficGen::BaseTrafficGen(const BaseTrafficGenParams* p)
       retryPkt(NULL),
       retryPktTick(0), blockedWaitingResp(false),
       updateEvent([this]{ update(); }, name()),
+      numWaitingResp(0), hostStarted(false),
       stats(this),
       masterID(system->getMasterId(this)),
       streamGenerator(StreamGen::create(p))
 {
+    stats.hostSeconds.method(this, &BaseTrafficGen::hostSeconds);
 }
 
 BaseTrafficGen::~BaseTrafficGen()
 {
+    for (void *storage : packetPool)
+        ::operator delete(storage);
 }
 
 Port &
@@ -209,7 +214,7 @@ BaseTrafficGen::update()
                 warn("%s suppressed %d packets with non-memory addresses\n",
                      name(), stats.numSuppressed.value());
 
-            delete pkt;
+            releasePacket(pkt);
             pkt = nullptr;
         }
     }
@@ -248,6 +253,7 @@ BaseTrafficGen::transition()
         nextPacketTick = MaxTick;
         nextTransitionTick = MaxTick;
         assert(!updateEvent.scheduled());
+        hostStopTime = std::chrono::steady_clock::now();
     }
 }
 
@@ -278,6 +284,8 @@ BaseTrafficGen::scheduleUpdate()
 void
 BaseTrafficGen::start()
 {
+    hostStarted = true;
+    hostStartTime = std::chrono::steady_clock::now();
     transition();
     scheduleUpdate();
 }
@@ -349,10 +357,54 @@ BaseTrafficGen::StatGroup::StatGroup(Stats::Group *parent)
       ADD_STAT(readBW, "Read bandwidth in bytes/s",
                bytesRead / simSeconds),
       ADD_STAT(writeBW, "Write bandwidth in bytes/s",
-               bytesWritten / simSeconds)
+               bytesWritten / simSeconds),
+      ADD_STAT(hostSeconds, "Host time the generator has been running (s)"),
+      ADD_STAT(hostPacketRate, "Packets generated per host second",
+               numPackets / hostSeconds)
 {
 }
 
+double
+BaseTrafficGen::hostSeconds() const
+{
+    if (!hostStarted)
+        return 0;
+
+    // Stop counting once the generator has run out of states
+    const auto end = activeGenerator ? std::chrono::steady_clock::now() :
+        hostStopTime;
+    const std::chrono::duration<double> elapsed = end - hostStartTime;
+    return elapsed.count();
+}
+
+void
+BaseTrafficGen::resetStats()
+{
+    ClockedObject::resetStats();
+
+    // Measure the host time over the same period as the packet count
+    hostStartTime = activeGenerator ? std::chrono::steady_clock::now() :
+        hostStopTime;
+}
+
+PacketPtr
+BaseTrafficGen::allocPacket(const RequestPtr &req, MemCmd cmd)
+{
+    if (packetPool.empty())
+        return new Packet(req, cmd);
+
+    void *storage = packetPool.back();
+    packetPool.pop_back();
+    return new (storage) Packet(req, cmd);
+}
+
+void
+BaseTrafficGen::releasePacket(PacketPtr pkt)
+{
+    pkt->~Packet();
+    packetPool.push_back(pkt);
+}
+
 std::shared_ptr<BaseGen>
 BaseTrafficGen::createIdle(Tick duration)
 {
@@ -456,30 +508,40 @@ BaseTrafficGen::createTrace(Tick duration,
 #endif
 }
 
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createMulti(
+    Tick duration, const std::vector<std::shared_ptr<BaseGen>> &streams)
+{
+    return std::shared_ptr<BaseGen>(
+        new MultiGen(*this, masterID, duration, streams));
+}
+
 bool
 BaseTrafficGen::recvTimingResp(PacketPtr pkt)
 {
-    auto iter = waitingResp.find(pkt->req);
+    auto *entry = dynamic_cast<WaitingResp *>(pkt->senderState);
 
-    panic_if(iter == waitingResp.end(), "%s: "
+    panic_if(!entry, "%s: "
             "Received unexpected response [%s reqPtr=%x]\n",
                pkt->print(), pkt->req);
 
-    assert(iter->second <= curTick());
+    pkt->popSenderState();
+    assert(entry->issueTick <= curTick());
 
     if (pkt->isWrite()) {
         ++stats.totalWrites;
         stats.bytesWritten += pkt->req->getSize();
-        stats.totalWriteLatency += curTick() - iter->second;
+        stats.totalWriteLatency += curTick() - entry->issueTick;
     } else {
         ++stats.totalReads;
         stats.bytesRead += pkt->req->getSize();
-        stats.totalReadLatency += curTick() - iter->second;
+        stats.totalReadLatency += curTick() - entry->issueTick;
     }
 
-    waitingResp.erase(iter);
+    freeWaitingResp.push_back(entry->index);
+    --numWaitingResp;
 
-    delete pkt;
+    releasePacket(pkt);
 
     // Sends up the request if we were blocked
     if (blockedWaitingResp) {
@@ -38,9 +38,11 @@
 #ifndef __CPU_TRAFFIC_GEN_BASE_HH__
 #define __CPU_TRAFFIC_GEN_BASE_HH__
 
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <tuple>
-#include <unordered_map>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "enums/AddrMap.hh"
@@ -170,26 +172,75 @@ class BaseTrafficGen : public ClockedObject
     bool blockedWaitingResp;
 
     /**
-     * Puts this packet in the waitingResp list and returns true if
+     * Entry of the table of requests waiting for a response. The entry
+     * travels with the packet as its sender state, so matching a
+     * response to its request needs neither a lookup nor an
+     * allocation.
+     */
+    struct WaitingResp : public Packet::SenderState
+    {
+        /** Tick at which the request was generated */
+        Tick issueTick;
+
+        /** Index of this entry in the table */
+        unsigned index;
+    };
+
+    /**
+     * Puts this packet in the waitingResp table and returns true if
      * we are above the maximum number of oustanding requests.
      */
     bool allocateWaitingRespSlot(PacketPtr pkt)
     {
-        assert(waitingResp.find(pkt->req) == waitingResp.end());
         assert(pkt->needsResponse());
 
-        waitingResp[pkt->req] = curTick();
+        if (freeWaitingResp.empty()) {
+            // the entries must not move, so grow the table at the end
+            waitingResp.emplace_back();
+            waitingResp.back().index = waitingResp.size() - 1;
+            freeWaitingResp.push_back(waitingResp.back().index);
+        }
+
+        WaitingResp &entry = waitingResp[freeWaitingResp.back()];
+        freeWaitingResp.pop_back();
+        entry.issueTick = curTick();
+        pkt->pushSenderState(&entry);
+        ++numWaitingResp;
 
         return (maxOutstandingReqs > 0) &&
-               (waitingResp.size() > maxOutstandingReqs);
+               (numWaitingResp > maxOutstandingReqs);
     }
 
     /** Event for scheduling updates */
     EventFunctionWrapper updateEvent;
 
+    /**
+     * Storage of packets that have been destroyed after their
+     * response was received, reused for the packets generated next.
+     */
+    std::vector<void *> packetPool;
+
   protected: // Stats
-    /** Reqs waiting for response **/
-    std::unordered_map<RequestPtr,Tick> waitingResp;
+    /** Reqs waiting for response, indexed by their slot **/
+    std::deque<WaitingResp> waitingResp;
+
+    /** Indices of the unused entries of the waitingResp table */
+    std::vector<unsigned> freeWaitingResp;
+
+    /** Number of requests waiting for a response */
+    unsigned numWaitingResp;
+
+    /** Has the generator been started? */
+    bool hostStarted;
+
+    /**
+     * Host time at which the generator was started, or at which the
+     * statistics were last reset
+     */
+    std::chrono::steady_clock::time_point hostStartTime;
+
+    /** Host time at which the generator ran out of states */
+    std::chrono::steady_clock::time_point hostStopTime;
 
     struct StatGroup : public Stats::Group {
         StatGroup(Stats::Group *parent);
@@ -235,8 +286,20 @@ class BaseTrafficGen : public ClockedObject
 
         /** Write bandwidth in bytes/s  */
         Stats::Formula writeBW;
+
+        /** Host time the generator has been running for */
+        Stats::Value hostSeconds;
+
+        /** Generated packets per host second */
+        Stats::Formula hostPacketRate;
     } stats;
 
+    /**
+     * Host time in seconds the generator has been running for since it
+     * was started or the statistics were reset, 0 before it is started
+     */
+    double hostSeconds() const;
+
   public:
     BaseTrafficGen(const BaseTrafficGenParams* p);
 
@@ -252,6 +315,8 @@ class BaseTrafficGen : public ClockedObject
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
+    void resetStats() override;
+
   public: // Generator factory methods
     std::shared_ptr<BaseGen> createIdle(Tick duration);
     std::shared_ptr<BaseGen> createExit(Tick duration);
@@ -293,6 +358,27 @@ class BaseTrafficGen : public ClockedObject
         Tick duration,
         const std::string& trace_file, Addr addr_offset);
 
+    std::shared_ptr<BaseGen> createMulti(
+        Tick duration,
+        const std::vector<std::shared_ptr<BaseGen>> &streams);
+
+    /**
+     * Create a packet, reusing the storage of a previously released
+     * one if there is any.
+     *
+     * @param req Request of the packet
+     * @param cmd Memory command of the packet
+     * @return The new packet
+     */
+    PacketPtr allocPacket(const RequestPtr &req, MemCmd cmd);
+
+    /**
+     * Destroy a packet and keep its storage for later packets.
+     *
+     * @param pkt Packet created with allocPacket
+     */
+    void releasePacket(PacketPtr pkt);
+
   protected:
     void start();
 
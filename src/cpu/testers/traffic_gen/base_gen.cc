@@ -48,6 +48,7 @@
 
 BaseGen::BaseGen(SimObject &obj, MasterID master_id, Tick _duration)
     : _name(obj.name()), masterID(master_id),
+      trafficGen(dynamic_cast<BaseTrafficGen *>(&obj)),
       duration(_duration)
 {
 }
@@ -62,8 +63,10 @@ BaseGen::getPacket(Addr addr, unsigned size, const MemCmd& cmd,
     // bits
     req->setPC(((Addr)masterID) << 2);
 
-    // Embed it in a packet
-    PacketPtr pkt = new Packet(req, cmd);
+    // Embed it in a packet, recycling the storage of packets whose
+    // response has been received when owned by a traffic generator
+    PacketPtr pkt = trafficGen ? trafficGen->allocPacket(req, cmd) :
+        new Packet(req, cmd);
 
     uint8_t* pkt_data = new uint8_t[req->getSize()];
     pkt->dataDynamic(pkt_data);
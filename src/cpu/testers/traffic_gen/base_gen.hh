@@ -65,6 +65,12 @@ class BaseGen
     /** The MasterID used for generating requests */
     const MasterID masterID;
 
+    /**
+     * Traffic generator owning this generator, if any, used to reuse
+     * the storage of packets
+     */
+    BaseTrafficGen *const trafficGen;
+
     /**
      * Generate a new request and associated packet
      *
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/multi_gen.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+MultiGen::MultiGen(SimObject &obj, MasterID master_id, Tick _duration,
+                   const std::vector<std::shared_ptr<BaseGen>> &_streams)
+    : BaseGen(obj, master_id, _duration), streams(_streams),
+      lastStream(-1)
+{
+    fatal_if(streams.empty(), "%s: multi-stream generator without "
+             "streams\n", name());
+    for (const auto &stream : streams)
+        fatal_if(!stream, "%s: invalid stream generator\n", name());
+}
+
+void
+MultiGen::enter()
+{
+    pending = decltype(pending)();
+    lastStream = -1;
+
+    for (unsigned i = 0; i < streams.size(); i++) {
+        streams[i]->enter();
+        const Tick next = streams[i]->nextPacketTick(false, 0);
+        if (next != MaxTick)
+            pending.emplace(next, i);
+    }
+
+    DPRINTF(TrafficGen, "MultiGen::enter: %d of %d streams active\n",
+            pending.size(), streams.size());
+}
+
+PacketPtr
+MultiGen::getNextPacket()
+{
+    assert(lastStream == -1);
+    assert(!pending.empty());
+
+    lastStream = pending.top().second;
+    pending.pop();
+
+    return streams[lastStream]->getNextPacket();
+}
+
+void
+MultiGen::exit()
+{
+    for (auto &stream : streams)
+        stream->exit();
+}
+
+Tick
+MultiGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    // only the stream that sent the last packet was held up by any
+    // back-pressure, so only its timing is updated
+    if (lastStream != -1) {
+        const Tick next = streams[lastStream]->nextPacketTick(elastic,
+                                                               delay);
+        if (next != MaxTick)
+            pending.emplace(next, lastStream);
+        lastStream = -1;
+    }
+
+    return pending.empty() ? MaxTick :
+        std::max(pending.top().first, curTick());
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the multi-stream generator that interleaves the
+ * packets of several independent generators.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_MULTI_GEN_HH__
+#define __CPU_TRAFFIC_GEN_MULTI_GEN_HH__
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "base_gen.hh"
+
+/**
+ * The multi-stream generator plays several generators concurrently
+ * from a single traffic generator. Each stream keeps its own timing,
+ * and packets are issued in the order of the streams' next packet
+ * ticks, so that many independent access streams can be driven
+ * through one port and one outstanding request table.
+ */
+class MultiGen : public BaseGen
+{
+
+  public:
+
+    /**
+     * Create a multi-stream generator.
+     *
+     * @param obj SimObject owning this generator
+     * @param master_id MasterID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param streams Generators to play concurrently
+     */
+    MultiGen(SimObject &obj, MasterID master_id, Tick _duration,
+             const std::vector<std::shared_ptr<BaseGen>> &streams);
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    void exit();
+
+    /**
+     * Returns the earliest next packet tick of all the streams, or
+     * MaxTick if none of them has anything left to send.
+     */
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  private:
+
+    /** Next packet tick and index of a stream */
+    typedef std::pair<Tick, unsigned> StreamTick;
+
+    /** The generators played concurrently */
+    const std::vector<std::shared_ptr<BaseGen>> streams;
+
+    /**
+     * Streams with a packet to send, ordered by their next packet
+     * tick. This is mutable as the stream that sent the last packet
+     * is only put back when its next tick is asked for.
+     */
+    mutable std::priority_queue<StreamTick, std::vector<StreamTick>,
+                                std::greater<StreamTick>> pending;
+
+    /**
+     * Index of the stream that sent the last packet and is not in the
+     * pending queue, or -1 if there is none.
+     */
+    mutable int lastStream;
+};
+
+#endif
@@ -45,17 +45,30 @@
 #include "proto/packet.pb.h"
 
 TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+    : bufferPos(0)
 {
+    buffer.reserve(bufferSize);
+    if (PacketTraceStream::isPacketTrace(filename))
+        binaryTrace.reset(new PacketTraceInputStream(filename));
+    else
+        trace.reset(new ProtoInputStream(filename));
     init();
 }
 
 void
 TraceGen::InputStream::init()
 {
+    if (binaryTrace) {
+        if (binaryTrace->tickFrequency() != SimClock::Frequency) {
+            panic("Trace was recorded with a different tick frequency %d\n",
+                  binaryTrace->tickFrequency());
+        }
+        return;
+    }
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from trace\n");
     } else if (header_msg.tick_freq() != SimClock::Frequency) {
         panic("Trace was recorded with a different tick frequency %d\n",
@@ -66,20 +79,59 @@ TraceGen::InputStream::init()
 void
 TraceGen::InputStream::reset()
 {
-    trace.reset();
+    buffer.clear();
+    bufferPos = 0;
+    if (binaryTrace)
+        binaryTrace->reset();
+    else
+        trace->reset();
     init();
 }
 
 bool
 TraceGen::InputStream::read(TraceElement& element)
 {
+    if (bufferPos == buffer.size()) {
+        buffer.resize(bufferSize);
+        size_t decoded = 0;
+        while (decoded < bufferSize && decode(buffer[decoded]))
+            ++decoded;
+        buffer.resize(decoded);
+        bufferPos = 0;
+
+        if (buffer.empty())
+            return false;
+    }
+
+    element = buffer[bufferPos++];
+    return true;
+}
+
+bool
+TraceGen::InputStream::decode(TraceElement& element)
+{
+    if (binaryTrace) {
+        PacketTraceRecord record;
+        if (!binaryTrace->read(record))
+            return false;
+
+        element.cmd = record.cmd;
+        element.addr = record.addr;
+        element.blocksize = record.size;
+        element.tick = record.tick;
+        element.flags = record.flags;
+        element.pc = record.pc;
+        return true;
+    }
+
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         element.cmd = pkt_msg.cmd();
         element.addr = pkt_msg.addr();
         element.blocksize = pkt_msg.size();
         element.tick = pkt_msg.tick();
         element.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+        element.pc = pkt_msg.has_pc() ? pkt_msg.pc() : 0;
         return true;
     }
 
@@ -148,6 +200,11 @@ TraceGen::getNextPacket()
                               currElement.blocksize,
                               currElement.cmd, currElement.flags);
 
+    // replay the PC of traces captured with it, so that PC-based
+    // prefetchers see the original access streams
+    if (currElement.pc)
+        pkt->req->setPC(currElement.pc);
+
     if (!traceComplete)
         DPRINTF(TrafficGen, "nextElement: %c addr %d size %d tick %d (%d)\n",
                 nextElement.cmd.isRead() ? 'r' : 'w',
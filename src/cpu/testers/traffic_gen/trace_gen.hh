@@ -44,10 +44,14 @@
 #ifndef __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 #define __CPU_TRAFFIC_GEN_TRACE_GEN_HH__
 
+#include <memory>
+#include <vector>
+
 #include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "base_gen.hh"
 #include "mem/packet.hh"
+#include "mem/packet_trace.hh"
 #include "proto/protoio.hh"
 
 /**
@@ -80,6 +84,9 @@ class TraceGen : public BaseGen
         /** Potential request flags to use */
         Request::FlagsType flags;
 
+        /** PC of the instruction issuing the request, zero if unknown */
+        Addr pc;
+
         /**
          * Check validity of this element.
          *
@@ -108,12 +115,34 @@ class TraceGen : public BaseGen
       private:
 
         /// Input file stream for the protobuf trace
-        ProtoInputStream trace;
+        std::unique_ptr<ProtoInputStream> trace;
+
+        /// Input stream for binary traces, used instead of trace
+        std::unique_ptr<PacketTraceInputStream> binaryTrace;
+
+        /// Number of elements decoded ahead of their use
+        static const size_t bufferSize = 4096;
+
+        /// Elements decoded ahead of their use
+        std::vector<TraceElement> buffer;
+
+        /// Position of the next element to hand out from the buffer
+        size_t bufferPos;
+
+        /**
+         * Decode a single trace element from the file.
+         *
+         * @param element Trace element to populate
+         * @return True if an element could be decoded successfully
+         */
+        bool decode(TraceElement& element);
 
       public:
 
         /**
-         * Create a trace input stream for a given file name.
+         * Create a trace input stream for a given file name. Both
+         * protobuf and binary packet traces are supported, the format
+         * is detected from the file contents.
          *
          * @param filename Path to the file to read from
          */
@@ -134,7 +163,9 @@ class TraceGen : public BaseGen
         /**
          * Attempt to read a trace element from the stream,
          * and also notify the caller if the end of the file
-         * was reached.
+         * was reached. Elements are decoded from the file in
+         * batches, so that replay does not alternate between
+         * parsing and issuing packets for every element.
          *
          * @param element Trace element to populate
          * @return True if an element could be read successfully
@@ -181,6 +181,21 @@ TrafficGen::parseConfig()
                 } else if (mode == "EXIT") {
                     states[id] = createExit(duration);
                     DPRINTF(TrafficGen, "State: %d ExitGen\n", id);
+                } else if (mode == "MULTI") {
+                    // play previously defined states concurrently
+                    vector<shared_ptr<BaseGen>> streams;
+                    uint32_t stream_id;
+                    while (is >> stream_id) {
+                        auto stream = states.find(stream_id);
+                        if (stream == states.end())
+                            fatal("%s: Unknown stream state %d in state "
+                                  "%d\n", name(), stream_id, id);
+                        streams.push_back(stream->second);
+                    }
+
+                    states[id] = createMulti(duration, streams);
+                    DPRINTF(TrafficGen, "State: %d MultiGen with %d "
+                            "streams\n", id, streams.size());
                 } else if (mode == "LINEAR" || mode == "RANDOM" ||
                            mode == "DRAM"   || mode == "DRAM_ROTATE") {
                     uint32_t read_percent;
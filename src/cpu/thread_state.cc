@@ -110,6 +110,7 @@ ThreadState::initMemProxies(ThreadContext *tc)
         // getSendFunctional is a virtual function
         physProxy = new PortProxy(baseCpu->getSendFunctional(),
                                   baseCpu->cacheLineSize());
+        physProxy->setBackdoorFunc(baseCpu->getBackdoorFunc());
 
         assert(virtProxy == NULL);
         virtProxy = new TranslatingPortProxy(tc);
@@ -1461,11 +1461,21 @@ TraceCPU::ElasticDataGen::GraphNode::typeToStr() const
 }
 
 TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
 {
+    if (PacketTraceStream::isPacketTrace(filename)) {
+        binaryTrace.reset(new PacketTraceInputStream(filename));
+        if (binaryTrace->tickFrequency() != SimClock::Frequency) {
+            panic("Trace %s was recorded with a different tick frequency %d\n",
+                  filename, binaryTrace->tickFrequency());
+        }
+        return;
+    }
+
+    trace.reset(new ProtoInputStream(filename));
+
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
-    if (!trace.read(header_msg)) {
+    if (!trace->read(header_msg)) {
         panic("Failed to read packet header from %s\n", filename);
 
         if (header_msg.tick_freq() != SimClock::Frequency) {
@@ -1478,14 +1488,31 @@ TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
 void
 TraceCPU::FixedRetryGen::InputStream::reset()
 {
-    trace.reset();
+    if (binaryTrace)
+        binaryTrace->reset();
+    else
+        trace->reset();
 }
 
 bool
 TraceCPU::FixedRetryGen::InputStream::read(TraceElement* element)
 {
+    if (binaryTrace) {
+        PacketTraceRecord record;
+        if (!binaryTrace->read(record))
+            return false;
+
+        element->cmd = record.cmd;
+        element->addr = record.addr;
+        element->blocksize = record.size;
+        element->tick = record.tick;
+        element->flags = record.flags;
+        element->pc = record.pc;
+        return true;
+    }
+
     ProtoMessage::Packet pkt_msg;
-    if (trace.read(pkt_msg)) {
+    if (trace->read(pkt_msg)) {
         element->cmd = pkt_msg.cmd();
         element->addr = pkt_msg.addr();
         element->blocksize = pkt_msg.size();
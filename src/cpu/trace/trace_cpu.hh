@@ -40,6 +40,7 @@
 
 #include <array>
 #include <cstdint>
+#include <memory>
 #include <queue>
 #include <set>
 #include <unordered_map>
@@ -49,6 +50,7 @@
 #include "cpu/base.hh"
 #include "debug/TraceCPUData.hh"
 #include "debug/TraceCPUInst.hh"
+#include "mem/packet_trace.hh"
 #include "params/TraceCPU.hh"
 #include "proto/inst_dep_record.pb.h"
 #include "proto/packet.pb.h"
@@ -392,12 +394,16 @@ class TraceCPU : public BaseCPU
           private:
 
             // Input file stream for the protobuf trace
-            ProtoInputStream trace;
+            std::unique_ptr<ProtoInputStream> trace;
+
+            // Input stream for binary traces, used instead of trace
+            std::unique_ptr<PacketTraceInputStream> binaryTrace;
 
           public:
 
             /**
-             * Create a trace input stream for a given file name.
+             * Create a trace input stream for a given file name. Both
+             * protobuf and binary packet traces are supported.
              *
              * @param filename Path to the file to read from
              */
@@ -63,6 +63,8 @@ class EtherLink(SimObject):
     speed = Param.NetworkBandwidth('1Gbps', "link speed")
     dump = Param.EtherDump(NULL, "dump object")
 
+class DistTransport(Enum): vals = ['tcp', 'shm']
+
 class DistEtherLink(SimObject):
     type = 'DistEtherLink'
     cxx_header = "dev/net/dist_etherlink.hh"
@@ -75,6 +77,15 @@ class DistEtherLink(SimObject):
     dist_size = Param.UInt32('1', "Number of gem5 processes (dist run)")
     sync_start = Param.Latency('5200000000000t', "first dist sync barrier")
     sync_repeat = Param.Latency('10us', "dist sync barrier repeat")
+    # The sync quantum doubles after every quantum without any packet sent
+    # (up to this limit) and drops back to sync_repeat on traffic. A packet
+    # sent in a grown quantum is delivered at the end of that quantum at the
+    # earliest, i.e. up to sync_repeat_max - delay later than with a fixed
+    # quantum (see the deferredPackets and deferredTicks stats).
+    sync_repeat_max = Param.Latency('0us', "upper bound for the adaptive "
+                                    "dist sync quantum (0: not adaptive)")
+    transport = Param.DistTransport('tcp', "message transport among the "
+                                    "gem5 processes (shm: same host only)")
     server_name = Param.String('localhost', "Message server name")
     server_port = Param.UInt32('2200', "Message server port")
     is_switch = Param.Bool(False, "true if this a link in etherswitch")
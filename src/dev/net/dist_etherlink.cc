@@ -60,6 +60,7 @@
 #include "dev/net/etherint.hh"
 #include "dev/net/etherlink.hh"
 #include "dev/net/etherpkt.hh"
+#include "dev/net/shm_iface.hh"
 #include "dev/net/tcp_iface.hh"
 #include "params/EtherLink.hh"
 #include "sim/core.hh"
@@ -69,7 +70,7 @@
 using namespace std;
 
 DistEtherLink::DistEtherLink(const Params *p)
-    : SimObject(p), linkDelay(p->delay)
+    : SimObject(p), linkDelay(p->delay), stats(*this)
 {
     DPRINTF(DistEthernet,"DistEtherLink::DistEtherLink() "
             "link delay:%llu ticksPerByte:%f\n", p->delay, p->speed);
@@ -88,12 +89,27 @@ DistEtherLink::DistEtherLink(const Params *p)
         sync_repeat = p->delay;
     }
 
-    // create the dist (TCP) interface to talk to the peer gem5 processes.
-    distIface = new TCPIface(p->server_name, p->server_port,
-                             p->dist_rank, p->dist_size,
-                             p->sync_start, sync_repeat, this,
-                             p->dist_sync_on_pseudo_op, p->is_switch,
-                             p->num_nodes);
+    Tick sync_repeat_max = p->sync_repeat_max;
+    if (sync_repeat_max != 0 && sync_repeat_max < sync_repeat)
+        fatal("DistEtherLink(): sync_repeat_max (%lu) must not be smaller "
+              "than sync_repeat (%lu)", sync_repeat_max, sync_repeat);
+
+    // create the dist interface to talk to the peer gem5 processes.
+    if (p->transport == Enums::shm) {
+        distIface = new ShmIface(p->server_name, p->server_port,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat,
+                                 sync_repeat_max, this,
+                                 p->dist_sync_on_pseudo_op, p->is_switch,
+                                 p->num_nodes);
+    } else {
+        distIface = new TCPIface(p->server_name, p->server_port,
+                                 p->dist_rank, p->dist_size,
+                                 p->sync_start, sync_repeat,
+                                 sync_repeat_max, this,
+                                 p->dist_sync_on_pseudo_op, p->is_switch,
+                                 p->num_nodes);
+    }
 
     localIface = new LocalIface(name() + ".int0", txLink, rxLink, distIface);
 }
@@ -130,6 +146,29 @@ DistEtherLink::unserialize(CheckpointIn &cp)
     rxLink->unserializeSection(cp, "rxLink");
 }
 
+DistEtherLink::DistEtherLinkStats::DistEtherLinkStats(DistEtherLink &link)
+    : Stats::Group(&link),
+    ADD_STAT(deferredPackets, "Number of received packets deferred to the "
+             "end of an adaptive sync quantum"),
+    ADD_STAT(deferredTicks, "Total number of ticks received packets were "
+             "deferred by")
+{
+    deferredPackets.method(&link, &DistEtherLink::deferredPackets);
+    deferredTicks.method(&link, &DistEtherLink::deferredTicks);
+}
+
+uint64_t
+DistEtherLink::deferredPackets() const
+{
+    return distIface->deferredPackets();
+}
+
+uint64_t
+DistEtherLink::deferredTicks() const
+{
+    return distIface->deferredTicks();
+}
+
 void
 DistEtherLink::init()
 {
@@ -184,7 +223,7 @@ DistEtherLink::TxLink::txDone()
 }
 
 bool
-DistEtherLink::TxLink::transmit(EthPacketPtr pkt)
+DistEtherLink::TxLink::transmit(const EthPacketPtr &pkt)
 {
     if (busy()) {
         DPRINTF(DistEthernet, "packet not sent, link busy\n");
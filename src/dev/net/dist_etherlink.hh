@@ -50,6 +50,7 @@
 
 #include <iostream>
 
+#include "base/statistics.hh"
 #include "dev/net/etherlink.hh"
 #include "params/DistEtherLink.hh"
 
@@ -136,7 +137,7 @@ class DistEtherLink : public SimObject
          *
          * @param packet Ethernet packet to send
          */
-        bool transmit(EthPacketPtr packet);
+        bool transmit(const EthPacketPtr &packet);
     };
 
     /**
@@ -187,7 +188,8 @@ class DistEtherLink : public SimObject
         LocalIface(const std::string &name, TxLink *tx, RxLink *rx,
                    DistIface *m);
 
-        bool recvPacket(EthPacketPtr pkt) { return txLink->transmit(pkt); }
+        bool recvPacket(const EthPacketPtr &pkt)
+        { return txLink->transmit(pkt); }
         void sendDone() { peer->sendDone(); }
         bool isBusy() { return txLink->busy(); }
     };
@@ -210,6 +212,19 @@ class DistEtherLink : public SimObject
 
     Tick linkDelay;
 
+    struct DistEtherLinkStats : public Stats::Group
+    {
+        DistEtherLinkStats(DistEtherLink &link);
+
+        /** Packets delivered late due to an adaptive sync quantum */
+        Stats::Value deferredPackets;
+        /** Ticks the late packets were deferred by in total */
+        Stats::Value deferredTicks;
+    } stats;
+
+    uint64_t deferredPackets() const;
+    uint64_t deferredTicks() const;
+
   public:
     typedef DistEtherLinkParams Params;
     DistEtherLink(const Params *p);
@@ -41,6 +41,7 @@
 
 #include "dev/net/dist_iface.hh"
 
+#include <algorithm>
 #include <queue>
 #include <thread>
 
@@ -62,9 +63,11 @@ unsigned DistIface::distIfaceNum = 0;
 unsigned DistIface::recvThreadsNum = 0;
 DistIface *DistIface::master = nullptr;
 bool DistIface::isSwitch = false;
+bool DistIface::adaptiveSync = false;
+std::atomic<bool> DistIface::linkActive(false);
 
 void
-DistIface::Sync::init(Tick start_tick, Tick repeat_tick)
+DistIface::Sync::init(Tick start_tick, Tick repeat_tick, Tick repeat_max)
 {
     if (start_tick < nextAt) {
         nextAt = start_tick;
@@ -79,6 +82,27 @@ DistIface::Sync::init(Tick start_tick, Tick repeat_tick)
         inform("Dist synchronisation interval is changed to %lu.\n",
                nextRepeat);
     }
+    baseRepeat = nextRepeat;
+
+    // Every link must agree on the quantum growth so we use the smallest
+    // upper bound. A zero upper bound disables adaptation for this link.
+    Tick max_tick = std::max(repeat_max, repeat_tick);
+    if (max_tick < maxRepeat)
+        maxRepeat = max_tick;
+    if (maxRepeat < baseRepeat)
+        maxRepeat = baseRepeat;
+}
+
+Tick
+DistIface::Sync::proposeRepeat(bool grow)
+{
+    // Any packet sent in the last quantum means the links are busy. Drop
+    // back to the base quantum so that the following packets can be
+    // delivered exactly on time.
+    bool active = DistIface::linkActive.exchange(false);
+    if (!grow || active || !adaptive())
+        return baseRepeat;
+    return std::min(nextRepeat * 2, maxRepeat);
 }
 
 void
@@ -103,6 +127,9 @@ DistIface::SyncSwitch::SyncSwitch(int num_nodes)
     doStopSync = false;
     nextAt = std::numeric_limits<Tick>::max();
     nextRepeat = std::numeric_limits<Tick>::max();
+    baseRepeat = std::numeric_limits<Tick>::max();
+    maxRepeat = std::numeric_limits<Tick>::max();
+    reqRepeat = std::numeric_limits<Tick>::max();
     isAbort = false;
 }
 
@@ -117,6 +144,8 @@ DistIface::SyncNode::SyncNode()
     doStopSync = false;
     nextAt = std::numeric_limits<Tick>::max();
     nextRepeat = std::numeric_limits<Tick>::max();
+    baseRepeat = std::numeric_limits<Tick>::max();
+    maxRepeat = std::numeric_limits<Tick>::max();
     isAbort = false;
 }
 
@@ -132,7 +161,7 @@ DistIface::SyncNode::run(bool same_tick)
     // initiate the global synchronisation
     header.msgType = MsgType::cmdSyncReq;
     header.sendTick = curTick();
-    header.syncRepeat = nextRepeat;
+    header.syncRepeat = proposeRepeat(same_tick);
     header.needCkpt = needCkpt;
     header.needStopSync = needStopSync;
     if (needCkpt != ReqType::none)
@@ -170,6 +199,10 @@ DistIface::SyncSwitch::run(bool same_tick)
     // Complete the global synchronisation
     header.msgType = MsgType::cmdSyncAck;
     header.sendTick = nextAt;
+    // The switch forwards all the packets so it has its own say about the
+    // link activity, too.
+    nextRepeat = std::min(reqRepeat, proposeRepeat(same_tick));
+    reqRepeat = std::numeric_limits<Tick>::max();
     header.syncRepeat = nextRepeat;
     if (doCkpt || numCkptReq == numNodes) {
         doCkpt = true;
@@ -209,8 +242,8 @@ DistIface::SyncSwitch::progress(Tick send_tick,
 
     if (send_tick > nextAt)
         nextAt = send_tick;
-    if (nextRepeat > sync_repeat)
-        nextRepeat = sync_repeat;
+    if (reqRepeat > sync_repeat)
+        reqRepeat = sync_repeat;
 
     if (need_ckpt == ReqType::collective)
         numCkptReq++;
@@ -423,6 +456,9 @@ DistIface::SyncEvent::process()
         return;
     }
     // schedule the next periodic sync
+    if (repeat != DistIface::sync->nextRepeat)
+        DPRINTF(DistEthernet, "Dist sync quantum changed from %lu to %lu\n",
+                repeat, DistIface::sync->nextRepeat);
     repeat = DistIface::sync->nextRepeat;
     schedule(curTick() + repeat);
 }
@@ -442,9 +478,27 @@ DistIface::RecvScheduler::init(Event *recv_done, Tick link_delay)
 Tick
 DistIface::RecvScheduler::calcReceiveTick(Tick send_tick,
                                           Tick send_delay,
-                                          Tick prev_recv_tick)
+                                          Tick prev_recv_tick,
+                                          Tick min_tick)
 {
     Tick recv_tick = send_tick + send_delay + linkDelay;
+    if (DistIface::adaptiveSync) {
+        // The packet may have been sent in a quantum longer than the link
+        // delay so it can be late. Defer it to the earliest tick we can
+        // still deliver it at deterministically.
+        Tick late_tick = std::max(min_tick, prev_recv_tick + send_delay);
+        if (recv_tick < late_tick) {
+            DPRINTF(DistEthernetPkt, "Late packet deferred by %llu ticks\n",
+                    late_tick - recv_tick);
+            lateCount++;
+            lateTicks += late_tick - recv_tick;
+            recv_tick = late_tick;
+        }
+        panic_if(recv_tick < curTick(),
+                 "Simulators out of sync - missed packet receive by %llu "
+                 "ticks", curTick() - recv_tick);
+        return recv_tick;
+    }
     // sanity check (we need atleast a send delay long window)
     assert(recv_tick >= prev_recv_tick + send_delay);
     panic_if(prev_recv_tick + send_delay > recv_tick,
@@ -499,7 +553,10 @@ DistIface::RecvScheduler::pushPacket(EthPacketPtr new_packet,
 {
     // Note : this is called from the receiver thread
     curEventQueue()->lock();
-    Tick recv_tick = calcReceiveTick(send_tick, send_delay, prevRecvTick);
+    // A late packet is delivered at the end of the current quantum at the
+    // earliest (see comments in dist_iface.hh).
+    Tick recv_tick = calcReceiveTick(send_tick, send_delay, prevRecvTick,
+                                     master->syncEvent->when());
 
     DPRINTF(DistEthernetPkt, "DistIface::recvScheduler::pushPacket "
             "send_tick:%llu send_delay:%llu link_delay:%llu recv_tick:%llu\n",
@@ -508,7 +565,8 @@ DistIface::RecvScheduler::pushPacket(EthPacketPtr new_packet,
     assert(send_tick > master->syncEvent->when() -
            master->syncEvent->repeat);
     // No packet may be scheduled for receive in the arrival quantum
-    assert(send_tick + send_delay + linkDelay > master->syncEvent->when());
+    assert(DistIface::adaptiveSync ||
+           send_tick + send_delay + linkDelay > master->syncEvent->when());
 
     // Now we are about to schedule a recvDone event for the new data packet.
     // We use the same recvDone object for all incoming data packets. Packet
@@ -542,7 +600,7 @@ DistIface::RecvScheduler::popPacket()
     if (descQueue.size() > 0) {
         Tick recv_tick = calcReceiveTick(descQueue.front().sendTick,
                                          descQueue.front().sendDelay,
-                                         curTick());
+                                         curTick(), curTick());
         eventManager->schedule(recvDone, recv_tick);
     }
     prevRecvTick = curTick();
@@ -605,10 +663,12 @@ DistIface::DistIface(unsigned dist_rank,
                      unsigned dist_size,
                      Tick sync_start,
                      Tick sync_repeat,
+                     Tick sync_repeat_max,
                      EventManager *em,
                      bool use_pseudo_op,
                      bool is_switch, int num_nodes) :
     syncStart(sync_start), syncRepeat(sync_repeat),
+    syncRepeatMax(sync_repeat_max),
     recvThread(nullptr), recvScheduler(em), syncStartOnPseudoOp(use_pseudo_op),
     rank(dist_rank), size(dist_size)
 {
@@ -659,6 +719,8 @@ DistIface::packetOut(EthPacketPtr pkt, Tick send_delay)
     header.dataPacketLength = pkt->length;
     header.simLength = pkt->simLength;
 
+    linkActive = true;
+
     // Send out the packet and the meta info.
     sendPacket(header, pkt);
 
@@ -799,7 +861,8 @@ DistIface::init(const Event *done_event, Tick link_delay)
     // might have different requirements. The singleton sync object
     // will select the minimum values for both params.
     assert(sync != nullptr);
-    sync->init(syncStart, syncRepeat);
+    sync->init(syncStart, syncRepeat, syncRepeatMax);
+    adaptiveSync = sync->adaptive();
 
     // Initialize the seed for random generator to avoid the same sequence
     // in all gem5 peer processes
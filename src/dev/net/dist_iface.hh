@@ -66,16 +66,38 @@
  * transmission delay to ensure that a corresponding receive event can always
  * be scheduled for any message coming in from a peer gem5 process.
  *
- *
+ * The barrier interval (quantum) can optionally adapt to the network
+ * traffic. Each gem5 process proposes a quantum at every barrier: the base
+ * quantum (i.e. the link delay) if it sent any packet during the last
+ * quantum, otherwise twice the current quantum (up to a configured
+ * maximum). The smallest proposal wins, so the quantum grows while all the
+ * links are idle and drops back to the link delay as soon as any link
+ * carries traffic. A packet sent in a grown quantum may be due at the
+ * receiver earlier than the end of that quantum. Such packets are delivered
+ * at the end of the quantum (i.e. at the next barrier), which keeps every
+ * receive event in the future of the receiver and the delivery tick
+ * independent of the host timing. This is the accuracy cost of the
+ * adaptive quantum: a packet sent in a grown quantum can arrive up to
+ * the maximum quantum minus the link delay later than it would with a
+ * fixed quantum. Only packets sent in the first quantum after an idle
+ * period are affected, since every peer proposes the base quantum at
+ * the next barrier. The quantum cannot end at the first send instead:
+ * the peers may already have simulated past that tick when they learn
+ * about the packet, and all of them must meet at the same barrier tick.
+ * The number of deferred packets and ticks are reported by the
+ * DistEtherLink statistics so that the cost can be checked for a run.
  *
  * This interface is an abstract class. It can work with various low level
  * send/receive service implementations (e.g. TCP/IP, MPI,...). A TCP
- * stream socket version is implemented in src/dev/net/tcp_iface.[hh,cc].
+ * stream socket version is implemented in src/dev/net/tcp_iface.[hh,cc]
+ * and a shared memory version for gem5 processes running on the same host
+ * is implemented in src/dev/net/shm_iface.[hh,cc].
  */
 #ifndef __DEV_DIST_IFACE_HH__
 #define __DEV_DIST_IFACE_HH__
 
 #include <array>
+#include <atomic>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -147,6 +169,16 @@ class DistIface : public Drainable, public Serializable
          * The repeat value for the next periodic sync
          */
         Tick nextRepeat;
+        /**
+         * The smallest repeat value (i.e. the quantum used while there is
+         * network traffic)
+         */
+        Tick baseRepeat;
+        /**
+         * The largest repeat value the quantum may grow to while the
+         * links are idle
+         */
+        Tick maxRepeat;
         /**
          * Tick for the next periodic sync (if the event is not scheduled yet)
          */
@@ -164,9 +196,23 @@ class DistIface : public Drainable, public Serializable
          *
          * @param start Start tick for dist synchronisation
          * @param repeat Frequency of dist synchronisation
+         * @param repeat_max Upper bound for the adaptive sync quantum
+         * (0 disables adaptation)
+         *
+         */
+        void init(Tick start, Tick repeat, Tick repeat_max);
+        /**
+         * The repeat value this gem5 process asks for at the next sync.
          *
+         * @param grow True if the quantum may grow (i.e. this is a periodic
+         * sync)
          */
-        void init(Tick start, Tick repeat);
+        Tick proposeRepeat(bool grow);
+        /**
+         * True if the sync quantum is allowed to grow beyond the base
+         * repeat value.
+         */
+        bool adaptive() const { return maxRepeat > baseRepeat; }
         /**
          *  Core method to perform a full dist sync.
          *
@@ -254,6 +300,11 @@ class DistIface : public Drainable, public Serializable
          *  Number of connected simulated nodes
          */
         unsigned numNodes;
+        /**
+         * The smallest repeat value requested by the nodes for the on-going
+         * sync
+         */
+        Tick reqRepeat;
 
       public:
         SyncSwitch(int num_nodes);
@@ -391,6 +442,8 @@ class DistIface : public Drainable, public Serializable
          * @param send_delay The simulated delay at the sender side.
          * @param prev_recv_tick Tick when the last receive event was
          * processed.
+         * @param min_tick The earliest tick a late packet may be delivered
+         * at (used only with an adaptive sync quantum).
          *
          * @note This method tries to take into account possible receiver link
          * contention and adjust receive tick for the incoming packets
@@ -398,13 +451,23 @@ class DistIface : public Drainable, public Serializable
          */
         Tick calcReceiveTick(Tick send_tick,
                              Tick send_delay,
-                             Tick prev_recv_tick);
+                             Tick prev_recv_tick,
+                             Tick min_tick);
 
         /**
          * Flag to set if receive ticks for pending packets need to be
          * recalculated due to changed link latencies at a resume
          */
         bool ckptRestore;
+        /**
+         * Number of packets delivered later than their due tick because
+         * they were sent in a grown (adaptive) sync quantum.
+         */
+        std::atomic<uint64_t> lateCount;
+        /**
+         * Total number of ticks late packets were deferred by.
+         */
+        std::atomic<uint64_t> lateTicks;
 
       public:
         /**
@@ -415,7 +478,8 @@ class DistIface : public Drainable, public Serializable
          */
         RecvScheduler(EventManager *em) :
             prevRecvTick(0), recvDone(nullptr), linkDelay(0),
-            eventManager(em), ckptRestore(false) {}
+            eventManager(em), ckptRestore(false), lateCount(0),
+            lateTicks(0) {}
 
         /**
          *  Initialize network link parameters.
@@ -432,6 +496,14 @@ class DistIface : public Drainable, public Serializable
          * done event associated with the network link.
          */
         EthPacketPtr popPacket();
+        /**
+         * Number of packets deferred by an adaptive sync quantum.
+         */
+        uint64_t latePackets() const { return lateCount; }
+        /**
+         * Total number of ticks packets were deferred by.
+         */
+        uint64_t lateDelay() const { return lateTicks; }
         /**
          * Push a newly arrived packet into the desc queue.
          */
@@ -459,6 +531,10 @@ class DistIface : public Drainable, public Serializable
      * Frequency of dist sync events in ticks.
      */
     Tick syncRepeat;
+    /**
+     * Upper bound for the adaptive sync quantum in ticks.
+     */
+    Tick syncRepeatMax;
     /**
      * Receiver thread pointer.
      * Each DistIface object must have exactly one receiver thread.
@@ -519,6 +595,14 @@ class DistIface : public Drainable, public Serializable
      * Is this node a switch?
      */
      static bool isSwitch;
+    /**
+     * Is the sync quantum adaptive?
+     */
+    static bool adaptiveSync;
+    /**
+     * Flag is set if any data packet was sent out since the last sync.
+     */
+    static std::atomic<bool> linkActive;
 
   private:
     /**
@@ -569,12 +653,14 @@ class DistIface : public Drainable, public Serializable
      * @param dist_rank Rank of this gem5 process within the dist run
      * @param sync_start Start tick for dist synchronisation
      * @param sync_repeat Frequency for dist synchronisation
+     * @param sync_repeat_max Upper bound for the adaptive sync quantum
      * @param em The event manager associated with the simulated Ethernet link
      */
     DistIface(unsigned dist_rank,
               unsigned dist_size,
               Tick sync_start,
               Tick sync_repeat,
+              Tick sync_repeat_max,
               EventManager *em,
               bool use_pseudo_op,
               bool is_switch,
@@ -596,6 +682,15 @@ class DistIface : public Drainable, public Serializable
      * receive queue is not empty.
      */
     EthPacketPtr packetIn() { return recvScheduler.popPacket(); }
+    /**
+     * Number of incoming packets that were deferred to the end of a grown
+     * sync quantum.
+     */
+    uint64_t deferredPackets() const { return recvScheduler.latePackets(); }
+    /**
+     * Total number of ticks the incoming packets were deferred by.
+     */
+    uint64_t deferredTicks() const { return recvScheduler.lateDelay(); }
 
     DrainState drain() override;
     void drainResume() override;
@@ -89,7 +89,7 @@ EtherDump::init()
 }
 
 void
-EtherDump::dumpPacket(EthPacketPtr &packet)
+EtherDump::dumpPacket(const EthPacketPtr &packet)
 {
     pcap_pkthdr pkthdr;
     pkthdr.seconds = curTick() / SimClock::Int::s;
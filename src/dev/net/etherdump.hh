@@ -47,14 +47,14 @@ class EtherDump : public SimObject
   private:
     std::ostream *stream;
     const unsigned maxlen;
-    void dumpPacket(EthPacketPtr &packet);
+    void dumpPacket(const EthPacketPtr &packet);
     void init();
 
   public:
     typedef EtherDumpParams Params;
     EtherDump(const Params *p);
 
-    inline void dump(EthPacketPtr &pkt) { dumpPacket(pkt); }
+    inline void dump(const EthPacketPtr &pkt) { dumpPacket(pkt); }
 };
 
 #endif // __DEV_NET_ETHERDUMP_HH__
@@ -67,9 +67,9 @@ class EtherInt : public Port
     void recvDone() { peer->sendDone(); }
     virtual void sendDone() = 0;
 
-    bool sendPacket(EthPacketPtr packet)
+    bool sendPacket(const EthPacketPtr &packet)
     { return peer ? peer->recvPacket(packet) : true; }
-    virtual bool recvPacket(EthPacketPtr packet) = 0;
+    virtual bool recvPacket(const EthPacketPtr &packet) = 0;
 
     bool askBusy() {return peer->isBusy(); }
     virtual bool isBusy() { return false; }
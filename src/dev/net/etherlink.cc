@@ -126,7 +126,7 @@ EtherLink::unserialize(CheckpointIn &cp)
 }
 
 void
-EtherLink::Link::txComplete(EthPacketPtr packet)
+EtherLink::Link::txComplete(const EthPacketPtr &packet)
 {
     DPRINTF(Ethernet, "packet received: len=%d\n", packet->length);
     DDUMP(EthernetData, packet->data, packet->length);
@@ -173,7 +173,7 @@ EtherLink::Link::processTxQueue()
 }
 
 bool
-EtherLink::Link::transmit(EthPacketPtr pkt)
+EtherLink::Link::transmit(const EthPacketPtr &pkt)
 {
     if (busy()) {
         DPRINTF(Ethernet, "packet not sent, link busy\n");
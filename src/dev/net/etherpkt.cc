@@ -29,6 +29,8 @@
 #include "dev/net/etherpkt.hh"
 
 #include <iostream>
+#include <mutex>
+#include <vector>
 
 #include "base/inet.hh"
 #include "base/logging.hh"
@@ -36,6 +38,96 @@
 
 using namespace std;
 
+namespace {
+
+/**
+ * Free lists of packet buffers for power of two size classes between
+ * MinClassSize and MaxClassSize bytes. Packets may be allocated by a dist
+ * receiver thread and freed by the simulation thread so the free lists
+ * are protected by a lock.
+ */
+class BufferPool
+{
+  private:
+    static const unsigned MinClassShift = 11;
+    static const unsigned MaxClassShift = 14;
+    static const unsigned NumClasses = MaxClassShift - MinClassShift + 1;
+    /** Upper bound of buffers kept around per size class. */
+    static const size_t MaxFree = 256;
+
+    std::mutex lock;
+    std::vector<uint8_t *> freeList[NumClasses];
+
+    static int
+    sizeClass(unsigned size)
+    {
+        for (unsigned c = 0; c < NumClasses; c++) {
+            if (size <= (1U << (MinClassShift + c)))
+                return c;
+        }
+        return -1;
+    }
+
+  public:
+    uint8_t *
+    alloc(unsigned size)
+    {
+        int c = sizeClass(size);
+        if (c < 0)
+            return new uint8_t[size];
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (!freeList[c].empty()) {
+                uint8_t *buf = freeList[c].back();
+                freeList[c].pop_back();
+                return buf;
+            }
+        }
+        return new uint8_t[1U << (MinClassShift + c)];
+    }
+
+    void
+    free(uint8_t *buf, unsigned size)
+    {
+        // The buffer length of a packet may only shrink (see
+        // EthPacketData::unserialize()) so the buffer is at least as large
+        // as the size class we put it back to.
+        int c = sizeClass(size);
+        if (c >= 0) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (freeList[c].size() < MaxFree) {
+                freeList[c].push_back(buf);
+                return;
+            }
+        }
+        delete [] buf;
+    }
+};
+
+// Packets may outlive static objects at exit so the pool is never
+// destroyed.
+BufferPool &
+bufferPool()
+{
+    static BufferPool *pool = new BufferPool();
+    return *pool;
+}
+
+} // anonymous namespace
+
+uint8_t *
+EthPacketData::allocBuffer(unsigned size)
+{
+    return bufferPool().alloc(size);
+}
+
+void
+EthPacketData::freeBuffer(uint8_t *buf, unsigned size)
+{
+    bufferPool().free(buf, size);
+}
+
 void
 EthPacketData::serialize(const string &base, CheckpointOut &cp) const
 {
@@ -64,7 +156,7 @@ EthPacketData::unserialize(const string &base, CheckpointIn &cp)
     }
     assert(length <= bufLength);
     if (!data)
-        data = new uint8_t[bufLength];
+        data = allocBuffer(bufLength);
     arrayParamIn(cp, base + ".data", data, length);
     if (!optParamIn(cp, base + ".simLength", simLength))
         simLength = length;
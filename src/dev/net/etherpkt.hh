@@ -45,6 +45,20 @@
  */
 class EthPacketData
 {
+  private:
+    /**
+     * Get a data buffer of at least size bytes. Buffers up to the
+     * largest pool size class are recycled through a free list so that
+     * the NICs (which allocate a maximum size buffer for every packet
+     * they send) do not go through the heap for every packet.
+     */
+    static uint8_t *allocBuffer(unsigned size);
+
+    /**
+     * Return a buffer allocated by allocBuffer() with the same size.
+     */
+    static void freeBuffer(uint8_t *buf, unsigned size);
+
   public:
     /**
      * Pointer to packet data will be deleted
@@ -75,10 +89,13 @@ class EthPacketData
     { }
 
     explicit EthPacketData(unsigned size)
-        : data(new uint8_t[size]), bufLength(size), length(0), simLength(0)
+        : data(allocBuffer(size)), bufLength(size), length(0), simLength(0)
     { }
 
-    ~EthPacketData() { if (data) delete [] data; }
+    ~EthPacketData() { if (data) freeBuffer(data, bufLength); }
+
+    EthPacketData(const EthPacketData &) = delete;
+    EthPacketData &operator=(const EthPacketData &) = delete;
 
     void serialize(const std::string &base, CheckpointOut &cp) const;
     void unserialize(const std::string &base, CheckpointIn &cp);
@@ -166,7 +166,7 @@ EtherTapBase::getPort(const std::string &if_name, PortID idx)
 }
 
 bool
-EtherTapBase::recvSimulated(EthPacketPtr packet)
+EtherTapBase::recvSimulated(const EthPacketPtr &packet)
 {
     if (dump)
         dump->dump(packet);
@@ -2230,7 +2230,7 @@ IGbE::txStateMachine()
 }
 
 bool
-IGbE::ethRxPkt(EthPacketPtr pkt)
+IGbE::ethRxPkt(const EthPacketPtr &pkt)
 {
     rxBytes += pkt->length;
     rxPackets++;
@@ -527,7 +527,7 @@ class IGbE : public EtherDevice
 
     Tick writeConfig(PacketPtr pkt) override;
 
-    bool ethRxPkt(EthPacketPtr packet);
+    bool ethRxPkt(const EthPacketPtr &packet);
     void ethTxDone();
 
     void serialize(CheckpointOut &cp) const override;
@@ -548,7 +548,8 @@ class IGbEInt : public EtherInt
         : EtherInt(name), dev(d)
     { }
 
-    virtual bool recvPacket(EthPacketPtr pkt) { return dev->ethRxPkt(pkt); }
+    virtual bool recvPacket(const EthPacketPtr &pkt)
+    { return dev->ethRxPkt(pkt); }
     virtual void sendDone() { dev->ethTxDone(); }
 };
 
@@ -1946,7 +1946,7 @@ NSGigE::rxFilter(const EthPacketPtr &packet)
 }
 
 bool
-NSGigE::recvPacket(EthPacketPtr packet)
+NSGigE::recvPacket(const EthPacketPtr &packet)
 {
     rxBytes += packet->length;
     rxPackets++;
@@ -345,7 +345,7 @@ class NSGigE : public EtherDevBase
     bool cpuIntrPending() const;
     void cpuIntrAck() { cpuIntrClear(); }
 
-    bool recvPacket(EthPacketPtr packet);
+    bool recvPacket(const EthPacketPtr &packet);
     void transferDone();
 
     void serialize(CheckpointOut &cp) const override;
@@ -367,7 +367,8 @@ class NSGigEInt : public EtherInt
         : EtherInt(name), dev(d)
     { }
 
-    virtual bool recvPacket(EthPacketPtr pkt) { return dev->recvPacket(pkt); }
+    virtual bool recvPacket(const EthPacketPtr &pkt)
+    { return dev->recvPacket(pkt); }
     virtual void sendDone() { dev->transferDone(); }
 };
 
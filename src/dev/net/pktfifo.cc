@@ -42,17 +42,17 @@ PacketFifo::copyout(void *dest, unsigned offset, unsigned len)
     iterator i = fifo.begin();
     iterator end = fifo.end();
     while (len > 0) {
-        EthPacketPtr &pkt = i->packet;
-        while (offset >= pkt->length) {
-            offset -= pkt->length;
+        while (i != end && offset >= i->packet->length) {
+            offset -= i->packet->length;
             ++i;
         }
 
         if (i == end)
             panic("invalid fifo");
 
+        const EthPacketPtr &pkt = i->packet;
         unsigned size = min(pkt->length - offset, len);
-        memcpy(data, pkt->data, size);
+        memcpy(data, pkt->data + offset, size);
         offset = 0;
         len -= size;
         data += size;
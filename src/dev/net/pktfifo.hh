@@ -117,7 +117,7 @@ class PacketFifo
 
     EthPacketPtr front() { return fifo.begin()->packet; }
 
-    bool push(EthPacketPtr ptr)
+    bool push(const EthPacketPtr &ptr)
     {
         assert(ptr->length);
         assert(_reserved <= ptr->length);
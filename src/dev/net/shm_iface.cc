@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class implementation for dist-gem5 runs.
+ */
+
+#include "dev/net/shm_iface.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/types.hh"
+#include "debug/DistEthernet.hh"
+#include "debug/DistEthernetCmd.hh"
+#include "sim/sim_exit.hh"
+
+using namespace std;
+
+const size_t ShmIface::RingSize;
+vector<pair<ShmIface::Ring *, int> > ShmIface::ringRegistry;
+
+ShmIface::ShmIface(string server_name, unsigned server_port,
+                   unsigned dist_rank, unsigned dist_size,
+                   Tick sync_start, Tick sync_repeat, Tick sync_repeat_max,
+                   EventManager *em, bool use_pseudo_op, bool is_switch,
+                   int num_nodes) :
+    TCPIface(server_name, server_port, dist_rank, dist_size, sync_start,
+             sync_repeat, sync_repeat_max, em, use_pseudo_op, is_switch,
+             num_nodes),
+    segment(nullptr), txRing(nullptr), rxRing(nullptr)
+{
+}
+
+ShmIface::~ShmIface()
+{
+    if (!segment)
+        return;
+
+    // Let the peer know that we are gone (the peer may be blocked on
+    // either ring).
+    for (Ring *ring : { &segment->up, &segment->down }) {
+        if (!lockRing(ring))
+            continue;
+        ring->closed = true;
+        pthread_cond_broadcast(&ring->cond);
+        pthread_mutex_unlock(&ring->mutex);
+    }
+    munmap(segment, sizeof(Segment));
+    unlinkSegment();
+}
+
+void
+ShmIface::mapSegment(const string &name, bool create)
+{
+    int flags = create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR;
+    int fd = shm_open(name.c_str(), flags, S_IRUSR | S_IWUSR);
+    fatal_if(fd < 0, "Can't open shared memory segment %s: %s. All gem5 "
+             "processes must run on the same host for the shm dist "
+             "transport.", name, strerror(errno));
+    if (create)
+        segName = name;
+
+    if (create && ftruncate(fd, sizeof(Segment)) != 0) {
+        int err = errno;
+        unlinkSegment();
+        panic("ftruncate() failed on %s: %s", name, strerror(err));
+    }
+
+    void *ptr = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        int err = errno;
+        unlinkSegment();
+        panic("mmap() failed on %s: %s", name, strerror(err));
+    }
+    close(fd);
+    segment = static_cast<Segment *>(ptr);
+
+    if (!create)
+        return;
+
+    // The segment is zero filled so only the synchronisation primitives
+    // need an explicit init. The mutexes are robust so that a peer dying
+    // with a ring locked cannot block us forever.
+    pthread_mutexattr_t mutex_attr;
+    pthread_mutexattr_init(&mutex_attr);
+    pthread_mutexattr_setpshared(&mutex_attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutex_attr, PTHREAD_MUTEX_ROBUST);
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setpshared(&cond_attr, PTHREAD_PROCESS_SHARED);
+    for (Ring *ring : { &segment->up, &segment->down }) {
+        pthread_mutex_init(&ring->mutex, &mutex_attr);
+        pthread_cond_init(&ring->cond, &cond_attr);
+    }
+    pthread_condattr_destroy(&cond_attr);
+    pthread_mutexattr_destroy(&mutex_attr);
+}
+
+void
+ShmIface::unlinkSegment()
+{
+    if (segName.empty())
+        return;
+    shm_unlink(segName.c_str());
+    segName.clear();
+}
+
+void
+ShmIface::recoverRing(Ring *ring)
+{
+    // The peer died in the middle of a ring update. The head and tail
+    // are only moved after the data has been copied, so the ring is
+    // consistent but nobody will ever write or read it again.
+    inform("Shared memory link peer died holding the ring lock");
+    ring->closed = true;
+    pthread_mutex_consistent(&ring->mutex);
+    pthread_cond_broadcast(&ring->cond);
+}
+
+bool
+ShmIface::lockRing(Ring *ring)
+{
+    int ret = pthread_mutex_lock(&ring->mutex);
+    if (ret == EOWNERDEAD) {
+        recoverRing(ring);
+        return true;
+    }
+    return ret == 0;
+}
+
+bool
+ShmIface::waitRing(Ring *ring, int sock)
+{
+    // Wake up every now and then to check if the peer gem5 process is still
+    // alive. A dead peer cannot mark the ring closed but the kernel closes
+    // its end of the socket.
+    struct timespec abs_time;
+    clock_gettime(CLOCK_REALTIME, &abs_time);
+    abs_time.tv_nsec += 100 * 1000 * 1000;
+    if (abs_time.tv_nsec >= 1000 * 1000 * 1000) {
+        abs_time.tv_sec++;
+        abs_time.tv_nsec -= 1000 * 1000 * 1000;
+    }
+
+    int ret = pthread_cond_timedwait(&ring->cond, &ring->mutex, &abs_time);
+    if (ret == EOWNERDEAD) {
+        // The ring is marked closed, which the caller checks next.
+        recoverRing(ring);
+        return true;
+    }
+    if (ret != ETIMEDOUT)
+        return true;
+
+    char c;
+    ssize_t n = ::recv(sock, &c, sizeof(c), MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+        inform("Shared memory link peer closed the connection");
+        return false;
+    }
+    return true;
+}
+
+bool
+ShmIface::writeRing(Ring *ring, int sock, const void *buf, size_t length)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(buf);
+    bool ok = true;
+
+    if (!lockRing(ring))
+        return false;
+    while (ok && length > 0) {
+        if (ring->closed) {
+            ok = false;
+        } else if (ring->head - ring->tail == RingSize) {
+            ok = waitRing(ring, sock);
+        } else {
+            size_t pos = ring->head % RingSize;
+            size_t n = min({ length,
+                             RingSize - (size_t)(ring->head - ring->tail),
+                             RingSize - pos });
+            memcpy(ring->data + pos, src, n);
+            ring->head += n;
+            src += n;
+            length -= n;
+            pthread_cond_broadcast(&ring->cond);
+        }
+    }
+    pthread_mutex_unlock(&ring->mutex);
+    return ok;
+}
+
+bool
+ShmIface::readRing(Ring *ring, int sock, void *buf, size_t length)
+{
+    uint8_t *dst = static_cast<uint8_t *>(buf);
+    bool ok = true;
+
+    if (!lockRing(ring))
+        return false;
+    while (ok && length > 0) {
+        if (ring->head == ring->tail) {
+            // Pending data is still delivered after the peer closed the
+            // link.
+            ok = !ring->closed && waitRing(ring, sock);
+        } else {
+            size_t pos = ring->tail % RingSize;
+            size_t n = min({ length,
+                             (size_t)(ring->head - ring->tail),
+                             RingSize - pos });
+            memcpy(dst, ring->data + pos, n);
+            ring->tail += n;
+            dst += n;
+            length -= n;
+            pthread_cond_broadcast(&ring->cond);
+        }
+    }
+    pthread_mutex_unlock(&ring->mutex);
+    return ok;
+}
+
+void
+ShmIface::sendShm(Ring *ring, int sock, const void *buf, size_t length)
+{
+    if (!writeRing(ring, sock, buf, length))
+        exitSimLoop("Message server closed connection, simulation "
+                    "is exiting");
+}
+
+void
+ShmIface::sendPacket(const Header &header, const EthPacketPtr &packet)
+{
+    sendShm(txRing, sock, &header, sizeof(header));
+    sendShm(txRing, sock, packet->data, packet->length);
+}
+
+void
+ShmIface::sendCmd(const Header &header)
+{
+    DPRINTF(DistEthernetCmd, "ShmIface::sendCmd() type: %d\n",
+            static_cast<int>(header.msgType));
+    // Global commands are sent by the master DistIface to every link (see
+    // TCPIface::sendCmd()).
+    for (auto &r : ringRegistry)
+        sendShm(r.first, r.second, &header, sizeof(header));
+}
+
+bool
+ShmIface::recvHeader(Header &header)
+{
+    bool ret = readRing(rxRing, sock, &header, sizeof(header));
+    DPRINTF(DistEthernetCmd, "ShmIface::recvHeader() type: %d ret: %d\n",
+            static_cast<int>(header.msgType), ret);
+    return ret;
+}
+
+void
+ShmIface::recvPacket(const Header &header, EthPacketPtr &packet)
+{
+    packet = make_shared<EthPacketData>(header.dataPacketLength);
+    bool ret = readRing(rxRing, sock, packet->data, header.dataPacketLength);
+    panic_if(!ret, "Error while reading shared memory link");
+    packet->simLength = header.simLength;
+    packet->length = header.dataPacketLength;
+}
+
+void
+ShmIface::initTransport()
+{
+    // Set up the TCP connection first. It provides the same link ordering
+    // as the TCP transport and we use it to hand over the name of the
+    // shared memory segment.
+    TCPIface::initTransport();
+
+    uint32_t len;
+    char ack = 1;
+    if (isSwitch) {
+        char seg_name[NAME_MAX + 1];
+        if (!recvTCP(sock, &len, sizeof(len)) || len > NAME_MAX ||
+            !recvTCP(sock, seg_name, len))
+            panic("Failed to receive shared memory segment name");
+        seg_name[len] = '\0';
+        mapSegment(seg_name, false);
+        txRing = &segment->down;
+        rxRing = &segment->up;
+        sendTCP(sock, &ack, sizeof(ack));
+    } else {
+        string seg_name = csprintf("/gem5-dist-%d-%d", getpid(), distIfaceId);
+        mapSegment(seg_name, true);
+        txRing = &segment->up;
+        rxRing = &segment->down;
+        len = seg_name.size();
+        sendTCP(sock, &len, sizeof(len));
+        sendTCP(sock, seg_name.c_str(), len);
+        if (!recvTCP(sock, &ack, sizeof(ack))) {
+            unlinkSegment();
+            panic("Failed to receive shared memory link ack");
+        }
+        // Both ends have the segment mapped now so we can drop the name.
+        unlinkSegment();
+    }
+    DPRINTF(DistEthernet, "Shared memory link okay (iface:%d)\n",
+            distIfaceId);
+    ringRegistry.push_back(make_pair(txRing, sock));
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory based interface class for dist-gem5 runs.
+ *
+ * For a high level description about dist-gem5 see comments in
+ * header file dist_iface.hh.
+ *
+ * This transport is meant for dist-gem5 runs where all the gem5 processes
+ * run on the same host. The compute nodes still connect to the switch
+ * process via a TCP stream socket (see tcp_iface.hh) but the socket is only
+ * used to set up the links and to detect if a peer gem5 process goes away.
+ * All the data packets and sync messages are passed through a shared memory
+ * segment per link, which avoids the system call and the network stack
+ * overhead of the TCP transport for every message.
+ */
+#ifndef __DEV_NET_SHM_IFACE_HH__
+#define __DEV_NET_SHM_IFACE_HH__
+
+#include <pthread.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dev/net/tcp_iface.hh"
+
+class EventManager;
+
+class ShmIface : public TCPIface
+{
+  private:
+    /**
+     * Size of the data area of a message ring in bytes.
+     */
+    static const size_t RingSize = 1 << 20;
+
+    /**
+     * A byte stream in shared memory with a single reader and a single
+     * writer process.
+     */
+    struct Ring
+    {
+        pthread_mutex_t mutex;
+        /**
+         * Signalled whenever data is written to or read from the ring.
+         */
+        pthread_cond_t cond;
+        /**
+         * Total number of bytes written to the ring.
+         */
+        uint64_t head;
+        /**
+         * Total number of bytes read from the ring.
+         */
+        uint64_t tail;
+        /**
+         * Flag is set when either end shuts the link down, or dies with
+         * the ring locked.
+         */
+        bool closed;
+        uint8_t data[RingSize];
+    };
+
+    /**
+     * The shared memory segment of a link.
+     */
+    struct Segment
+    {
+        /**
+         * Messages from the compute node to the switch.
+         */
+        Ring up;
+        /**
+         * Messages from the switch to the compute node.
+         */
+        Ring down;
+    };
+
+    /**
+     * The shared memory segment of this link.
+     */
+    Segment *segment;
+    /**
+     * Name of the segment created by this process until it is unlinked,
+     * which happens once the switch has mapped it too.
+     */
+    std::string segName;
+    Ring *txRing;
+    Ring *rxRing;
+
+    /**
+     * All the transmit rings in this gem5 process and the sockets of the
+     * corresponding links (used to send out global commands).
+     */
+    static std::vector<std::pair<Ring *, int> > ringRegistry;
+
+  private:
+    /**
+     * Create (on the compute node side) or open (on the switch side) the
+     * shared memory segment for this link.
+     */
+    void mapSegment(const std::string &name, bool create);
+
+    /**
+     * Remove the name of the shared memory segment created by this
+     * process, if it still exists.
+     */
+    void unlinkSegment();
+
+    /**
+     * Lock a ring. If the peer gem5 process died holding the lock, the
+     * ring is marked closed.
+     *
+     * @return False if the lock could not be taken.
+     */
+    bool lockRing(Ring *ring);
+
+    /**
+     * Mark a ring closed after its lock was taken over from a dead peer.
+     */
+    void recoverRing(Ring *ring);
+
+    /**
+     * Wait for the peer to update the ring. The ring mutex must be held.
+     *
+     * @param ring The ring to wait on.
+     * @param sock TCP socket of the link, to check if the peer is alive.
+     * @return False if the peer gem5 process has gone away.
+     */
+    bool waitRing(Ring *ring, int sock);
+
+    /**
+     * Write a message into a ring. Blocks while the ring is full.
+     *
+     * @return False if the link is closed.
+     */
+    bool writeRing(Ring *ring, int sock, const void *buf, size_t length);
+
+    /**
+     * Read the next message from a ring. Blocks until the whole message
+     * is available.
+     *
+     * @return False if the link is closed.
+     */
+    bool readRing(Ring *ring, int sock, void *buf, size_t length);
+
+    void sendShm(Ring *ring, int sock, const void *buf, size_t length);
+
+  protected:
+
+    void sendPacket(const Header &header,
+                    const EthPacketPtr &packet) override;
+
+    void sendCmd(const Header &header) override;
+
+    bool recvHeader(Header &header) override;
+
+    void recvPacket(const Header &header, EthPacketPtr &packet) override;
+
+    void initTransport() override;
+
+  public:
+    /**
+     * The ctor takes the same parameters as the TCPIface ctor. The shared
+     * memory segment is set up in initTransport().
+     */
+    ShmIface(std::string server_name, unsigned server_port,
+             unsigned dist_rank, unsigned dist_size,
+             Tick sync_start, Tick sync_repeat, Tick sync_repeat_max,
+             EventManager *em, bool use_pseudo_op, bool is_switch,
+             int num_nodes);
+
+    ~ShmIface() override;
+};
+
+#endif // __DEV_NET_SHM_IFACE_HH__
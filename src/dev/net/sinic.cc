@@ -1148,7 +1148,7 @@ Device::rxFilter(const EthPacketPtr &packet)
 }
 
 bool
-Device::recvPacket(EthPacketPtr packet)
+Device::recvPacket(const EthPacketPtr &packet)
 {
     rxBytes += packet->length;
     rxPackets++;
@@ -58,17 +58,18 @@ class EventManager;
 
 class TCPIface : public DistIface
 {
-  private:
+  protected:
     /**
      * The stream socket to connect to the server.
      */
     int sock;
 
+    bool isSwitch;
+
+  private:
     std::string serverName;
     int serverPort;
 
-    bool isSwitch;
-
     bool listening;
     static bool anyListening;
     static int fdStatic;
@@ -89,7 +90,7 @@ class TCPIface : public DistIface
      */
     static std::vector<int> sockRegistry;
 
-  private:
+  protected:
 
     /**
      * Send out a message through a TCP stream socket.
@@ -109,6 +110,8 @@ class TCPIface : public DistIface
      * @param length Exact size of the expected message in bytes.
      */
     bool recvTCP(int sock, void *buf, unsigned length);
+
+  private:
     bool listen(int port);
     void accept();
     void connect();
@@ -139,12 +142,14 @@ class TCPIface : public DistIface
      * connections.
      * @param sync_start The tick for the first dist synchronisation.
      * @param sync_repeat The frequency of dist synchronisation.
+     * @param sync_repeat_max Upper bound for the adaptive sync quantum.
      * @param em The EventManager object associated with the simulated
      * Ethernet link.
      */
     TCPIface(std::string server_name, unsigned server_port,
              unsigned dist_rank, unsigned dist_size,
-             Tick sync_start, Tick sync_repeat, EventManager *em,
+             Tick sync_start, Tick sync_repeat, Tick sync_repeat_max,
+             EventManager *em,
              bool use_pseudo_op, bool is_switch, int num_nodes);
 
     ~TCPIface() override;
@@ -36,11 +36,17 @@ class DiskImage(SimObject):
 class RawDiskImage(DiskImage):
     type = 'RawDiskImage'
     cxx_header = "dev/storage/disk_image.hh"
+    use_mmap = Param.Bool(True, "map the image file instead of reading "
+                          "and writing it one sector at a time")
 
 class CowDiskImage(DiskImage):
     type = 'CowDiskImage'
     cxx_header = "dev/storage/disk_image.hh"
     child = Param.DiskImage(RawDiskImage(read_only=True),
                             "child image")
-    table_size = Param.Int(65536, "initial table size")
     image_file = ""
+    # Keep the modified pages in a sparse overlay file that persists
+    # across runs. The file is created if it does not exist. Restoring a
+    # checkpoint detaches the overlay, so the run neither sees nor changes
+    # the pages in the file.
+    overlay_file = Param.String("", "persistent COW overlay file")
@@ -32,16 +32,21 @@
 
 #include "dev/storage/disk_image.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <string>
 
 #include "base/callback.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/DiskImageRead.hh"
@@ -51,12 +56,47 @@
 
 using namespace std;
 
+////////////////////////////////////////////////////////////////////////
+//
+// Disk image
+//
+std::streampos
+DiskImage::readSectors(uint8_t *data, std::streampos offset,
+                       unsigned count) const
+{
+    const uint64_t first = offset;
+    uint64_t bytes = 0;
+    for (unsigned i = 0; i < count; i++) {
+        const uint64_t read_bytes = read(data + bytes, first + i);
+        bytes += read_bytes;
+        if (read_bytes != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
+std::streampos
+DiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                        unsigned count)
+{
+    const uint64_t first = offset;
+    uint64_t bytes = 0;
+    for (unsigned i = 0; i < count; i++) {
+        const uint64_t written = write(data + bytes, first + i);
+        bytes += written;
+        if (written != SectorSize)
+            break;
+    }
+    return bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////
 //
 // Raw Disk image
 //
 RawDiskImage::RawDiskImage(const Params* p)
-    : DiskImage(p), disk_size(0)
+    : DiskImage(p), disk_size(0), useMmap(p->use_mmap), mapping(nullptr),
+      mappingSize(0)
 { open(p->image_file, p->read_only); }
 
 RawDiskImage::~RawDiskImage()
@@ -81,6 +121,32 @@ RawDiskImage::open(const string &filename, bool rd_only)
         readonly = rd_only;
         file = filename;
 
+        if (useMmap) {
+            int fd = ::open(file.c_str(), readonly ? O_RDONLY : O_RDWR);
+            if (fd < 0)
+                panic("Error opening %s", filename);
+
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+                st.st_size > 0) {
+                const int prot = PROT_READ | (readonly ? 0 : PROT_WRITE);
+                void *map = mmap(nullptr, st.st_size, prot, MAP_SHARED,
+                                 fd, 0);
+                if (map != MAP_FAILED) {
+                    mapping = (uint8_t *)map;
+                    mappingSize = st.st_size;
+                    disk_size = st.st_size;
+                } else {
+                    warn("Could not map %s, falling back to stream I/O: "
+                         "%s\n", filename, strerror(errno));
+                }
+            }
+            ::close(fd);
+
+            if (mapping)
+                return;
+        }
+
         ios::openmode mode = ios::in | ios::binary;
         if (!readonly)
             mode |= ios::out;
@@ -93,6 +159,12 @@ RawDiskImage::open(const string &filename, bool rd_only)
 void
 RawDiskImage::close()
 {
+    if (mapping) {
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+        mappingSize = 0;
+        disk_size = 0;
+    }
     stream.close();
 }
 
@@ -112,6 +184,9 @@ RawDiskImage::size() const
 std::streampos
 RawDiskImage::read(uint8_t *data, std::streampos offset) const
 {
+    if (mapping)
+        return readSectors(data, offset, 1);
+
     if (!initialized)
         panic("RawDiskImage not initialized");
 
@@ -137,6 +212,9 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     if (!initialized)
         panic("RawDiskImage not initialized");
 
+    if (mapping)
+        return writeSectors(data, offset, 1);
+
     if (readonly)
         panic("Cannot write to a read only disk image");
 
@@ -155,6 +233,63 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     return stream.tellp() - pos;
 }
 
+std::streampos
+RawDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          unsigned count) const
+{
+    if (!mapping)
+        return DiskImage::readSectors(data, offset, count);
+
+    const size_t start = (uint64_t)offset * SectorSize;
+    if (start >= mappingSize)
+        return 0;
+
+    const size_t len = std::min<size_t>((size_t)count * SectorSize,
+                                        mappingSize - start);
+    memcpy(data, mapping + start, len);
+
+    // Runs of sectors are typically followed by the next run, so ask
+    // the kernel to start reading it in while the current one is used.
+    if (count > 1 && start + len < mappingSize) {
+        const size_t page_size = sysconf(_SC_PAGESIZE);
+        const size_t ahead = roundDown(start + len, page_size);
+        madvise(mapping + ahead,
+                std::min(len + page_size, mappingSize - ahead),
+                MADV_WILLNEED);
+    }
+
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", (uint64_t)offset,
+            count);
+    DDUMP(DiskImageRead, data, len);
+
+    return len;
+}
+
+std::streampos
+RawDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           unsigned count)
+{
+    if (!mapping)
+        return DiskImage::writeSectors(data, offset, count);
+
+    if (readonly)
+        panic("Cannot write to a read only disk image");
+
+    const size_t start = (uint64_t)offset * SectorSize;
+    if (start >= mappingSize)
+        return 0;
+
+    const size_t len = std::min<size_t>((size_t)count * SectorSize,
+                                        mappingSize - start);
+
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n",
+            (uint64_t)offset, count);
+    DDUMP(DiskImageWrite, data, len);
+
+    memcpy(mapping + start, data, len);
+    return len;
+}
+
 RawDiskImage *
 RawDiskImageParams::create()
 {
@@ -167,6 +302,9 @@ RawDiskImageParams::create()
 //
 const uint32_t CowDiskImage::VersionMajor = 1;
 const uint32_t CowDiskImage::VersionMinor = 0;
+const uint32_t CowDiskImage::OverlayVersion = 1;
+const unsigned CowDiskImage::PageSectors;
+const unsigned CowDiskImage::PageSize;
 
 class CowDiskCallback : public Callback
 {
@@ -179,16 +317,17 @@ class CowDiskCallback : public Callback
 };
 
 CowDiskImage::CowDiskImage(const Params *p)
-    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL)
+    : DiskImage(p), filename(p->image_file), child(p->child),
+      overlayFile(p->overlay_file), numSectors(child->size()),
+      numPages(divCeil(numSectors, PageSectors)), overlayFd(-1),
+      overlay(nullptr), overlaySize(0), pageBitmap(nullptr),
+      pageData(nullptr), numPresent(0)
 {
-    if (filename.empty()) {
-        initSectorTable(p->table_size);
-    } else {
-        if (!open(filename)) {
-            if (p->read_only)
-                fatal("could not open read-only file");
-            initSectorTable(p->table_size);
-        }
+    initOverlay(p->read_only);
+
+    if (!filename.empty()) {
+        if (!open(filename) && p->read_only)
+            fatal("could not open read-only file");
 
         if (!p->read_only)
             registerExitCallback(new CowDiskCallback(this));
@@ -197,13 +336,10 @@ CowDiskImage::CowDiskImage(const Params *p)
 
 CowDiskImage::~CowDiskImage()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        delete (*i).second;
-        ++i;
-    }
+    if (overlay)
+        munmap(overlay, overlaySize);
+    if (overlayFd >= 0)
+        ::close(overlayFd);
 }
 
 void
@@ -214,6 +350,143 @@ CowDiskImage::notifyFork()
         inform("Disabling saving of COW image in forked child process.\n");
         filename = "";
     }
+
+    if (overlayFd >= 0) {
+        // Keep the changes of the forked child process out of the
+        // overlay file shared with the parent.
+        inform("Detaching COW overlay %s in forked child process.\n",
+               overlayFile);
+        detachOverlay();
+    }
+}
+
+void
+CowDiskImage::detachOverlay()
+{
+    assert(overlayFd >= 0);
+    void *map = mmap(overlay, overlaySize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_FIXED, overlayFd, 0);
+    if (map == MAP_FAILED)
+        panic("Could not remap COW overlay %s: %s", overlayFile,
+              strerror(errno));
+    ::close(overlayFd);
+    overlayFd = -1;
+}
+
+void
+CowDiskImage::initOverlay(bool read_only)
+{
+    // The overlay starts with a page holding the header, followed by
+    // the page bitmap and the pages of the image.
+    const size_t bitmap_size = roundUp(divCeil(numPages, 8),
+                                       (uint64_t)PageSize);
+    overlaySize = PageSize + bitmap_size + numPages * PageSize;
+
+    if (overlayFile.empty()) {
+        void *map = mmap(nullptr, overlaySize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                         -1, 0);
+        if (map == MAP_FAILED)
+            fatal("Could not allocate the COW overlay of %s: %s\n", name(),
+                  strerror(errno));
+        overlay = (uint8_t *)map;
+    } else {
+        overlayFd = ::open(overlayFile.c_str(), O_RDWR | O_CREAT, 0644);
+        if (overlayFd < 0)
+            fatal("Could not open COW overlay %s: %s\n", overlayFile,
+                  strerror(errno));
+
+        struct stat st;
+        if (fstat(overlayFd, &st) != 0)
+            fatal("Could not stat COW overlay %s\n", overlayFile);
+
+        if (st.st_size == 0) {
+            // Extending the file leaves the pages as holes, so only
+            // the pages written take up space.
+            uint8_t header[24] = {};
+            memcpy(header, "COWOVLY!", 8);
+            const uint32_t version = htole(OverlayVersion);
+            const uint64_t sectors = htole(numSectors);
+            memcpy(header + 8, &version, sizeof(version));
+            memcpy(header + 16, &sectors, sizeof(sectors));
+            if (ftruncate(overlayFd, overlaySize) != 0 ||
+                pwrite(overlayFd, header, sizeof(header), 0) !=
+                (ssize_t)sizeof(header)) {
+                fatal("Could not create COW overlay %s: %s\n", overlayFile,
+                      strerror(errno));
+            }
+        } else if ((size_t)st.st_size != overlaySize) {
+            fatal("COW overlay %s does not match the size of the image\n",
+                  overlayFile);
+        }
+
+        // A read-only layer keeps its changes private to this run.
+        void *map = mmap(nullptr, overlaySize, PROT_READ | PROT_WRITE,
+                         read_only ? MAP_PRIVATE : MAP_SHARED, overlayFd,
+                         0);
+        if (map == MAP_FAILED)
+            fatal("Could not map COW overlay %s: %s\n", overlayFile,
+                  strerror(errno));
+        overlay = (uint8_t *)map;
+
+        uint32_t version;
+        uint64_t sectors;
+        memcpy(&version, overlay + 8, sizeof(version));
+        memcpy(&sectors, overlay + 16, sizeof(sectors));
+        if (memcmp(overlay, "COWOVLY!", 8) != 0 ||
+            letoh(version) != OverlayVersion ||
+            letoh(sectors) != numSectors) {
+            fatal("Invalid COW overlay %s\n", overlayFile);
+        }
+
+        if (read_only) {
+            ::close(overlayFd);
+            overlayFd = -1;
+        }
+    }
+
+    pageBitmap = overlay + PageSize;
+    pageData = pageBitmap + bitmap_size;
+
+    numPresent = 0;
+    for (uint64_t page = 0; page < numPages; page++)
+        numPresent += pagePresent(page);
+
+    if (numPresent)
+        inform("%s: %d modified pages in COW overlay %s\n", name(),
+               numPresent, overlayFile);
+
+    initialized = true;
+}
+
+void
+CowDiskImage::clearOverlay()
+{
+    memset(pageBitmap, 0, divCeil(numPages, 8));
+    numPresent = 0;
+
+    // Give the memory of an anonymous overlay back
+    if (overlayFile.empty())
+        madvise(pageData, numPages * PageSize, MADV_DONTNEED);
+}
+
+void
+CowDiskImage::copyUp(uint64_t page, bool fill)
+{
+    assert(!pagePresent(page));
+
+    uint8_t *data = pageData + page * PageSize;
+    const uint64_t first = page * PageSectors;
+    const unsigned sectors = std::min<uint64_t>(PageSectors,
+                                                numSectors - first);
+
+    // The page may hold stale data after the overlay was cleared
+    memset(data, 0, PageSize);
+    if (fill)
+        child->readSectors(data, first, sectors);
+
+    pageBitmap[page / 8] |= 1 << (page % 8);
+    ++numPresent;
 }
 
 void
@@ -271,34 +544,25 @@ CowDiskImage::open(const string &file)
 
     uint64_t sector_count;
     SafeReadSwap(stream, sector_count);
-    table = new SectorTable(sector_count);
-
 
     for (uint64_t i = 0; i < sector_count; i++) {
         uint64_t offset;
         SafeReadSwap(stream, offset);
 
-        Sector *sector = new Sector;
-        SafeRead(stream, sector, sizeof(Sector));
+        uint8_t sector[SectorSize];
+        SafeRead(stream, sector, sizeof(sector));
 
-        assert(table->find(offset) == table->end());
-        (*table)[offset] = sector;
+        if (offset >= numSectors)
+            panic("Could not open %s: sector %d out of bounds", file,
+                  offset);
+        writeSectors(sector, offset, 1);
     }
 
     stream.close();
 
-    initialized = true;
     return true;
 }
 
-void
-CowDiskImage::initSectorTable(int hash_size)
-{
-    table = new SectorTable(hash_size);
-
-    initialized = true;
-}
-
 void
 SafeWrite(ofstream &stream, const void *data, int count)
 {
@@ -351,21 +615,31 @@ CowDiskImage::save(const string &file) const
     memcpy(&magic, "COWDISK!", sizeof(magic));
     SafeWrite(stream, magic);
 
+    // The file format stays sector based, so the sectors of each page
+    // in the overlay are saved individually.
+    uint64_t sector_count = 0;
+    for (uint64_t page = 0; page < numPages; page++) {
+        if (pagePresent(page)) {
+            sector_count += std::min<uint64_t>(
+                PageSectors, numSectors - page * PageSectors);
+        }
+    }
+
     SafeWriteSwap(stream, (uint32_t)VersionMajor);
     SafeWriteSwap(stream, (uint32_t)VersionMinor);
-    SafeWriteSwap(stream, (uint64_t)table->size());
-
-    uint64_t size = table->size();
-    SectorTable::iterator iter = table->begin();
-    SectorTable::iterator end = table->end();
-
-    for (uint64_t i = 0; i < size; i++) {
-        if (iter == end)
-            panic("Incorrect Table Size during save of COW disk image");
-
-        SafeWriteSwap(stream, (uint64_t)(*iter).first);
-        SafeWrite(stream, (*iter).second->data, sizeof(Sector));
-        ++iter;
+    SafeWriteSwap(stream, sector_count);
+
+    for (uint64_t page = 0; page < numPages; page++) {
+        if (!pagePresent(page))
+            continue;
+
+        for (uint64_t sector = page * PageSectors;
+             sector < std::min<uint64_t>((page + 1) * PageSectors,
+                                         numSectors);
+             sector++) {
+            SafeWriteSwap(stream, sector);
+            SafeWrite(stream, pageData + sector * SectorSize, SectorSize);
+        }
     }
 
     stream.close();
@@ -374,12 +648,14 @@ CowDiskImage::save(const string &file) const
 void
 CowDiskImage::writeback()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        child->write((*i).second->data, (*i).first);
-        ++i;
+    for (uint64_t page = 0; page < numPages; page++) {
+        if (!pagePresent(page))
+            continue;
+
+        const uint64_t first = page * PageSectors;
+        child->writeSectors(pageData + first * SectorSize, first,
+                            std::min<uint64_t>(PageSectors,
+                                               numSectors - first));
     }
 }
 
@@ -389,46 +665,94 @@ CowDiskImage::size() const
 
 std::streampos
 CowDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          unsigned count) const
 {
     if (!initialized)
         panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    const uint64_t first = offset;
+    if (first > numSectors)
         panic("access out of bounds");
+    count = std::min<uint64_t>(count, numSectors - first);
+
+    // Coalesce runs of sectors that are either all in the overlay or
+    // all in the child, so that the child sees one request per run.
+    unsigned done = 0;
+    while (done < count) {
+        const bool present = pagePresent((first + done) / PageSectors);
+        unsigned run = 1;
+        while (done + run < count &&
+               pagePresent((first + done + run) / PageSectors) == present) {
+            ++run;
+        }
 
-    SectorTable::const_iterator i = table->find(offset);
-    if (i == table->end())
-        return child->read(data, offset);
-    else {
-        memcpy(data, (*i).second->data, SectorSize);
-        DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-        DDUMP(DiskImageRead, data, SectorSize);
-        return SectorSize;
+        uint8_t *dst = data + done * SectorSize;
+        if (present) {
+            memcpy(dst, pageData + (first + done) * SectorSize,
+                   run * SectorSize);
+            DPRINTF(DiskImageRead, "read: offset=%d count=%d\n",
+                    first + done, run);
+            DDUMP(DiskImageRead, dst, run * SectorSize);
+        } else {
+            const std::streampos bytes =
+                child->readSectors(dst, first + done, run);
+            if (bytes != (std::streampos)(run * SectorSize))
+                return bytes + (std::streamoff)(done * SectorSize);
+        }
+        done += run;
     }
+
+    return count * SectorSize;
 }
 
 std::streampos
-CowDiskImage::write(const uint8_t *data, std::streampos offset)
+CowDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           unsigned count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (offset > size())
+    const uint64_t first = offset;
+    if (first > numSectors)
         panic("access out of bounds");
+    count = std::min<uint64_t>(count, numSectors - first);
+
+    for (uint64_t sector = first; sector < first + count; ) {
+        const uint64_t page = sector / PageSectors;
+        const uint64_t page_end = std::min<uint64_t>(
+            std::min<uint64_t>((page + 1) * PageSectors, numSectors),
+            first + count);
+
+        if (!pagePresent(page)) {
+            // pages written in their entirety need no data from below
+            const bool whole_page = sector == page * PageSectors &&
+                page_end == std::min<uint64_t>((page + 1) * PageSectors,
+                                               numSectors);
+            copyUp(page, !whole_page);
+        }
 
-    SectorTable::iterator i = table->find(offset);
-    if (i == table->end()) {
-        Sector *sector = new Sector;
-        memcpy(sector, data, SectorSize);
-        table->insert(make_pair(offset, sector));
-    } else {
-        memcpy((*i).second->data, data, SectorSize);
+        memcpy(pageData + sector * SectorSize,
+               data + (sector - first) * SectorSize,
+               (page_end - sector) * SectorSize);
+        sector = page_end;
     }
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", first, count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
-    return SectorSize;
+    return count * SectorSize;
 }
 
 void
@@ -445,6 +769,17 @@ CowDiskImage::unserialize(CheckpointIn &cp)
     string cowFilename;
     UNSERIALIZE_SCALAR(cowFilename);
     cowFilename = cp.getCptDir() + "/" + cowFilename;
+
+    // The disk has to match the checkpointed guest state, so the pages
+    // written after the checkpoint was taken must go. Those of a
+    // persistent overlay are kept in the file for other runs, and the
+    // changes of this run stay private.
+    if (overlayFd >= 0) {
+        inform("%s: detaching COW overlay %s to restore %s\n", name(),
+               overlayFile, cowFilename);
+        detachOverlay();
+    }
+    clearOverlay();
     open(cowFilename);
 }
 
@@ -34,7 +34,7 @@
 #define __DEV_STORAGE_DISK_IMAGE_HH__
 
 #include <fstream>
-#include <unordered_map>
+#include <string>
 
 #include "params/CowDiskImage.hh"
 #include "params/DiskImage.hh"
@@ -62,6 +62,31 @@ class DiskImage : public SimObject
                                 std::streampos offset) const = 0;
     virtual std::streampos write(const uint8_t *data,
                                  std::streampos offset) = 0;
+
+    /**
+     * Read a run of consecutive sectors. Images that can do better
+     * than one sector at a time override this.
+     *
+     * @param data Buffer to hold count sectors
+     * @param offset First sector to read
+     * @param count Number of sectors to read
+     * @return The number of bytes read
+     */
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       unsigned count) const;
+
+    /**
+     * Write a run of consecutive sectors. Images that can do better
+     * than one sector at a time override this.
+     *
+     * @param data Buffer holding count sectors
+     * @param offset First sector to write
+     * @param count Number of sectors to write
+     * @return The number of bytes written
+     */
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset,
+                                        unsigned count);
 };
 
 /**
@@ -75,6 +100,15 @@ class RawDiskImage : public DiskImage
     bool readonly;
     mutable std::streampos disk_size;
 
+    /** Whether to map the image file rather than use the stream */
+    const bool useMmap;
+
+    /** Mapping of the image file, nullptr if the stream is used */
+    uint8_t *mapping;
+
+    /** Size of the mapping in bytes */
+    size_t mappingSize;
+
   public:
     typedef RawDiskImageParams Params;
     RawDiskImage(const Params *p);
@@ -89,6 +123,11 @@ class RawDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               unsigned count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                unsigned count) override;
 };
 
 /**
@@ -100,6 +139,13 @@ class RawDiskImage : public DiskImage
  * This object is designed to provide a mechanism for persistant
  * changes to a main disk image, or to provide a place for temporary
  * changes to the image to take place that later may be thrown away.
+ *
+ * Modified data is kept at page granularity in an overlay that spans
+ * the whole image: a bitmap of the pages present followed by the
+ * pages themselves, each at the offset of its data in the image. The
+ * overlay is either anonymous memory, of which only the pages
+ * written are ever backed, or a sparse file that persists the
+ * changes across runs without having to be loaded or saved.
  */
 class CowDiskImage : public DiskImage
 {
@@ -107,16 +153,74 @@ class CowDiskImage : public DiskImage
     static const uint32_t VersionMajor;
     static const uint32_t VersionMinor;
 
+    /** Version of the overlay file format */
+    static const uint32_t OverlayVersion;
+
   protected:
-    struct Sector {
-        uint8_t data[SectorSize];
-    };
-    typedef std::unordered_map<uint64_t, Sector *> SectorTable;
+    /** Number of sectors copied from the child on a first write */
+    static const unsigned PageSectors = 8;
+    static const unsigned PageSize = PageSectors * SectorSize;
 
   protected:
     std::string filename;
     DiskImage *child;
-    SectorTable *table;
+
+    /** Persistent overlay file, empty if the overlay is anonymous */
+    std::string overlayFile;
+
+    /** Number of sectors of the image */
+    uint64_t numSectors;
+
+    /** Number of pages covering the image */
+    uint64_t numPages;
+
+    /**
+     * Descriptor of the overlay file, -1 unless the changes made in this
+     * run go to the file (i.e., the overlay is anonymous or private)
+     */
+    int overlayFd;
+
+    /** Mapping of the overlay header, page bitmap and pages */
+    uint8_t *overlay;
+
+    /** Size of the overlay mapping in bytes */
+    size_t overlaySize;
+
+    /** Bitmap of the pages present in the overlay */
+    uint8_t *pageBitmap;
+
+    /** Page data, indexed by the offset of the data in the image */
+    uint8_t *pageData;
+
+    /** Number of pages present in the overlay */
+    uint64_t numPresent;
+
+    /** Map the overlay, creating or checking the overlay file. */
+    void initOverlay(bool read_only);
+
+    /** Drop every page of the overlay. */
+    void clearOverlay();
+
+    /**
+     * Map a persistent overlay privately, so that the changes of this
+     * run no longer reach the overlay file.
+     */
+    void detachOverlay();
+
+    bool
+    pagePresent(uint64_t page) const
+    {
+        return pageBitmap[page / 8] & (1 << (page % 8));
+    }
+
+    /**
+     * Add a page to the overlay, copying its data from the child
+     * unless it is about to be overwritten entirely.
+     *
+     * @param page Page to add
+     * @param fill Whether to fill the page from the child
+     */
+    void copyUp(uint64_t page, bool fill);
 
   public:
     typedef CowDiskImageParams Params;
@@ -125,7 +229,6 @@ class CowDiskImage : public DiskImage
 
     void notifyFork() override;
 
-    void initSectorTable(int hash_size);
     bool open(const std::string &file);
     void save() const;
     void save(const std::string &file) const;
@@ -138,6 +241,11 @@ class CowDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               unsigned count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                unsigned count) override;
 };
 
 void SafeRead(std::ifstream &stream, void *data, int count);
@@ -42,6 +42,7 @@ from m5.SimObject import SimObject
 
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.Compressors import BaseCacheCompressor
+from m5.objects.PartitioningPolicies import BasePartitioningPolicy
 from m5.objects.Prefetcher import BasePrefetcher
 from m5.objects.ReplacementPolicies import *
 from m5.objects.Tags import *
@@ -104,6 +105,12 @@ class BaseCache(ClockedObject):
 
     compressor = Param.BaseCacheCompressor(NULL, "Cache compressor.")
 
+    # Partition the ways between requestors (e.g., UtilityPartitioning
+    # for a shared last level cache). Only set-associative tag stores
+    # support this.
+    partitioning_policy = Param.BasePartitioningPolicy(NULL,
+        "Way partitioning policy")
+
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
 
@@ -123,6 +130,34 @@ class BaseCache(ClockedObject):
     # cache.
     writeback_clean = Param.Bool(False, "Writeback clean lines")
 
+    # Save the tag array, block contents and replacement state in
+    # checkpoints so that simulation restored from them starts with a
+    # warm cache. Only set-associative tag stores support this.
+    checkpoint_warm_state = Param.Bool(False, "Save and restore the cache "
+                                       "contents in checkpoints")
+
+    # Ask the memory below for a backdoor on the first atomic miss and
+    # service later atomic fills, and the evictions of blocks filled
+    # that way, by copying straight from and to the backing store.
+    # Tags and replacement state are updated as usual. This bypasses
+    # the memory-side crossbar, including snoops of any other caches
+    # attached to it, so it should only be enabled on the last-level
+    # cache of a single hierarchy in front of a SimpleMemory.
+    atomic_backdoor = Param.Bool(False, "Use a backdoor to the memory "
+                                 "below for atomic fills and evictions")
+
+    # Sampled access statistics for replacement policy analysis: per-set
+    # miss counts, per-PC (hashed) fill/hit/dead-eviction counts,
+    # reuse distances and the dead block ratio. Only one out of
+    # access_sample_period sets is tracked. Only set-associative tag
+    # stores support this.
+    access_sample_period = Param.Unsigned(0, "Record access statistics "
+        "for one out of this many sets (0 disables them)")
+    access_sample_pc_entries = Param.Unsigned(256, "Number of entries "
+        "of the hashed per-PC access statistics (power of 2)")
+    access_sample_reuse_buckets = Param.Unsigned(16, "Number of buckets "
+        "of the sampled reuse distance histogram")
+
     # Control whether this cache should be mostly inclusive or mostly
     # exclusive with respect to upstream caches. The behaviour on a
     # fill is determined accordingly. For a mostly inclusive cache,
@@ -45,6 +45,12 @@
 
 #include "mem/cache/base.hh"
 
+#include <zlib.h>
+
+#include <climits>
+#include <cstring>
+#include <sstream>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "debug/Cache.hh"
@@ -54,6 +60,7 @@
 #include "debug/CacheVerbose.hh"
 #include "mem/cache/compressors/base.hh"
 #include "mem/cache/mshr.hh"
+#include "mem/cache/partitioning_policies/base.hh"
 #include "mem/cache/prefetch/base.hh"
 #include "mem/cache/queue_entry.hh"
 #include "mem/cache/tags/super_blk.hh"
@@ -81,6 +88,7 @@ BaseCache::BaseCache(const BaseCacheParams *p, unsigned blk_size)
       writeBuffer("write buffer", p->write_buffers, p->mshrs), // see below
       tags(p->tags),
       compressor(p->compressor),
+      partitioningPolicy(p->partitioning_policy),
       prefetcher(p->prefetcher),
       writeAllocator(p->write_allocator),
       writebackClean(p->writeback_clean),
@@ -99,6 +107,10 @@ BaseCache::BaseCache(const BaseCacheParams *p, unsigned blk_size)
       forwardSnoops(true),
       clusivity(p->clusivity),
       isReadOnly(p->is_read_only),
+      checkpointWarmState(p->checkpoint_warm_state),
+      useBackdoor(p->atomic_backdoor),
+      backdoor(nullptr),
+      backdoorLatency(0),
       blocked(0),
       order(0),
       noTargetMSHR(nullptr),
@@ -594,19 +606,22 @@ BaseCache::recvAtomic(PacketPtr pkt)
         // the atomic CPU calls recvAtomic for fetch and load/store
         // sequentuially, and we may already have a tempBlock
         // writeback from the fetch that we have not yet sent
-        if (tempBlockWriteback) {
+        PacketPtr wb_pkt = evictBlock(blk);
+        if (!wb_pkt) {
+            // the block was evicted straight to the memory backdoor
+        } else if (tempBlockWriteback) {
             // if that is the case, write the prevoius one back, and
             // do not schedule any new event
             writebackTempBlockAtomic();
+            tempBlockWriteback = wb_pkt;
         } else {
             // the writeback/clean eviction happens after the call to
             // recvAtomic has finished (but before any successive
             // calls), so that the response handling from the fill is
             // allowed to happen first
             schedule(writebackTempBlockAtomicEvent, curTick());
+            tempBlockWriteback = wb_pkt;
         }
-
-        tempBlockWriteback = evictBlock(blk);
     }
 
     if (pkt->needsResponse()) {
@@ -662,7 +677,19 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
     } else {
         // if it came as a request from the CPU side then make sure it
         // continues towards the memory side
-        if (from_cpu_side) {
+        if (from_cpu_side && backdoor && system->isAtomicMode() &&
+            pkt->getAddrRange().isSubset(backdoor->range())) {
+            // with the system in atomic mode nothing is in flight
+            // below, so the backing store holds the current data
+            uint8_t *host_addr = backdoor->ptr() +
+                (pkt->getAddr() - backdoor->range().start());
+            if (pkt->isRead()) {
+                pkt->setData(host_addr);
+            } else if (pkt->isWrite()) {
+                pkt->writeData(host_addr);
+            }
+            pkt->makeResponse();
+        } else if (from_cpu_side) {
             memSidePort.sendFunctional(pkt);
         } else if (cpuSidePort.isSnooping()) {
             // if it came from the memory side, it must be a snoop request
@@ -795,6 +822,14 @@ bool
 BaseCache::handleEvictions(std::vector<CacheBlk*> &evict_blks,
     PacketList &writebacks)
 {
+    // Blocks moved to make room for the new one must not be in the middle
+    // of a transaction either
+    for (const auto& blk : tags->getRelocatedBlks()) {
+        if (mshrQueue.findMatch(regenerateBlkAddr(blk), blk->isSecure())) {
+            return false;
+        }
+    }
+
     bool replacement = false;
     for (const auto& blk : evict_blks) {
         if (blk->isValid()) {
@@ -1041,6 +1076,11 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
     Cycles tag_latency(0);
     blk = tags->accessBlock(pkt->getAddr(), pkt->isSecure(), tag_latency);
 
+    // Let the partitioning policy monitor the demand accesses
+    if (partitioningPolicy && !pkt->isEviction()) {
+        partitioningPolicy->notifyAccess(pkt->getAddr(), pkt->req->masterId());
+    }
+
     DPRINTF(Cache, "%s for %s %s\n", __func__, pkt->print(),
             blk ? "hit " + blk->print() : "miss");
 
@@ -1428,20 +1468,31 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     // Find replacement victim
     std::vector<CacheBlk*> evict_blks;
     CacheBlk *victim = tags->findVictim(addr, is_secure, blk_size_bits,
-                                        evict_blks);
+                                        evict_blks, pkt->req->masterId());
 
     // It is valid to return nullptr if there is no victim
     if (!victim)
         return nullptr;
 
-    // Print victim block's information
-    DPRINTF(CacheRepl, "Replacement victim: %s\n", victim->print());
+    // Print the information of the blocks actually evicted, followed by
+    // the chain of blocks moved to free the victimized entry, if any
+    if (DTRACE(CacheRepl)) {
+        for (const auto& blk : evict_blks) {
+            DPRINTF(CacheRepl, "Replacement victim: %s\n", blk->print());
+        }
+        for (const auto& blk : tags->getRelocatedBlks()) {
+            DPRINTF(CacheRepl, "Relocated block: %s\n", blk->print());
+        }
+    }
 
     // Try to evict blocks; if it fails, give up on allocation
     if (!handleEvictions(evict_blks, writebacks)) {
         return nullptr;
     }
 
+    // Free the victimized entry, if the tags move blocks around
+    tags->relocateBlks();
+
     // If using a compressor, set compression data. This must be done before
     // block insertion, as compressed tags use this information.
     if (compressor) {
@@ -1472,6 +1523,88 @@ BaseCache::invalidateBlock(CacheBlk *blk)
     }
 }
 
+Tick
+BaseCache::sendAtomicMemSide(PacketPtr pkt)
+{
+    // Only ask for a backdoor while none is held, each one handed out
+    // gets an invalidation callback.
+    if (!useBackdoor || backdoor || !system->isAtomicMode())
+        return memSidePort.sendAtomic(pkt);
+
+    Tick latency = memSidePort.sendAtomicBackdoor(pkt, backdoor);
+    if (backdoor) {
+        if (backdoor->range().interleaved() || !backdoor->readable() ||
+            !backdoor->writeable()) {
+            // Interleaved ranges don't map linearly onto the backing
+            // store, and evictions need to be able to write back.
+            backdoor = nullptr;
+        } else {
+            DPRINTF(Cache, "Using backdoor for range %s\n",
+                    backdoor->range().to_string());
+            backdoorLatency = ticksToCycles(latency);
+            backdoor->addInvalidationCallback(
+                [this](const MemBackdoor &bd) {
+                    if (backdoor == &bd)
+                        dropBackdoor();
+                });
+        }
+    }
+    return latency;
+}
+
+bool
+BaseCache::fillFromBackdoor(PacketPtr pkt)
+{
+    assert(pkt->isRequest());
+
+    // Only plain block fills can bypass the memory-side crossbar;
+    // upgrades, invalidations and failed store conditionals still
+    // have to reach the other caches below.
+    if (!backdoor || !system->isAtomicMode() ||
+        pkt->req->isUncacheable() ||
+        !(pkt->cmd == MemCmd::ReadSharedReq ||
+          pkt->cmd == MemCmd::ReadCleanReq ||
+          pkt->cmd == MemCmd::ReadExReq) ||
+        !pkt->getAddrRange().isSubset(backdoor->range())) {
+        return false;
+    }
+
+    pkt->makeAtomicResponse();
+    pkt->setData(backdoor->ptr() +
+                 (pkt->getAddr() - backdoor->range().start()));
+    stats.backdoorFills++;
+    return true;
+}
+
+bool
+BaseCache::evictToBackdoor(CacheBlk *blk)
+{
+    assert(blk && blk->isValid());
+
+    if (!(blk->status & BlkBackdoor) || !backdoor ||
+        !system->isAtomicMode()) {
+        return false;
+    }
+
+    if (blk->isDirty()) {
+        const Addr addr = regenerateBlkAddr(blk);
+        assert(AddrRange(addr, addr + blkSize - 1).isSubset(
+                   backdoor->range()));
+        std::memcpy(backdoor->ptr() + (addr - backdoor->range().start()),
+                    blk->data, blkSize);
+    }
+    stats.backdoorEvictions++;
+    return true;
+}
+
+void
+BaseCache::dropBackdoor()
+{
+    DPRINTF(Cache, "Dropping the memory backdoor\n");
+    backdoor = nullptr;
+    tags->forEachBlk([](CacheBlk &blk) { blk.status &= ~BlkBackdoor; });
+}
+
 void
 BaseCache::evictBlock(CacheBlk *blk, PacketList &writebacks)
 {
@@ -1587,6 +1720,15 @@ BaseCache::memInvalidate()
     tags->forEachBlk([this](CacheBlk &blk) { invalidateVisitor(blk); });
 }
 
+void
+BaseCache::drainResume()
+{
+    ClockedObject::drainResume();
+
+    if (backdoor && !system->isAtomicMode())
+        dropBackdoor();
+}
+
 bool
 BaseCache::isDirty() const
 {
@@ -1782,6 +1924,37 @@ BaseCache::sendWriteQueuePacket(WriteQueueEntry* wq_entry)
 void
 BaseCache::serialize(CheckpointOut &cp) const
 {
+    if (checkpointWarmState) {
+        // The snapshot holds the contents of every valid block, dirty
+        // ones included, so the checkpoint is complete.
+        std::string warm_state_file = name() + ".warm.gz";
+        std::string filepath = CheckpointIn::dir() + "/" + warm_state_file;
+
+        std::ostringstream os;
+        tags->serializeWarmState(os);
+        const std::string snapshot = os.str();
+
+        gzFile file = gzopen(filepath.c_str(), "wb1");
+        fatal_if(!file, "Can't open cache warm state file '%s'\n",
+                 filepath);
+        for (size_t written = 0; written < snapshot.size(); ) {
+            const unsigned pass_size = std::min<size_t>(
+                INT_MAX, snapshot.size() - written);
+            fatal_if(gzwrite(file, snapshot.data() + written, pass_size) !=
+                     (int)pass_size,
+                     "Write failed on cache warm state file '%s'\n",
+                     filepath);
+            written += pass_size;
+        }
+        fatal_if(gzclose(file),
+                 "Close failed on cache warm state file '%s'\n", filepath);
+
+        SERIALIZE_SCALAR(warm_state_file);
+        bool bad_checkpoint(false);
+        SERIALIZE_SCALAR(bad_checkpoint);
+        return;
+    }
+
     bool dirty(isDirty());
 
     if (dirty) {
@@ -1809,6 +1982,37 @@ BaseCache::unserialize(CheckpointIn &cp)
               "supported in the classic memory system. Please remove any "
               "caches or drain them properly before taking checkpoints.\n");
     }
+
+    std::string warm_state_file;
+    if (!UNSERIALIZE_OPT_SCALAR(warm_state_file)) {
+        warn_if(checkpointWarmState, "%s: checkpoint has no warm state, "
+                "starting with a cold cache\n", name());
+        return;
+    }
+
+    // The snapshot has the only copy of dirty data, so it can't be
+    // skipped if it contains any.
+    if (!checkpointWarmState)
+        warn("%s: restoring warm cache state saved in the checkpoint\n",
+             name());
+
+    std::string filepath = CheckpointIn::dir() + "/" + warm_state_file;
+    gzFile file = gzopen(filepath.c_str(), "rb");
+    fatal_if(!file, "Can't open cache warm state file '%s'\n", filepath);
+
+    std::string snapshot;
+    const size_t chunk_size = 1 << 20;
+    std::unique_ptr<char[]> chunk(new char[chunk_size]);
+    int bytes_read;
+    while ((bytes_read = gzread(file, chunk.get(), chunk_size)) > 0)
+        snapshot.append(chunk.get(), bytes_read);
+    fatal_if(bytes_read < 0, "Read failed on cache warm state file '%s'\n",
+             filepath);
+    fatal_if(gzclose(file),
+             "Close failed on cache warm state file '%s'\n", filepath);
+
+    std::istringstream is(snapshot);
+    tags->unserializeWarmState(is);
 }
 
 
@@ -2049,6 +2253,11 @@ BaseCache::CacheStats::CacheStats(BaseCache &c)
     replacements(this, "replacements", "number of replacements"),
 
     dataExpansions(this, "data_expansions", "number of data expansions"),
+    backdoorFills(this, "backdoor_fills",
+                  "number of fills serviced through the memory backdoor"),
+    backdoorEvictions(this, "backdoor_evictions",
+                      "number of evictions serviced through the memory "
+                      "backdoor"),
     cmd(MemCmd::NUM_MEM_CMDS)
 {
     for (int idx = 0; idx < MemCmd::NUM_MEM_CMDS; ++idx)
@@ -2267,6 +2476,8 @@ BaseCache::CacheStats::regStats()
     }
 
     dataExpansions.flags(nozero | nonan);
+    backdoorFills.flags(nozero);
+    backdoorEvictions.flags(nozero);
 }
 
 void
@@ -57,6 +57,7 @@
 #include "debug/Cache.hh"
 #include "debug/CachePort.hh"
 #include "enums/Clusivity.hh"
+#include "mem/backdoor.hh"
 #include "mem/cache/cache_blk.hh"
 #include "mem/cache/compressors/base.hh"
 #include "mem/cache/mshr_queue.hh"
@@ -78,6 +79,7 @@
 namespace Prefetcher {
     class Base;
 }
+class BasePartitioningPolicy;
 class MSHR;
 class MasterPort;
 class QueueEntry;
@@ -322,6 +324,9 @@ class BaseCache : public ClockedObject
     /** Compression method being used. */
     BaseCacheCompressor* compressor;
 
+    /** Way partitioning policy, notified of every demand access. */
+    BasePartitioningPolicy *partitioningPolicy;
+
     /** Prefetcher */
     Prefetcher::Base *prefetcher;
 
@@ -597,6 +602,41 @@ class BaseCache : public ClockedObject
      */
     virtual void doWritebacksAtomic(PacketList& writebacks) = 0;
 
+    /**
+     * Send an atomic request through the memory-side port. If the
+     * cache is configured to use a backdoor and does not hold one
+     * yet, the memory below is asked to grant one.
+     *
+     * @param pkt The request to send.
+     * @return The latency of the access in ticks.
+     */
+    Tick sendAtomicMemSide(PacketPtr pkt);
+
+    /**
+     * Service an atomic fill request by copying the block out of the
+     * memory backdoor, turning the packet into its response.
+     *
+     * @param pkt The fill request created for a miss.
+     * @return True if the fill was serviced through the backdoor.
+     */
+    bool fillFromBackdoor(PacketPtr pkt);
+
+    /**
+     * Evict a block that was filled through the memory backdoor,
+     * copying its data back if it is dirty. The memory-side crossbar
+     * never saw the fill, so it must not see the eviction either.
+     *
+     * @param blk The block being evicted.
+     * @return True if the eviction needs no writeback packet.
+     */
+    bool evictToBackdoor(CacheBlk *blk);
+
+    /**
+     * Stop using the memory backdoor. Blocks filled through it are
+     * evicted with packets from now on.
+     */
+    void dropBackdoor();
+
     /**
      * Create an appropriate downstream bus request packet.
      *
@@ -708,7 +748,9 @@ class BaseCache : public ClockedObject
     /**
      * Try to evict the given blocks. If any of them is a transient eviction,
      * that is, the block is present in the MSHR queue all evictions are
-     * cancelled since handling such cases has not been implemented.
+     * cancelled since handling such cases has not been implemented. The
+     * same applies to the blocks the tags have to move to make room for
+     * the new block.
      *
      * @param evict_blks Blocks marked for eviction.
      * @param writebacks List for any writebacks that need to be performed.
@@ -813,6 +855,12 @@ class BaseCache : public ClockedObject
      */
     virtual void memInvalidate() override;
 
+    /**
+     * Drop the memory backdoor if the system left atomic mode, as the
+     * backdoor bypasses everything that may be in flight below.
+     */
+    void drainResume() override;
+
     /**
      * Determine if there are any dirty blocks in the cache.
      *
@@ -893,6 +941,24 @@ class BaseCache : public ClockedObject
      */
     const bool isReadOnly;
 
+    /**
+     * Whether checkpoints save and restore the tag array, block data and
+     * replacement state, so that restored simulation starts warm.
+     */
+    const bool checkpointWarmState;
+
+    /** Whether atomic fills are serviced through a memory backdoor. */
+    const bool useBackdoor;
+
+    /**
+     * Backdoor handed out by the memory below on the first atomic
+     * miss when useBackdoor is set, nullptr if none is held.
+     */
+    MemBackdoorPtr backdoor;
+
+    /** Latency charged for a fill serviced through the backdoor. */
+    Cycles backdoorLatency;
+
     /**
      * Bit vector of the blocking reasons for the access path.
      * @sa #BlockedCause
@@ -1066,6 +1132,12 @@ class BaseCache : public ClockedObject
         /** Number of data expansions. */
         Stats::Scalar dataExpansions;
 
+        /** Number of fills serviced through the memory backdoor. */
+        Stats::Scalar backdoorFills;
+
+        /** Number of evictions serviced through the memory backdoor. */
+        Stats::Scalar backdoorEvictions;
+
         /** Per-command statistics */
         std::vector<std::unique_ptr<CacheCmdStats>> cmd;
     } stats;
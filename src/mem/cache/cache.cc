@@ -593,7 +593,10 @@ Cache::handleAtomicReqMiss(PacketPtr pkt, CacheBlk *&blk,
     CacheBlk::State old_state = blk ? blk->status : 0;
 #endif
 
-    Cycles latency = ticksToCycles(memSidePort.sendAtomic(bus_pkt));
+    const bool from_backdoor = !is_forward && fillFromBackdoor(bus_pkt);
+    Cycles latency = from_backdoor ? backdoorLatency :
+        ticksToCycles(is_forward ? memSidePort.sendAtomic(bus_pkt) :
+                      sendAtomicMemSide(bus_pkt));
 
     bool is_invalidate = bus_pkt->isInvalidate();
 
@@ -628,6 +631,11 @@ Cache::handleAtomicReqMiss(PacketPtr pkt, CacheBlk *&blk,
                 // satisfy the upstream request from the cache
                 blk = handleFill(bus_pkt, blk, writebacks,
                                  allocOnFill(pkt->cmd));
+                if (from_backdoor) {
+                    // the crossbar below never saw this fill, so the
+                    // block has to be evicted through the backdoor
+                    blk->status |= BlkBackdoor;
+                }
                 satisfyRequest(pkt, blk);
                 maintainClusivity(pkt->fromCache(), blk);
             } else {
@@ -896,8 +904,11 @@ Cache::serviceMSHRTargets(MSHR *mshr, const PacketPtr pkt, CacheBlk *blk)
 PacketPtr
 Cache::evictBlock(CacheBlk *blk)
 {
-    PacketPtr pkt = (blk->isDirty() || writebackClean) ?
-        writebackBlk(blk) : cleanEvictBlk(blk);
+    PacketPtr pkt = nullptr;
+    if (!evictToBackdoor(blk)) {
+        pkt = (blk->isDirty() || writebackClean) ?
+            writebackBlk(blk) : cleanEvictBlk(blk);
+    }
 
     invalidateBlock(blk);
 
@@ -40,8 +40,29 @@
 
 #include "mem/cache/cache_blk.hh"
 
+#include <cstring>
+
 #include "base/cprintf.hh"
 
+void
+CacheBlk::moveFrom(CacheBlk &other, unsigned blk_size)
+{
+    assert(!isValid());
+    assert(other.isValid());
+
+    tag = other.tag;
+    status = other.status;
+    whenReady = other.whenReady;
+    refCount = other.refCount;
+    srcMasterId = other.srcMasterId;
+    task_id = other.task_id;
+    tickInserted = other.tickInserted;
+    lockList.swap(other.lockList);
+    std::memcpy(data, other.data, blk_size);
+
+    other.invalidate();
+}
+
 void
 CacheBlk::insert(const Addr tag, const bool is_secure,
                  const int src_master_ID, const uint32_t task_ID)
@@ -69,6 +69,8 @@ enum CacheBlkStatusBits : unsigned {
     BlkReadable =       0x04,
     /** dirty (modified) */
     BlkDirty =          0x08,
+    /** block was filled through a memory backdoor */
+    BlkBackdoor =       0x10,
     /** block was a hardware prefetch yet unaccessed*/
     BlkHWPrefetched =   0x20,
     /** block holds data from the secure memory space */
@@ -288,6 +290,17 @@ class CacheBlk : public ReplaceableEntry
         whenReady = tick;
     }
 
+    /**
+     * Move the contents and state of a valid block into this invalid
+     * block, and invalidate the source block. Used by tag stores that
+     * relocate blocks between entries. The data is copied, since every
+     * block owns a fixed data chunk.
+     *
+     * @param other The block to move.
+     * @param blk_size The size of the block data, in bytes.
+     */
+    void moveFrom(CacheBlk &other, unsigned blk_size);
+
     /**
      * Set member variables when a block insertion occurs. Resets reference
      * count to 1 (the insertion counts as a reference), and touch block if
@@ -0,0 +1,52 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+
+class BasePartitioningPolicy(SimObject):
+    type = 'BasePartitioningPolicy'
+    abstract = True
+    cxx_header = "mem/cache/partitioning_policies/base.hh"
+
+class UtilityPartitioning(BasePartitioningPolicy):
+    type = 'UtilityPartitioning'
+    cxx_class = 'UtilityPartitioning'
+    cxx_header = "mem/cache/partitioning_policies/ucp.hh"
+
+    system = Param.System(Parent.any, "System we belong to")
+
+    # Get the geometry from the parent (cache)
+    size = Param.MemorySize(Parent.size, "capacity in bytes")
+    block_size = Param.Int(Parent.cache_line_size, "block size in bytes")
+    assoc = Param.Int(Parent.assoc, "associativity")
+
+    sample_period = Param.Unsigned(32, "Monitor one out of this many sets")
+    repartition_period = Param.Latency('1ms', "Time between two way "
+                                       "allocations")
+    min_ways = Param.Unsigned(1, "Minimum number of ways of each active "
+                              "requestor")
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a common base class for cache partitioning policies.
+ */
+
+#ifndef __MEM_CACHE_PARTITIONING_POLICIES_BASE_HH__
+#define __MEM_CACHE_PARTITIONING_POLICIES_BASE_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/request.hh"
+#include "params/BasePartitioningPolicy.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * A common base class of cache partitioning policy objects. A partitioning
+ * policy observes the demand accesses of every requestor, and restricts
+ * the replacement candidates of an allocation to the entries the requestor
+ * is allowed to replace. The replacement policy then chooses the victim
+ * among the remaining candidates, as usual.
+ */
+class BasePartitioningPolicy : public SimObject
+{
+  public:
+    /**
+     * Convenience typedef.
+     */
+    typedef BasePartitioningPolicyParams Params;
+
+    /**
+     * Construct and initialize this partitioning policy.
+     */
+    BasePartitioningPolicy(const Params *p) : SimObject(p) {}
+
+    /**
+     * Destructor.
+     */
+    virtual ~BasePartitioningPolicy() {}
+
+    /**
+     * Observe a demand access (hit or miss) to the cache.
+     *
+     * @param addr The accessed address.
+     * @param master_id The requestor that issued the access.
+     */
+    virtual void notifyAccess(Addr addr, MasterID master_id) = 0;
+
+    /**
+     * Remove from the replacement candidates of an allocation the entries
+     * that the requestor is not allowed to replace. At least one candidate
+     * must be left.
+     *
+     * @param candidates The replacement candidates, which are cache blocks.
+     * @param master_id The requestor that allocates a block.
+     */
+    virtual void filterCandidates(std::vector<ReplaceableEntry*> &candidates,
+                                  MasterID master_id) const = 0;
+};
+
+#endif // __MEM_CACHE_PARTITIONING_POLICIES_BASE_HH__
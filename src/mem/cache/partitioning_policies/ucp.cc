@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a utility-based cache partitioning policy.
+ */
+
+#include "mem/cache/partitioning_policies/ucp.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/cache_blk.hh"
+#include "sim/system.hh"
+
+UtilityPartitioning::Monitor::Monitor(unsigned num_sets, unsigned assoc)
+    : tags(num_sets * assoc, MaxAddr), hits(assoc, 0), misses(0)
+{
+}
+
+uint64_t
+UtilityPartitioning::Monitor::utility(unsigned ways) const
+{
+    ways = std::min<unsigned>(ways, hits.size());
+    uint64_t sum = 0;
+    for (unsigned i = 0; i < ways; ++i) {
+        sum += hits[i];
+    }
+    return sum;
+}
+
+UtilityPartitioning::UtilityPartitioning(const Params *p)
+    : BasePartitioningPolicy(p), system(p->system), assoc(p->assoc),
+      numSets(p->size / (p->block_size * p->assoc)),
+      setShift(floorLog2(p->block_size)), samplePeriod(p->sample_period),
+      numSampledSets(divCeil(numSets, p->sample_period)),
+      minWays(p->min_ways), repartitionPeriod(p->repartition_period),
+      repartitionEvent([this]{ repartition(); }, name()),
+      stats(*this)
+{
+    fatal_if(samplePeriod == 0, "The UCP sample period must be non-zero");
+    fatal_if(minWays == 0, "Every requestor needs at least one way");
+    fatal_if(repartitionPeriod == 0,
+             "The UCP repartition period must be non-zero");
+}
+
+void
+UtilityPartitioning::startup()
+{
+    schedule(repartitionEvent, curTick() + repartitionPeriod);
+}
+
+void
+UtilityPartitioning::notifyAccess(Addr addr, MasterID master_id)
+{
+    const Addr line = addr >> setShift;
+    const uint32_t set = line % numSets;
+    if (set % samplePeriod) {
+        return;
+    }
+
+    if (master_id >= monitors.size()) {
+        monitors.resize(master_id + 1);
+    }
+    if (!monitors[master_id]) {
+        monitors[master_id].reset(new Monitor(numSampledSets, assoc));
+    }
+    Monitor &monitor = *monitors[master_id];
+
+    // Look the line up in the shadow tags, and move it to the MRU position
+    const auto set_begin = monitor.tags.begin() + (set / samplePeriod) * assoc;
+    const auto set_end = set_begin + assoc;
+    auto it = std::find(set_begin, set_end, line);
+    if (it != set_end) {
+        monitor.hits[it - set_begin]++;
+        if (master_id < stats.monitorHits.size()) {
+            stats.monitorHits[master_id]++;
+        }
+        std::rotate(set_begin, it, it + 1);
+    } else {
+        // Replace the LRU line
+        monitor.misses++;
+        if (master_id < stats.monitorMisses.size()) {
+            stats.monitorMisses[master_id]++;
+        }
+        std::rotate(set_begin, set_end - 1, set_end);
+        *set_begin = line;
+    }
+}
+
+void
+UtilityPartitioning::repartition()
+{
+    // Only the requestors that recently accessed the cache get ways
+    std::vector<MasterID> active;
+    for (MasterID id = 0; id < monitors.size(); ++id) {
+        const Monitor *monitor = monitors[id].get();
+        if (monitor && (monitor->misses || monitor->utility(assoc))) {
+            active.push_back(id);
+        }
+    }
+
+    if (active.empty()) {
+        allocation.clear();
+    } else if (active.size() * minWays > assoc) {
+        warn_once("%s: Too many requestors to give each of them %d ways; "
+                  "leaving the cache unpartitioned.\n", name(), minWays);
+        allocation.clear();
+    } else {
+        allocation.assign(monitors.size(), 0);
+        for (const auto &id : active) {
+            allocation[id] = minWays;
+        }
+
+        // Lookahead: repeatedly give the requestor with the highest
+        // marginal utility (extra hits per extra way) the number of ways
+        // that achieves it
+        unsigned balance = assoc - active.size() * minWays;
+        while (balance > 0) {
+            double best_utility = -1;
+            MasterID winner = active.front();
+            unsigned winner_ways = 1;
+            for (const auto &id : active) {
+                const Monitor &monitor = *monitors[id];
+                const uint64_t base = monitor.utility(allocation[id]);
+                for (unsigned ways = 1; ways <= balance; ++ways) {
+                    const double marginal_utility =
+                        double(monitor.utility(allocation[id] + ways) -
+                               base) / ways;
+                    if (marginal_utility > best_utility) {
+                        best_utility = marginal_utility;
+                        winner = id;
+                        winner_ways = ways;
+                    }
+                }
+            }
+            allocation[winner] += winner_ways;
+            balance -= winner_ways;
+        }
+    }
+
+    stats.repartitions++;
+    for (MasterID id = 0; id < stats.allocatedWays.size(); ++id) {
+        stats.allocatedWays[id] =
+            id < allocation.size() ? allocation[id] : 0;
+    }
+
+    // Halve the monitor counters, so that the next allocation favours
+    // recent behaviour
+    for (auto &monitor : monitors) {
+        if (monitor) {
+            for (auto &hits : monitor->hits) {
+                hits /= 2;
+            }
+            monitor->misses /= 2;
+        }
+    }
+
+    schedule(repartitionEvent, curTick() + repartitionPeriod);
+}
+
+void
+UtilityPartitioning::filterCandidates(
+    std::vector<ReplaceableEntry*> &candidates, MasterID master_id) const
+{
+    if (allocation.empty()) {
+        return;
+    }
+
+    auto blk_master = [](const ReplaceableEntry *entry) {
+        return static_cast<const CacheBlk*>(entry)->srcMasterId;
+    };
+    auto allocated = [this](int id) -> unsigned {
+        return id >= 0 && id < allocation.size() ? allocation[id] : 0;
+    };
+    auto occupancy = [&candidates, &blk_master](int id) -> unsigned {
+        return std::count_if(candidates.begin(), candidates.end(),
+            [&blk_master, id](const ReplaceableEntry *entry) {
+                return blk_master(entry) == id; });
+    };
+
+    std::vector<ReplaceableEntry*> allowed;
+
+    // Free entries are used before considering the allocation
+    for (const auto &entry : candidates) {
+        if (!static_cast<const CacheBlk*>(entry)->isValid()) {
+            allowed.push_back(entry);
+        }
+    }
+
+    const int requestor = master_id;
+    if (!allowed.empty()) {
+        candidates.swap(allowed);
+        return;
+    }
+
+    if (occupancy(requestor) < allocated(requestor)) {
+        // Take a block from a requestor that exceeds its allocation or,
+        // failing that, from any other requestor
+        for (const auto &entry : candidates) {
+            const int id = blk_master(entry);
+            if (id != requestor && occupancy(id) > allocated(id)) {
+                allowed.push_back(entry);
+            }
+        }
+        if (allowed.empty()) {
+            for (const auto &entry : candidates) {
+                if (blk_master(entry) != requestor) {
+                    allowed.push_back(entry);
+                }
+            }
+        }
+    } else {
+        // Replace one of the requestor's own blocks
+        for (const auto &entry : candidates) {
+            if (blk_master(entry) == requestor) {
+                allowed.push_back(entry);
+            }
+        }
+    }
+
+    if (!allowed.empty()) {
+        candidates.swap(allowed);
+    }
+}
+
+UtilityPartitioning::UCPStats::UCPStats(UtilityPartitioning &_policy)
+    : Stats::Group(&_policy),
+    policy(_policy),
+
+    repartitions(this, "repartitions", "Number of way allocations"),
+    allocatedWays(this, "allocated_ways",
+                  "Number of ways allocated to each requestor"),
+    monitorHits(this, "monitor_hits",
+                "Number of hits in the utility monitor of each requestor"),
+    monitorMisses(this, "monitor_misses",
+                  "Number of misses in the utility monitor of each "
+                  "requestor")
+{
+}
+
+void
+UtilityPartitioning::UCPStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    System *system = policy.system;
+
+    allocatedWays
+        .init(system->maxMasters())
+        .flags(nozero)
+        ;
+    monitorHits
+        .init(system->maxMasters())
+        .flags(nozero)
+        ;
+    monitorMisses
+        .init(system->maxMasters())
+        .flags(nozero)
+        ;
+    for (int i = 0; i < system->maxMasters(); i++) {
+        allocatedWays.subname(i, system->getMasterName(i));
+        monitorHits.subname(i, system->getMasterName(i));
+        monitorMisses.subname(i, system->getMasterName(i));
+    }
+}
+
+UtilityPartitioning *
+UtilityPartitioningParams::create()
+{
+    return new UtilityPartitioning(this);
+}
@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a utility-based cache partitioning policy.
+ */
+
+#ifndef __MEM_CACHE_PARTITIONING_POLICIES_UCP_HH__
+#define __MEM_CACHE_PARTITIONING_POLICIES_UCP_HH__
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/cache/partitioning_policies/base.hh"
+#include "params/UtilityPartitioning.hh"
+#include "sim/eventq.hh"
+
+class System;
+
+/**
+ * Utility-based cache partitioning, as proposed in "Utility-Based Cache
+ * Partitioning: A Low-Overhead, High-Performance, Runtime Mechanism to
+ * Partition Shared Caches", from Qureshi and Patt.
+ *
+ * Every requestor has a utility monitor (UMON): an LRU shadow tag
+ * directory of a sample of the sets, as if the requestor had the whole
+ * cache for itself, which counts hits per LRU stack position. The number
+ * of hits a requestor would get with w ways is the sum of the hits of the
+ * first w positions. Periodically, the ways are allocated to the active
+ * requestors with the lookahead algorithm, which maximizes the total
+ * number of hits, and the monitor counters are halved so that old
+ * behaviour fades out.
+ *
+ * The allocation is enforced on replacement: a requestor that holds fewer
+ * blocks in the set than its allocation replaces a block of a requestor
+ * that holds more than its own; otherwise it replaces one of its own
+ * blocks. The cache replacement policy chooses the victim among the
+ * blocks left.
+ */
+class UtilityPartitioning : public BasePartitioningPolicy
+{
+  protected:
+    /** Utility monitor of a requestor. */
+    struct Monitor
+    {
+        Monitor(unsigned num_sets, unsigned assoc);
+
+        /** Shadow tags of the sampled sets, MRU first in each set. */
+        std::vector<Addr> tags;
+
+        /** Number of hits per LRU stack position. */
+        std::vector<uint64_t> hits;
+
+        /** Number of misses. */
+        uint64_t misses;
+
+        /**
+         * Number of hits with the given number of ways.
+         *
+         * @param ways The number of ways.
+         * @return The sum of the hits of the first ways stack positions.
+         */
+        uint64_t utility(unsigned ways) const;
+    };
+
+    /** The system, used to name the requestors. */
+    System *system;
+
+    /** Associativity of the cache. */
+    const unsigned assoc;
+
+    /** Number of sets of the cache. */
+    const unsigned numSets;
+
+    /** Amount to shift an address to get its line address. */
+    const int setShift;
+
+    /** Only one out of every samplePeriod sets is monitored. */
+    const unsigned samplePeriod;
+
+    /** Number of monitored sets. */
+    const unsigned numSampledSets;
+
+    /** Minimum number of ways of each active requestor. */
+    const unsigned minWays;
+
+    /** Time between two way allocations. */
+    const Tick repartitionPeriod;
+
+    /** Utility monitors, indexed by MasterID. Allocated on first use. */
+    std::vector<std::unique_ptr<Monitor>> monitors;
+
+    /**
+     * Ways allocated to each requestor, indexed by MasterID. Empty while
+     * the cache is not partitioned.
+     */
+    std::vector<unsigned> allocation;
+
+    /** Event that periodically reallocates the ways. */
+    EventFunctionWrapper repartitionEvent;
+
+    /**
+     * Allocate the ways to the active requestors, using the lookahead
+     * algorithm on the utility monitors.
+     */
+    void repartition();
+
+    struct UCPStats : public Stats::Group
+    {
+        UCPStats(UtilityPartitioning &policy);
+
+        void regStats() override;
+
+        UtilityPartitioning &policy;
+
+        /** Number of way allocations. */
+        Stats::Scalar repartitions;
+
+        /** Number of ways allocated to each requestor. */
+        Stats::Vector allocatedWays;
+
+        /** Number of hits in the utility monitor of each requestor. */
+        Stats::Vector monitorHits;
+
+        /** Number of misses in the utility monitor of each requestor. */
+        Stats::Vector monitorMisses;
+    } stats;
+
+  public:
+    /** Convenience typedef. */
+    typedef UtilityPartitioningParams Params;
+
+    /**
+     * Construct and initialize this partitioning policy.
+     */
+    UtilityPartitioning(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~UtilityPartitioning() {}
+
+    void startup() override;
+
+    /**
+     * Update the utility monitor of the requestor, if the access maps to
+     * a sampled set.
+     *
+     * @param addr The accessed address.
+     * @param master_id The requestor that issued the access.
+     */
+    void notifyAccess(Addr addr, MasterID master_id) override;
+
+    /**
+     * Keep the blocks the requestor may replace according to its current
+     * way allocation.
+     *
+     * @param candidates The replacement candidates, which are cache blocks.
+     * @param master_id The requestor that allocates a block.
+     */
+    void filterCandidates(std::vector<ReplaceableEntry*> &candidates,
+                          MasterID master_id) const override;
+};
+
+#endif // __MEM_CACHE_PARTITIONING_POLICIES_UCP_HH__
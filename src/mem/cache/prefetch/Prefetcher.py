@@ -521,3 +521,28 @@ class PIFPrefetcher(QueuedPrefetcher):
         if not isinstance(simObj, SimObject):
             raise TypeError("argument must be of SimObject type")
         self.addEvent(HWPProbeEventRetiredInsts(self, simObj,"RetiredInstsPC"))
+
+class PrefetcherEvaluator(SimObject):
+    type = 'PrefetcherEvaluator'
+    cxx_class = 'Prefetcher::Evaluator'
+    cxx_header = "mem/cache/prefetch/evaluator.hh"
+
+    # Replays a binary packet trace, recorded with PCs by a
+    # MemTraceProbe, through each of the prefetchers in a single pass,
+    # without simulating a cache. Each prefetcher fills its own fully
+    # associative LRU model of the cache, and the stats report its
+    # coverage, accuracy and lateness. The simulation exits at the end
+    # of the trace. Queued prefetchers must use physical addresses.
+    system = Param.System(Parent.any, "System the evaluator belongs to")
+    trace_file = Param.String("Binary packet trace to replay")
+    prefetchers = VectorParam.BasePrefetcher("Prefetchers to evaluate")
+    cache_size = Param.MemorySize("1MB",
+        "Size of the cache model of each prefetcher")
+    fill_latency = Param.Latency("100ns",
+        "Latency from the issue of a prefetch to its fill")
+    max_accesses = Param.UInt64(0,
+        "Maximum number of accesses to replay, 0 for the whole trace")
+
+    # Resolves the parameter of the same name of the prefetchers
+    prefetch_on_access = Param.Bool(False,
+        "Notify the prefetchers on every access, not just misses")
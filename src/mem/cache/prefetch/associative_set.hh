@@ -29,6 +29,8 @@
 #ifndef __CACHE_PREFETCH_ASSOCIATIVE_SET_HH__
 #define __CACHE_PREFETCH_ASSOCIATIVE_SET_HH__
 
+#include <vector>
+
 #include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
@@ -132,8 +134,71 @@ class AssociativeSet {
     BaseReplacementPolicy* const replacementPolicy;
     /** Vector containing the entries of the container */
     std::vector<Entry> entries;
+    /**
+     * Entries of the last set looked up. It is reused by every lookup, so
+     * that lookups do not allocate memory.
+     */
+    mutable std::vector<ReplaceableEntry *> candidates;
 
   public:
+    /**
+     * Lightweight view over the entries of a set. It refers to the
+     * storage of the container and is only valid until the next lookup.
+     */
+    class EntryRange
+    {
+        /** First entry of the range */
+        ReplaceableEntry * const *first;
+        /** One past the last entry of the range */
+        ReplaceableEntry * const *last;
+
+      public:
+        /** Iterator returning the entries with their actual type */
+        class iterator
+        {
+            ReplaceableEntry * const *pos;
+
+          public:
+            explicit iterator(ReplaceableEntry * const *p) : pos(p) {}
+
+            Entry *operator*() const { return static_cast<Entry *>(*pos); }
+
+            iterator &
+            operator++()
+            {
+                ++pos;
+                return *this;
+            }
+
+            bool
+            operator!=(const iterator &other) const
+            {
+                return pos != other.pos;
+            }
+        };
+
+        EntryRange(ReplaceableEntry * const *f, ReplaceableEntry * const *l)
+          : first(f), last(l)
+        {}
+
+        iterator begin() const { return iterator(first); }
+        iterator end() const { return iterator(last); }
+
+        /** @return the number of entries in the range */
+        size_t size() const { return last - first; }
+
+        /**
+         * Access an entry of the range
+         * @param idx position of the entry within the range
+         * @return the entry
+         */
+        Entry *
+        operator[](size_t idx) const
+        {
+            return static_cast<Entry *>(first[idx]);
+        }
+    };
+
     /**
      * Public constructor
      * @param assoc number of elements in each associative set
@@ -172,11 +237,13 @@ class AssociativeSet {
 
     /**
      * Find the set of entries that could be replaced given
-     * that we want to add a new entry with the provided key
+     * that we want to add a new entry with the provided key. The
+     * returned range is only valid until the next lookup in the
+     * container.
      * @param addr key to select the set of entries
-     * @result vector of candidates matching with the provided key
+     * @result range of candidates matching with the provided key
      */
-    std::vector<Entry *> getPossibleEntries(const Addr addr) const;
+    EntryRange getPossibleEntries(const Addr addr) const;
 
     /**
      * Indicate that an entry has just been inserted
@@ -48,6 +48,7 @@ AssociativeSet<Entry>::AssociativeSet(int assoc, int num_entries,
         indexingPolicy->setEntry(entry, entry_idx);
         entry->replacementData = replacementPolicy->instantiateEntry();
     }
+    candidates.reserve(assoc);
 }
 
 template<class Entry>
@@ -55,10 +56,9 @@ Entry*
 AssociativeSet<Entry>::findEntry(Addr addr, bool is_secure) const
 {
     Addr tag = indexingPolicy->extractTag(addr);
-    const std::vector<ReplaceableEntry*> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    indexingPolicy->gatherPossibleEntries(addr, candidates);
 
-    for (const auto& location : selected_entries) {
+    for (const auto& location : candidates) {
         Entry* entry = static_cast<Entry *>(location);
         if ((entry->getTag() == tag) && entry->isValid() &&
             entry->isSecure() == is_secure) {
@@ -80,10 +80,9 @@ Entry*
 AssociativeSet<Entry>::findVictim(Addr addr)
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    indexingPolicy->gatherPossibleEntries(addr, candidates);
     Entry* victim = static_cast<Entry*>(replacementPolicy->getVictim(
-                            selected_entries));
+                            candidates));
     // There is only one eviction for this replacement
     invalidate(victim);
     return victim;
@@ -91,18 +90,12 @@ AssociativeSet<Entry>::findVictim(Addr addr)
 
 
 template<class Entry>
-std::vector<Entry *>
+typename AssociativeSet<Entry>::EntryRange
 AssociativeSet<Entry>::getPossibleEntries(const Addr addr) const
 {
-    std::vector<ReplaceableEntry *> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
-    std::vector<Entry *> entries(selected_entries.size(), nullptr);
-
-    unsigned int idx = 0;
-    for (auto &entry : selected_entries) {
-        entries[idx++] = static_cast<Entry *>(entry);
-    }
-    return entries;
+    indexingPolicy->gatherPossibleEntries(addr, candidates);
+    return EntryRange(candidates.data(),
+                      candidates.data() + candidates.size());
 }
 
 template<class Entry>
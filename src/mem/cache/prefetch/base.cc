@@ -55,6 +55,40 @@
 
 namespace Prefetcher {
 
+namespace
+{
+
+/** Forwards the queries of a prefetcher to its parent cache. */
+class ParentCacheAccessor : public CacheAccessor
+{
+    const BaseCache &cache;
+
+  public:
+    ParentCacheAccessor(const BaseCache &_cache) : cache(_cache) {}
+
+    bool
+    inCache(Addr addr, bool is_secure) const override
+    {
+        return cache.inCache(addr, is_secure);
+    }
+
+    bool
+    inMissQueue(Addr addr, bool is_secure) const override
+    {
+        return cache.inMissQueue(addr, is_secure);
+    }
+
+    bool
+    hasBeenPrefetched(Addr addr, bool is_secure) const override
+    {
+        return cache.hasBeenPrefetched(addr, is_secure);
+    }
+
+    bool coalesce() const override { return cache.coalesce(); }
+};
+
+} // anonymous namespace
+
 Base::PrefetchInfo::PrefetchInfo(PacketPtr pkt, Addr addr, bool miss)
   : address(addr), pc(pkt->req->hasPC() ? pkt->req->getPC() : 0),
     masterId(pkt->req->masterId()), validPC(pkt->req->hasPC()),
@@ -89,7 +123,8 @@ Base::PrefetchListener::notify(const PacketPtr &pkt)
 }
 
 Base::Base(const BasePrefetcherParams *p)
-    : ClockedObject(p), listeners(), cache(nullptr), blkSize(p->block_size),
+    : ClockedObject(p), listeners(), cache(nullptr), accessor(nullptr),
+      blkSize(p->block_size),
       lBlkSize(floorLog2(blkSize)), onMiss(p->on_miss), onRead(p->on_read),
       onWrite(p->on_write), onData(p->on_data), onInst(p->on_inst),
       masterId(p->sys->getMasterId(this)), pageBytes(p->sys->getPageBytes()),
@@ -108,6 +143,16 @@ Base::setCache(BaseCache *_cache)
     // If the cache has a different block size from the system's, save it
     blkSize = cache->getBlockSize();
     lBlkSize = floorLog2(blkSize);
+
+    parentCacheAccessor.reset(new ParentCacheAccessor(*cache));
+    setCacheAccessor(parentCacheAccessor.get());
+}
+
+void
+Base::setCacheAccessor(const CacheAccessor *_accessor)
+{
+    assert(!accessor);
+    accessor = _accessor;
 }
 
 void
@@ -147,19 +192,19 @@ Base::observeAccess(const PacketPtr &pkt, bool miss) const
 bool
 Base::inCache(Addr addr, bool is_secure) const
 {
-    return cache->inCache(addr, is_secure);
+    return accessor->inCache(addr, is_secure);
 }
 
 bool
 Base::inMissQueue(Addr addr, bool is_secure) const
 {
-    return cache->inMissQueue(addr, is_secure);
+    return accessor->inMissQueue(addr, is_secure);
 }
 
 bool
 Base::hasBeenPrefetched(Addr addr, bool is_secure) const
 {
-    return cache->hasBeenPrefetched(addr, is_secure);
+    return accessor->hasBeenPrefetched(addr, is_secure);
 }
 
 bool
@@ -205,7 +250,7 @@ Base::probeNotify(const PacketPtr &pkt, bool miss)
     // operations or for writes that we are coaslescing.
     if (pkt->cmd.isSWPrefetch()) return;
     if (pkt->req->isCacheMaintenance()) return;
-    if (pkt->isWrite() && cache != nullptr && cache->coalesce()) return;
+    if (pkt->isWrite() && accessor && accessor->coalesce()) return;
     if (!pkt->req->hasPaddr()) {
         panic("Request must have a physical address");
     }
@@ -47,6 +47,7 @@
 #define __MEM_CACHE_PREFETCH_BASE_HH__
 
 #include <cstdint>
+#include <memory>
 
 #include "arch/isa_traits.hh"
 #include "arch/generic/tlb.hh"
@@ -63,6 +64,30 @@ struct BasePrefetcherParams;
 
 namespace Prefetcher {
 
+/**
+ * The cache state a prefetcher consults to filter its candidates. The
+ * parent cache of a prefetcher answers these queries by default; other
+ * drivers of a prefetcher, such as the offline evaluator, provide
+ * their own model of the cache.
+ */
+class CacheAccessor
+{
+  public:
+    virtual ~CacheAccessor() = default;
+
+    /** Determine if address is in cache */
+    virtual bool inCache(Addr addr, bool is_secure) const = 0;
+
+    /** Determine if address is in cache miss queue */
+    virtual bool inMissQueue(Addr addr, bool is_secure) const = 0;
+
+    /** Determine if address has been prefetched and not used yet */
+    virtual bool hasBeenPrefetched(Addr addr, bool is_secure) const = 0;
+
+    /** Determine if writes are coalesced, and hidden from prefetchers */
+    virtual bool coalesce() const = 0;
+};
+
 class Base : public ClockedObject
 {
     class PrefetchListener : public ProbeListenerArgBase<PacketPtr>
@@ -259,6 +284,12 @@ class Base : public ClockedObject
     /** Pointr to the parent cache. */
     BaseCache* cache;
 
+    /** Cache state consulted by the prefetcher. */
+    const CacheAccessor *accessor;
+
+    /** Accessor to the parent cache, if any. */
+    std::unique_ptr<CacheAccessor> parentCacheAccessor;
+
     /** The block size of the parent cache. */
     unsigned blkSize;
 
@@ -335,6 +366,13 @@ class Base : public ClockedObject
 
     virtual void setCache(BaseCache *_cache);
 
+    /**
+     * Use a model of the cache state instead of a parent cache, to
+     * drive the prefetcher without simulating a cache.
+     * @param _accessor The cache state the prefetcher consults
+     */
+    virtual void setCacheAccessor(const CacheAccessor *_accessor);
+
     /**
      * Notify prefetcher of cache access (may be any access or just
      * misses, depending on cache parameters.)
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/evaluator.hh"
+
+#include <algorithm>
+
+#include "base/output.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/request.hh"
+#include "params/BasePrefetcher.hh"
+#include "params/PrefetcherEvaluator.hh"
+#include "sim/sim_exit.hh"
+#include "sim/system.hh"
+
+namespace Prefetcher {
+
+Evaluator::CacheModel::Block *
+Evaluator::CacheModel::findBlock(Addr addr, bool is_secure) const
+{
+    const auto it = blockMap.find(key(addr, is_secure));
+    return it == blockMap.end() ? nullptr : &*it->second;
+}
+
+void
+Evaluator::CacheModel::touch(Block *blk)
+{
+    const auto it = blockMap.find(key(blk->addr, blk->secure));
+    assert(it != blockMap.end());
+    blocks.splice(blocks.begin(), blocks, it->second);
+}
+
+bool
+Evaluator::CacheModel::insert(Addr addr, bool is_secure, Tick ready,
+                              bool prefetched)
+{
+    bool evicted_unused = false;
+    if (blocks.size() == numBlocks) {
+        const Block &victim = blocks.back();
+        evicted_unused = victim.prefetched;
+        blockMap.erase(key(victim.addr, victim.secure));
+        blocks.pop_back();
+    }
+
+    blocks.push_front({addr & ~Addr(blkSize - 1), is_secure, ready,
+                       prefetched});
+    blockMap[key(addr, is_secure)] = blocks.begin();
+    return evicted_unused;
+}
+
+bool
+Evaluator::CacheModel::inCache(Addr addr, bool is_secure) const
+{
+    const Block *blk = findBlock(addr, is_secure);
+    return blk && blk->ready <= curTick();
+}
+
+bool
+Evaluator::CacheModel::inMissQueue(Addr addr, bool is_secure) const
+{
+    const Block *blk = findBlock(addr, is_secure);
+    return blk && blk->ready > curTick();
+}
+
+bool
+Evaluator::CacheModel::hasBeenPrefetched(Addr addr, bool is_secure) const
+{
+    const Block *blk = findBlock(addr, is_secure);
+    return blk && blk->prefetched;
+}
+
+Evaluator::Evaluator(const PrefetcherEvaluatorParams *p)
+  : SimObject(p), system(p->system), trace(simout.resolve(p->trace_file)),
+    prefetchers(p->prefetchers), fillLatency(p->fill_latency),
+    maxAccesses(p->max_accesses), masterId(p->system->getMasterId(this)),
+    haveNextRecord(false), traceStart(0), replayStart(0), numAccesses(0),
+    accessEvent([this]{ processAccesses(); }, name())
+{
+    fatal_if(prefetchers.empty(), "%s: No prefetcher to evaluate\n",
+             name());
+
+    // Queued prefetchers translate virtual addresses through the thread
+    // contexts of their parent cache, which they do not have here.
+    for (const Base *pf : prefetchers) {
+        const auto *pf_params =
+            dynamic_cast<const BasePrefetcherParams *>(pf->params());
+        fatal_if(dynamic_cast<const Queued *>(pf) &&
+                 pf_params->use_virtual_addresses,
+                 "%s: %s uses virtual addresses, which queued prefetchers "
+                 "cannot translate without a parent cache\n", name(),
+                 pf->name());
+    }
+
+    const unsigned blk_size = system->cacheLineSize();
+    const unsigned num_blocks = p->cache_size / blk_size;
+    fatal_if(num_blocks == 0, "%s: The cache model must hold at least "
+             "one block\n", name());
+
+    for (int i = 0; i < prefetchers.size(); ++i)
+        models.emplace_back(new CacheModel(num_blocks, blk_size));
+}
+
+void
+Evaluator::init()
+{
+    SimObject::init();
+
+    for (int i = 0; i < prefetchers.size(); ++i)
+        prefetchers[i]->setCacheAccessor(models[i].get());
+}
+
+void
+Evaluator::startup()
+{
+    haveNextRecord = trace.read(nextRecord);
+    if (!haveNextRecord) {
+        warn("%s: The trace is empty\n", name());
+        exitSimLoop("prefetcher evaluation complete");
+        return;
+    }
+
+    // replay the trace with its original timing, starting now
+    traceStart = nextRecord.tick;
+    replayStart = curTick();
+    schedule(accessEvent, curTick());
+}
+
+void
+Evaluator::regStats()
+{
+    SimObject::regStats();
+
+    demandAccesses
+        .name(name() + ".demandAccesses")
+        .desc("Number of demand accesses replayed")
+        ;
+
+    demandHits
+        .init(prefetchers.size())
+        .name(name() + ".demandHits")
+        .desc("Number of accesses to blocks filled by a demand access")
+        ;
+
+    timelyHits
+        .init(prefetchers.size())
+        .name(name() + ".timelyHits")
+        .desc("Number of accesses to prefetched blocks already filled")
+        ;
+
+    lateHits
+        .init(prefetchers.size())
+        .name(name() + ".lateHits")
+        .desc("Number of accesses to prefetched blocks still in flight")
+        ;
+
+    uncovered
+        .init(prefetchers.size())
+        .name(name() + ".uncovered")
+        .desc("Number of accesses to blocks not prefetched")
+        ;
+
+    issued
+        .init(prefetchers.size())
+        .name(name() + ".issued")
+        .desc("Number of prefetches issued")
+        ;
+
+    unusedEvicted
+        .init(prefetchers.size())
+        .name(name() + ".unusedEvicted")
+        .desc("Number of prefetched blocks evicted without being used")
+        ;
+
+    coverage
+        .name(name() + ".coverage")
+        .desc("Fraction of the misses covered by prefetches")
+        ;
+    coverage = (timelyHits + lateHits) / (timelyHits + lateHits + uncovered);
+
+    accuracy
+        .name(name() + ".accuracy")
+        .desc("Fraction of the prefetches used by demand accesses")
+        ;
+    accuracy = (timelyHits + lateHits) / issued;
+
+    lateness
+        .name(name() + ".lateness")
+        .desc("Fraction of the used prefetches arriving late")
+        ;
+    lateness = lateHits / (timelyHits + lateHits);
+
+    for (int i = 0; i < prefetchers.size(); ++i) {
+        const std::string &pf_name = prefetchers[i]->name();
+        demandHits.subname(i, pf_name);
+        timelyHits.subname(i, pf_name);
+        lateHits.subname(i, pf_name);
+        uncovered.subname(i, pf_name);
+        issued.subname(i, pf_name);
+        unusedEvicted.subname(i, pf_name);
+    }
+}
+
+void
+Evaluator::processAccesses()
+{
+    while (haveNextRecord && recordTick(nextRecord) <= curTick()) {
+        RequestPtr req = std::make_shared<Request>(
+            nextRecord.addr, nextRecord.size, nextRecord.flags, masterId);
+        if (nextRecord.pc)
+            req->setPC(nextRecord.pc);
+
+        Packet pkt(req, MemCmd(nextRecord.cmd));
+        // prefetchers may look at the data of the access
+        pkt.allocate();
+        std::fill_n(pkt.getPtr<uint8_t>(), pkt.getSize(), 0);
+
+        for (int i = 0; i < prefetchers.size(); ++i)
+            access(i, &pkt);
+
+        ++demandAccesses;
+        ++numAccesses;
+        haveNextRecord = (!maxAccesses || numAccesses < maxAccesses) &&
+            trace.read(nextRecord);
+    }
+
+    if (haveNextRecord)
+        schedule(accessEvent, recordTick(nextRecord));
+    else
+        exitSimLoop("prefetcher evaluation complete");
+}
+
+void
+Evaluator::issuePrefetches(int idx)
+{
+    Base *pf = prefetchers[idx];
+    CacheModel &model = *models[idx];
+
+    Tick ready;
+    while ((ready = pf->nextPrefetchReadyTime()) <= curTick()) {
+        PacketPtr pf_pkt = pf->getPacket();
+        if (!pf_pkt)
+            break;
+
+        ++issued[idx];
+        if (!model.findBlock(pf_pkt->getAddr(), pf_pkt->isSecure()) &&
+            model.insert(pf_pkt->getAddr(), pf_pkt->isSecure(),
+                         ready + fillLatency, true)) {
+            ++unusedEvicted[idx];
+        }
+        delete pf_pkt;
+    }
+}
+
+void
+Evaluator::access(int idx, const PacketPtr &pkt)
+{
+    issuePrefetches(idx);
+
+    CacheModel &model = *models[idx];
+    CacheModel::Block *blk = model.findBlock(pkt->getAddr(), pkt->isSecure());
+    const bool miss = !blk || blk->ready > curTick();
+
+    // notify before updating the model, so that the prefetcher sees
+    // whether the access used one of its prefetches
+    prefetchers[idx]->probeNotify(pkt, miss);
+
+    if (!blk) {
+        ++uncovered[idx];
+        if (model.insert(pkt->getAddr(), pkt->isSecure(),
+                         curTick() + fillLatency, false)) {
+            ++unusedEvicted[idx];
+        }
+        return;
+    }
+
+    if (blk->prefetched) {
+        if (miss)
+            ++lateHits[idx];
+        else
+            ++timelyHits[idx];
+        blk->prefetched = false;
+    } else {
+        ++demandHits[idx];
+    }
+    model.touch(blk);
+}
+
+} // namespace Prefetcher
+
+Prefetcher::Evaluator*
+PrefetcherEvaluatorParams::create()
+{
+    return new Prefetcher::Evaluator(this);
+}
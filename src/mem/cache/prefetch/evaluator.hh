@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Offline evaluation of prefetchers on recorded access streams.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_EVALUATOR_HH__
+#define __MEM_CACHE_PREFETCH_EVALUATOR_HH__
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/cache/prefetch/base.hh"
+#include "mem/packet_trace.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+struct PrefetcherEvaluatorParams;
+class System;
+
+namespace Prefetcher {
+
+/**
+ * The evaluator replays a binary packet trace, e.g. the demand misses
+ * of a cache, through a set of prefetchers without simulating a cache
+ * or a memory. Each prefetcher is given its own model of the cache: a
+ * fully associative LRU array filled by the demand misses of the trace
+ * and by the prefetches issued, which reach the array a fixed latency
+ * after the prefetcher makes them available. The trace is replayed at
+ * the ticks it was recorded at, in a single pass for all prefetchers,
+ * and the statistics report for each one how many of the demand misses
+ * it covered, how many of its prefetches were useful, and how many
+ * arrived too late to hide the whole miss latency.
+ */
+class Evaluator : public SimObject
+{
+  public:
+    Evaluator(const PrefetcherEvaluatorParams *p);
+
+    void init() override;
+
+    void startup() override;
+
+    void regStats() override;
+
+  protected:
+    /**
+     * The cache model seen by one of the prefetchers.
+     */
+    class CacheModel : public CacheAccessor
+    {
+      public:
+        CacheModel(unsigned num_blocks, unsigned blk_size)
+          : numBlocks(num_blocks), blkSize(blk_size)
+        {}
+
+        /** State of a block in the cache model */
+        struct Block
+        {
+            /** Address of the block */
+            Addr addr;
+            /** Whether the block is in the secure space */
+            bool secure;
+            /** Tick at which the data of the block is available */
+            Tick ready;
+            /** Whether the block was prefetched and not used yet */
+            bool prefetched;
+        };
+
+        /**
+         * Find a block of the model.
+         * @param addr Address within the block
+         * @param is_secure Whether the address is in the secure space
+         * @return The block, or nullptr if it is not in the model
+         */
+        Block *findBlock(Addr addr, bool is_secure) const;
+
+        /**
+         * Make a block the most recently used one.
+         * @param blk The block to touch
+         */
+        void touch(Block *blk);
+
+        /**
+         * Insert a block as the most recently used one, evicting the
+         * least recently used block if the model is full.
+         * @param addr Address within the block
+         * @param is_secure Whether the address is in the secure space
+         * @param ready Tick at which the data of the block is available
+         * @param prefetched Whether the block is filled by a prefetch
+         * @return True if an unused prefetched block was evicted
+         */
+        bool insert(Addr addr, bool is_secure, Tick ready, bool prefetched);
+
+        bool inCache(Addr addr, bool is_secure) const override;
+        bool inMissQueue(Addr addr, bool is_secure) const override;
+        bool hasBeenPrefetched(Addr addr, bool is_secure) const override;
+        bool coalesce() const override { return false; }
+
+      private:
+        /** @return the key of a block in the lookup table */
+        Addr
+        key(Addr addr, bool is_secure) const
+        {
+            return (addr & ~Addr(blkSize - 1)) | is_secure;
+        }
+
+        /** Capacity of the model in blocks */
+        const unsigned numBlocks;
+        /** Size of a block in bytes */
+        const unsigned blkSize;
+        /** Blocks in LRU order, most recently used first */
+        std::list<Block> blocks;
+        /** Lookup table of the blocks */
+        std::unordered_map<Addr, std::list<Block>::iterator> blockMap;
+    };
+
+    /** Replay the trace records due at the current tick. */
+    void processAccesses();
+
+    /**
+     * Issue the prefetches a prefetcher has made available by now
+     * into its cache model.
+     * @param idx Index of the prefetcher
+     */
+    void issuePrefetches(int idx);
+
+    /**
+     * Replay an access through a prefetcher and its cache model.
+     * @param idx Index of the prefetcher
+     * @param pkt The demand access
+     */
+    void access(int idx, const PacketPtr &pkt);
+
+    /** System providing the master id of the demand accesses */
+    System *system;
+
+    /** The trace being replayed */
+    PacketTraceInputStream trace;
+
+    /** Prefetchers being evaluated */
+    const std::vector<Base *> prefetchers;
+
+    /** Cache model of each prefetcher */
+    std::vector<std::unique_ptr<CacheModel>> models;
+
+    /** Latency between the issue of a prefetch and its fill */
+    const Tick fillLatency;
+
+    /** Maximum number of accesses to replay, 0 for the whole trace */
+    const uint64_t maxAccesses;
+
+    /** Master id of the demand accesses */
+    MasterID masterId;
+
+    /** Next record of the trace */
+    PacketTraceRecord nextRecord;
+
+    /** Whether nextRecord holds a record to replay */
+    bool haveNextRecord;
+
+    /** Tick of the first record of the trace */
+    Tick traceStart;
+
+    /** Tick at which the replay started */
+    Tick replayStart;
+
+    /**
+     * @param record A trace record
+     * @return The tick at which the record is replayed
+     */
+    Tick
+    recordTick(const PacketTraceRecord &record) const
+    {
+        return replayStart + (record.tick > traceStart ?
+                              record.tick - traceStart : 0);
+    }
+
+    /** Number of accesses replayed */
+    uint64_t numAccesses;
+
+    /** Event replaying the accesses due at the current tick */
+    EventFunctionWrapper accessEvent;
+
+    /** Stat for the number of demand accesses replayed. */
+    Stats::Scalar demandAccesses;
+    /** Stat for the accesses hitting on a demand-filled block. */
+    Stats::Vector demandHits;
+    /** Stat for the accesses hitting on a prefetched block in time. */
+    Stats::Vector timelyHits;
+    /** Stat for the accesses hitting on a prefetch still in flight. */
+    Stats::Vector lateHits;
+    /** Stat for the accesses not covered by any prefetch. */
+    Stats::Vector uncovered;
+    /** Stat for the number of prefetches issued. */
+    Stats::Vector issued;
+    /** Stat for the prefetched blocks evicted without being used. */
+    Stats::Vector unusedEvicted;
+    /** Stat for the fraction of the misses covered by prefetches. */
+    Stats::Formula coverage;
+    /** Stat for the fraction of the prefetches that were used. */
+    Stats::Formula accuracy;
+    /** Stat for the fraction of the used prefetches that were late. */
+    Stats::Formula lateness;
+};
+
+} // namespace Prefetcher
+
+#endif //__MEM_CACHE_PREFETCH_EVALUATOR_HH__
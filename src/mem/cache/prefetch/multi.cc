@@ -54,6 +54,13 @@ Multi::setCache(BaseCache *_cache)
         pf->setCache(_cache);
 }
 
+void
+Multi::setCacheAccessor(const CacheAccessor *_accessor)
+{
+    for (auto pf : prefetchers)
+        pf->setCacheAccessor(_accessor);
+}
+
 Tick
 Multi::nextPrefetchReadyTime() const
 {
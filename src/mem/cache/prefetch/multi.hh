@@ -51,6 +51,7 @@ class Multi : public Base
 
   public:
     void setCache(BaseCache *_cache) override;
+    void setCacheAccessor(const CacheAccessor *_accessor) override;
     PacketPtr getPacket() override;
     Tick nextPrefetchReadyTime() const override;
 
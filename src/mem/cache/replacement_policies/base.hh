@@ -29,8 +29,11 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 
+#include <istream>
 #include <memory>
+#include <ostream>
 
+#include "base/sat_counter.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "params/BaseReplacementPolicy.hh"
 #include "sim/sim_object.hh"
@@ -100,6 +103,98 @@ class BaseReplacementPolicy : public SimObject
      * @return A shared pointer to the new replacement data.
      */
     virtual std::shared_ptr<ReplacementData> instantiateEntry() = 0;
+
+    /**
+     * Check whether the replacement state of an entry only makes sense in
+     * the set the entry belongs to, e.g., because it is shared by all the
+     * entries of the set. Tags that move blocks across sets can't carry
+     * such state along with the block.
+     *
+     * @return True if the replacement state is bound to a set.
+     */
+    virtual bool isSetBound() const { return false; }
+
+    /**
+     * Write the replacement data of an entry to a cache warmup snapshot.
+     * Policies keeping per-entry state extend this, calling the base
+     * version first to save the fields common to all replacement data.
+     *
+     * @param replacement_data Replacement data to be saved.
+     * @param os Binary stream holding the snapshot.
+     */
+    virtual void
+    serializeEntry(const std::shared_ptr<ReplacementData>& replacement_data,
+                   std::ostream &os) const
+    {
+        saveField(os, replacement_data->setindex);
+        saveField(os, replacement_data->tag);
+        saveField(os, replacement_data->pc);
+    }
+
+    /**
+     * Restore the replacement data of an entry from a cache warmup
+     * snapshot written by serializeEntry().
+     *
+     * @param replacement_data Replacement data to be restored.
+     * @param is Binary stream holding the snapshot.
+     */
+    virtual void
+    unserializeEntry(const std::shared_ptr<ReplacementData>& replacement_data,
+                     std::istream &is) const
+    {
+        loadField(is, replacement_data->setindex);
+        loadField(is, replacement_data->tag);
+        loadField(is, replacement_data->pc);
+    }
+
+    /**
+     * Write the state shared by all entries, such as prediction tables or
+     * set-dueling counters, to a cache warmup snapshot.
+     *
+     * @param os Binary stream holding the snapshot.
+     */
+    virtual void serializeState(std::ostream &os) const {}
+
+    /**
+     * Restore the state shared by all entries from a cache warmup snapshot.
+     *
+     * @param is Binary stream holding the snapshot.
+     */
+    virtual void unserializeState(std::istream &is) {}
+
+  protected:
+    /** Append the raw bytes of a value to a snapshot. */
+    template <class T>
+    static void
+    saveField(std::ostream &os, const T &value)
+    {
+        os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    /** Read back a value appended with saveField(). */
+    template <class T>
+    static void
+    loadField(std::istream &is, T &value)
+    {
+        is.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    /** Append the value of a saturating counter to a snapshot. */
+    static void
+    saveCounter(std::ostream &os, const SatCounter &counter)
+    {
+        saveField(os, static_cast<uint16_t>(counter));
+    }
+
+    /** Read back a saturating counter appended with saveCounter(). */
+    static void
+    loadCounter(std::istream &is, SatCounter &counter)
+    {
+        uint16_t value;
+        loadField(is, value);
+        counter -= static_cast<uint16_t>(counter);
+        counter += value;
+    }
 };
 
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
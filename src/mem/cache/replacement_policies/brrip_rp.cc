@@ -142,6 +142,30 @@ BRRIPRP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new BRRIPReplData(numRRPVBits));
 }
 
+void
+BRRIPRP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<BRRIPReplData> casted_replacement_data =
+        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    saveCounter(os, casted_replacement_data->rrpv);
+    saveField(os, casted_replacement_data->valid);
+}
+
+void
+BRRIPRP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<BRRIPReplData> casted_replacement_data =
+        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    loadCounter(is, casted_replacement_data->rrpv);
+    loadField(is, casted_replacement_data->valid);
+}
+
 BRRIPRP*
 BRRIPRPParams::create()
 {
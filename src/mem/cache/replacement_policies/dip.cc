@@ -85,6 +85,18 @@ DIPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
     }
 }
 
+void
+DIPRP::serializeState(std::ostream &os) const
+{
+    saveCounter(os, PSEL);
+}
+
+void
+DIPRP::unserializeState(std::istream &is)
+{
+    loadCounter(is, PSEL);
+}
+
 DIPRP*
 DIPRPParams::create()
 {
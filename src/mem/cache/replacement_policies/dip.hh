@@ -86,6 +86,17 @@ class DIPRP : public BIPRP
      */
     void reset(const std::shared_ptr<ReplacementData>& replacement_data) const
                                                                      override;
+    /**
+     * Save and restore the set-dueling PSEL counter in cache warmup snapshots.
+     */
+    void serializeState(std::ostream &os) const override;
+    void unserializeState(std::istream &is) override;
+
+    /**
+     * Set dueling relies on the blocks of each dedicated set being managed
+     * by the policy of that set.
+     */
+    bool isSetBound() const override { return true; }
 };
 
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_DIP_RP_HH__
@@ -107,6 +107,18 @@ DRRIPRP::reset(const std::shared_ptr<ReplacementData>& replacement_data) const
     }
 }
 
+void
+DRRIPRP::serializeState(std::ostream &os) const
+{
+    saveCounter(os, PSEL);
+}
+
+void
+DRRIPRP::unserializeState(std::istream &is)
+{
+    loadCounter(is, PSEL);
+}
+
 DRRIPRP*
 DRRIPRPParams::create()
 {
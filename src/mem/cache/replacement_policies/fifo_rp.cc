@@ -88,6 +88,28 @@ FIFORP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new FIFOReplData());
 }
 
+void
+FIFORP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<FIFOReplData> casted_replacement_data =
+        std::static_pointer_cast<FIFOReplData>(replacement_data);
+    saveField(os, casted_replacement_data->tickInserted);
+}
+
+void
+FIFORP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<FIFOReplData> casted_replacement_data =
+        std::static_pointer_cast<FIFOReplData>(replacement_data);
+    loadField(is, casted_replacement_data->tickInserted);
+}
+
 FIFORP*
 FIFORPParams::create()
 {
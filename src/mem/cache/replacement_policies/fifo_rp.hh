@@ -112,6 +112,15 @@ class FIFORP : public BaseReplacementPolicy
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /**
+     * Save and restore the insertion tick of an entry in cache warmup
+     * snapshots.
+     */
+    void serializeEntry(const std::shared_ptr<ReplacementData>&
+                        replacement_data, std::ostream &os) const override;
+    void unserializeEntry(const std::shared_ptr<ReplacementData>&
+                          replacement_data, std::istream &is) const override;
 };
 
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_FIFO_RP_HH__
@@ -87,6 +87,28 @@ LFURP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new LFUReplData());
 }
 
+void
+LFURP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<LFUReplData> casted_replacement_data =
+        std::static_pointer_cast<LFUReplData>(replacement_data);
+    saveField(os, casted_replacement_data->refCount);
+}
+
+void
+LFURP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<LFUReplData> casted_replacement_data =
+        std::static_pointer_cast<LFUReplData>(replacement_data);
+    loadField(is, casted_replacement_data->refCount);
+}
+
 LFURP*
 LFURPParams::create()
 {
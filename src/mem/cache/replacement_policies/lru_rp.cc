@@ -90,6 +90,28 @@ LRURP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new LRUReplData());
 }
 
+void
+LRURP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<LRUReplData> casted_replacement_data =
+        std::static_pointer_cast<LRUReplData>(replacement_data);
+    saveField(os, casted_replacement_data->lastTouchTick);
+}
+
+void
+LRURP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<LRUReplData> casted_replacement_data =
+        std::static_pointer_cast<LRUReplData>(replacement_data);
+    loadField(is, casted_replacement_data->lastTouchTick);
+}
+
 LRURP*
 LRURPParams::create()
 {
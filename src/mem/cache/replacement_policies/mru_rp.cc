@@ -95,6 +95,28 @@ MRURP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new MRUReplData());
 }
 
+void
+MRURP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<MRUReplData> casted_replacement_data =
+        std::static_pointer_cast<MRUReplData>(replacement_data);
+    saveField(os, casted_replacement_data->lastTouchTick);
+}
+
+void
+MRURP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<MRUReplData> casted_replacement_data =
+        std::static_pointer_cast<MRUReplData>(replacement_data);
+    loadField(is, casted_replacement_data->lastTouchTick);
+}
+
 MRURP*
 MRURPParams::create()
 {
@@ -90,6 +90,28 @@ RandomRP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new RandomReplData());
 }
 
+void
+RandomRP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<RandomReplData> casted_replacement_data =
+        std::static_pointer_cast<RandomReplData>(replacement_data);
+    saveField(os, casted_replacement_data->valid);
+}
+
+void
+RandomRP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<RandomReplData> casted_replacement_data =
+        std::static_pointer_cast<RandomReplData>(replacement_data);
+    loadField(is, casted_replacement_data->valid);
+}
+
 RandomRP*
 RandomRPParams::create()
 {
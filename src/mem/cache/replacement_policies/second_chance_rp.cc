@@ -131,6 +131,28 @@ SecondChanceRP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new SecondChanceReplData());
 }
 
+void
+SecondChanceRP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    FIFORP::serializeEntry(replacement_data, os);
+    std::shared_ptr<SecondChanceReplData> casted_replacement_data =
+        std::static_pointer_cast<SecondChanceReplData>(replacement_data);
+    saveField(os, casted_replacement_data->hasSecondChance);
+}
+
+void
+SecondChanceRP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    FIFORP::unserializeEntry(replacement_data, is);
+    std::shared_ptr<SecondChanceReplData> casted_replacement_data =
+        std::static_pointer_cast<SecondChanceReplData>(replacement_data);
+    loadField(is, casted_replacement_data->hasSecondChance);
+}
+
 SecondChanceRP*
 SecondChanceRPParams::create()
 {
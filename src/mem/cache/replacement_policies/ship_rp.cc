@@ -184,6 +184,48 @@ SHIPRP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new SHIPReplData(numRRPVBits));
 }
 
+void
+SHIPRP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<SHIPReplData> casted_replacement_data =
+        std::static_pointer_cast<SHIPReplData>(replacement_data);
+    saveCounter(os, casted_replacement_data->rrpv);
+    saveField(os, casted_replacement_data->valid);
+    saveField(os, casted_replacement_data->outcome);
+    saveField(os, casted_replacement_data->signature);
+}
+
+void
+SHIPRP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<SHIPReplData> casted_replacement_data =
+        std::static_pointer_cast<SHIPReplData>(replacement_data);
+    loadCounter(is, casted_replacement_data->rrpv);
+    loadField(is, casted_replacement_data->valid);
+    loadField(is, casted_replacement_data->outcome);
+    loadField(is, casted_replacement_data->signature);
+}
+
+void
+SHIPRP::serializeState(std::ostream &os) const
+{
+    for (const auto &counter : signature_history_counter_array)
+        saveField(os, counter);
+}
+
+void
+SHIPRP::unserializeState(std::istream &is)
+{
+    for (auto &counter : signature_history_counter_array)
+        loadField(is, counter);
+}
+
 SHIPRP*
 SHIPRPParams::create()
 {
@@ -150,6 +150,22 @@ class SHIPRP : public BaseReplacementPolicy
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /**
+     * Save and restore the RRPV, outcome and signature of an entry in
+     * cache warmup snapshots.
+     */
+    void serializeEntry(const std::shared_ptr<ReplacementData>&
+                        replacement_data, std::ostream &os) const override;
+    void unserializeEntry(const std::shared_ptr<ReplacementData>&
+                          replacement_data, std::istream &is) const override;
+
+    /**
+     * Save and restore the signature history counter table in cache warmup
+     * snapshots.
+     */
+    void serializeState(std::ostream &os) const override;
+    void unserializeState(std::istream &is) override;
 };
 
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_BRRIP_RP_HH__
@@ -210,6 +210,40 @@ TreePLRURP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(treePLRUReplData);
 }
 
+void
+TreePLRURP::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<TreePLRUReplData> treePLRU_replacement_data =
+        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+
+    if (treePLRU_replacement_data->index == numLeaves - 1) {
+        for (const bool bit : *treePLRU_replacement_data->tree)
+            saveField(os, bit);
+    }
+}
+
+void
+TreePLRURP::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<TreePLRUReplData> treePLRU_replacement_data =
+        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+
+    if (treePLRU_replacement_data->index == numLeaves - 1) {
+        PLRUTree* tree = treePLRU_replacement_data->tree.get();
+        for (uint64_t i = 0; i < tree->size(); i++) {
+            bool bit;
+            loadField(is, bit);
+            tree->at(i) = bit;
+        }
+    }
+}
+
 TreePLRURP*
 TreePLRURPParams::create()
 {
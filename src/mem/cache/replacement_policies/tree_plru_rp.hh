@@ -210,6 +210,21 @@ class TreePLRURP : public BaseReplacementPolicy
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    /**
+     * Save and restore the PLRU tree of a set in cache warmup snapshots.
+     * The tree is shared by the entries of a set, so it is stored with
+     * the entry of the leftmost leaf only.
+     */
+    void serializeEntry(const std::shared_ptr<ReplacementData>&
+                        replacement_data, std::ostream &os) const override;
+    void unserializeEntry(const std::shared_ptr<ReplacementData>&
+                          replacement_data, std::istream &is) const override;
+
+    /**
+     * The PLRU tree is shared by all the entries of a set.
+     */
+    bool isSetBound() const override { return true; }
 };
 
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_TREE_PLRU_RP_HH__
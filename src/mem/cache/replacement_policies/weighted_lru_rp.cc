@@ -42,6 +42,30 @@ WeightedLRUPolicy::WeightedLRUPolicy(const Params* p)
 {
 }
 
+void
+WeightedLRUPolicy::serializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::ostream &os) const
+{
+    BaseReplacementPolicy::serializeEntry(replacement_data, os);
+    std::shared_ptr<WeightedLRUReplData> casted_replacement_data =
+        std::static_pointer_cast<WeightedLRUReplData>(replacement_data);
+    saveField(os, casted_replacement_data->last_occ_ptr);
+    saveField(os, casted_replacement_data->last_touch_tick);
+}
+
+void
+WeightedLRUPolicy::unserializeEntry(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    std::istream &is) const
+{
+    BaseReplacementPolicy::unserializeEntry(replacement_data, is);
+    std::shared_ptr<WeightedLRUReplData> casted_replacement_data =
+        std::static_pointer_cast<WeightedLRUReplData>(replacement_data);
+    loadField(is, casted_replacement_data->last_occ_ptr);
+    loadField(is, casted_replacement_data->last_touch_tick);
+}
+
 WeightedLRUPolicy *
 WeightedLRURPParams::create()
 {
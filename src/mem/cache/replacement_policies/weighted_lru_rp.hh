@@ -99,6 +99,15 @@ class WeightedLRUPolicy : public BaseReplacementPolicy
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
 
+    /**
+     * Save and restore the occupancy and last touch tick of an entry in
+     * cache warmup snapshots.
+     */
+    void serializeEntry(const std::shared_ptr<ReplacementData>&
+                        replacement_data, std::ostream &os) const override;
+    void unserializeEntry(const std::shared_ptr<ReplacementData>&
+                          replacement_data, std::istream &is) const override;
+
     /**
      * Find replacement victim using weight.
      *
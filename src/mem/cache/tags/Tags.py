@@ -82,6 +82,33 @@ class BaseSetAssoc(BaseTags):
     replacement_policy = Param.BaseReplacementPolicy(
         Parent.replacement_policy, "Replacement policy")
 
+    # Get the partitioning policy from the parent (cache)
+    partitioning_policy = Param.BasePartitioningPolicy(
+        Parent.partitioning_policy, "Way partitioning policy")
+
+    # Get the sampled access statistics configuration from the parent
+    # (cache)
+    access_sample_period = Param.Unsigned(Parent.access_sample_period,
+        "Record access statistics for one out of this many sets")
+    access_sample_pc_entries = Param.Unsigned(
+        Parent.access_sample_pc_entries,
+        "Number of entries of the hashed per-PC access statistics")
+    access_sample_reuse_buckets = Param.Unsigned(
+        Parent.access_sample_reuse_buckets,
+        "Number of buckets of the sampled reuse distance histogram")
+
+class ZCacheTags(BaseSetAssoc):
+    type = 'ZCacheTags'
+    cxx_header = "mem/cache/tags/zcache_tags.hh"
+
+    # Number of levels of the replacement candidate walk. With W ways, a
+    # walk finds up to W + W(W-1) + W(W-1)^2 + ... candidates.
+    walk_levels = Param.Unsigned(2, "Number of levels of the replacement "
+                                 "candidate walk")
+
+    # The walk needs the ways to be indexed with different hash functions
+    indexing_policy = HashedAssociative(skewed=True)
+
 class SectorTags(BaseTags):
     type = 'SectorTags'
     cxx_header = "mem/cache/tags/sector_tags.hh"
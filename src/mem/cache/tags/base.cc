@@ -183,6 +183,19 @@ BaseTags::computeStats()
     forEachBlk([this](CacheBlk &blk) { computeStatsVisitor(blk); });
 }
 
+void
+BaseTags::serializeWarmState(std::ostream &os)
+{
+    fatal("%s: this tag store can't save warm state snapshots\n", name());
+}
+
+void
+BaseTags::unserializeWarmState(std::istream &is)
+{
+    fatal("%s: this tag store can't restore warm state snapshots\n",
+          name());
+}
+
 std::string
 BaseTags::print()
 {
@@ -49,6 +49,8 @@
 #include <cassert>
 #include <cstdint>
 #include <functional>
+#include <istream>
+#include <ostream>
 #include <string>
 
 #include "base/callback.hh"
@@ -273,11 +275,35 @@ class BaseTags : public ClockedObject
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
+     * @param master_id Requestor that allocates the new block.
      * @return Cache block to be replaced.
      */
     virtual CacheBlk* findVictim(Addr addr, const bool is_secure,
                                  const std::size_t size,
-                                 std::vector<CacheBlk*>& evict_blks) = 0;
+                                 std::vector<CacheBlk*>& evict_blks,
+                                 const MasterID master_id) = 0;
+
+    /**
+     * Get the valid blocks that must be moved to other entries before the
+     * entry returned by the last findVictim() call is free, in addition to
+     * evicting its victims. Most tags never move blocks.
+     * @sa relocateBlks
+     *
+     * @return The blocks to be moved.
+     */
+    virtual const std::vector<CacheBlk*> &
+    getRelocatedBlks() const
+    {
+        static const std::vector<CacheBlk*> none;
+        return none;
+    }
+
+    /**
+     * Move the blocks returned by getRelocatedBlks(). This must be called
+     * once the victims of the last findVictim() call have been evicted,
+     * and before a new block is inserted in the entry it returned.
+     */
+    virtual void relocateBlks() {}
 
     /**
      * Access block and update replacement data. May not succeed, in which case
@@ -337,6 +363,23 @@ class BaseTags : public ClockedObject
      */
     virtual bool anyBlk(std::function<bool(CacheBlk &)> visitor) = 0;
 
+    /**
+     * Write the tag array, including block contents and replacement
+     * state, to a cache warmup snapshot. Tag stores that don't support
+     * snapshots refuse to write one.
+     *
+     * @param os Binary stream holding the snapshot.
+     */
+    virtual void serializeWarmState(std::ostream &os);
+
+    /**
+     * Restore the tag array from a cache warmup snapshot written by
+     * serializeWarmState() on an identically configured tag store.
+     *
+     * @param is Binary stream holding the snapshot.
+     */
+    virtual void unserializeWarmState(std::istream &is);
+
   private:
     /**
      * Update the reference stats using data from the input block
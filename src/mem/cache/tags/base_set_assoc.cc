@@ -45,19 +45,43 @@
 
 #include "mem/cache/tags/base_set_assoc.hh"
 
+#include <algorithm>
 #include <string>
 
 #include "base/intmath.hh"
+#include "sim/core.hh"
+#include "sim/system.hh"
+
+namespace
+{
+
+/** Per-block record of a cache warmup snapshot. */
+struct WarmBlkState
+{
+    Addr tag;
+    Tick tickInserted;
+    uint32_t status;
+    uint32_t taskId;
+    int32_t srcMasterId;
+    uint32_t refCount;
+};
+
+} // anonymous namespace
 
 BaseSetAssoc::BaseSetAssoc(const Params *p)
     :BaseTags(p), allocAssoc(p->assoc), blks(p->size / p->block_size),
      sequentialAccess(p->sequential_access),
-     replacementPolicy(p->replacement_policy)
+     replacementPolicy(p->replacement_policy),
+     partitioningPolicy(p->partitioning_policy)
 {
     // Check parameters
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
         fatal("Block size must be at least 4 and a power of 2");
     }
+
+    if (p->access_sample_period) {
+        accessSamples.reset(new AccessSampleStats(*this, p));
+    }
 }
 
 void
@@ -82,6 +106,10 @@ BaseSetAssoc::tagsInit()
 void
 BaseSetAssoc::invalidate(CacheBlk *blk)
 {
+    // Record the eviction before the block state is cleared
+    if (accessSamples)
+        accessSamples->recordEviction(blk);
+
     BaseTags::invalidate(blk);
 
     // Decrease the number of tags in use
@@ -91,6 +119,82 @@ BaseSetAssoc::invalidate(CacheBlk *blk)
     replacementPolicy->invalidate(blk->replacementData);
 }
 
+void
+BaseSetAssoc::serializeWarmState(std::ostream &os)
+{
+    const uint64_t num_blocks = numBlocks;
+    const uint32_t blk_size = blkSize;
+    os.write(reinterpret_cast<const char *>(&num_blocks), sizeof(num_blocks));
+    os.write(reinterpret_cast<const char *>(&blk_size), sizeof(blk_size));
+
+    replacementPolicy->serializeState(os);
+
+    for (const CacheBlk &blk : blks) {
+        WarmBlkState state;
+        state.tag = blk.tag;
+        state.tickInserted = blk.tickInserted;
+        state.status = blk.status;
+        state.taskId = blk.task_id;
+        state.srcMasterId = blk.srcMasterId;
+        state.refCount = blk.refCount;
+        os.write(reinterpret_cast<const char *>(&state), sizeof(state));
+
+        if (blk.isValid())
+            os.write(reinterpret_cast<const char *>(blk.data), blkSize);
+
+        replacementPolicy->serializeEntry(blk.replacementData, os);
+    }
+}
+
+void
+BaseSetAssoc::unserializeWarmState(std::istream &is)
+{
+    uint64_t num_blocks;
+    uint32_t blk_size;
+    is.read(reinterpret_cast<char *>(&num_blocks), sizeof(num_blocks));
+    is.read(reinterpret_cast<char *>(&blk_size), sizeof(blk_size));
+    fatal_if(!is || num_blocks != numBlocks || blk_size != blkSize,
+             "%s: warm state snapshot doesn't match the cache geometry\n",
+             name());
+
+    replacementPolicy->unserializeState(is);
+
+    for (CacheBlk &blk : blks) {
+        WarmBlkState state;
+        is.read(reinterpret_cast<char *>(&state), sizeof(state));
+        fatal_if(!is, "%s: warm state snapshot is truncated\n", name());
+
+        if (blk.isValid())
+            invalidate(&blk);
+
+        if (state.status & BlkValid) {
+            fatal_if(state.srcMasterId < 0 ||
+                     state.srcMasterId >= system->maxMasters(),
+                     "%s: warm state snapshot has an unknown master\n",
+                     name());
+
+            blk.insert(state.tag, state.status & BlkSecure,
+                       state.srcMasterId, state.taskId);
+            blk.status = state.status;
+            blk.refCount = state.refCount;
+            blk.tickInserted = state.tickInserted;
+            blk.whenReady = curTick();
+            is.read(reinterpret_cast<char *>(blk.data), blkSize);
+
+            stats.occupancies[state.srcMasterId]++;
+            stats.tagsInUse++;
+        }
+
+        replacementPolicy->unserializeEntry(blk.replacementData, is);
+    }
+    fatal_if(!is, "%s: warm state snapshot is truncated\n", name());
+
+    if (!warmedUp && stats.tagsInUse.value() >= warmupBound) {
+        warmedUp = true;
+        stats.warmupCycle = curTick();
+    }
+}
+
 BaseSetAssoc *
 BaseSetAssocParams::create()
 {
@@ -99,3 +203,134 @@ BaseSetAssocParams::create()
 
     return new BaseSetAssoc(this);
 }
+
+BaseSetAssoc::AccessSampleStats::AccessSampleStats(
+    BaseSetAssoc &tags, const BaseSetAssocParams *p)
+    : Stats::Group(&tags, "access_samples"),
+      assoc(p->assoc), samplePeriod(p->access_sample_period),
+      numSampledSets(divCeil(p->size / (p->block_size * p->assoc),
+                             p->access_sample_period)),
+      pcEntries(p->access_sample_pc_entries),
+      reuseBuckets(p->access_sample_reuse_buckets),
+      setAccesses(numSampledSets, 0),
+      lastAccess(numSampledSets * assoc, 0),
+      setMisses(this, "set_misses", "Number of misses per sampled set"),
+      pcMisses(this, "pc_misses",
+               "Number of misses per hashed inserting PC"),
+      pcHits(this, "pc_hits", "Number of hits per hashed inserting PC"),
+      pcDeadEvictions(this, "pc_dead_evictions",
+                      "Number of evictions without reuse per hashed "
+                      "inserting PC"),
+      reuseDistance(this, "reuse_distance",
+                    "Number of accesses to the set between two hits on "
+                    "a block"),
+      evictions(this, "evictions", "Number of evictions"),
+      deadEvictions(this, "dead_evictions",
+                    "Number of evictions of blocks without reuse"),
+      deadBlockRatio(this, "dead_block_ratio",
+                     "Fraction of evicted blocks without reuse")
+{
+    fatal_if(!isPowerOf2(pcEntries),
+             "The number of per-PC access sample entries must be a "
+             "power of 2");
+    fatal_if(reuseBuckets == 0,
+             "The reuse distance histogram needs at least one bucket");
+}
+
+void
+BaseSetAssoc::AccessSampleStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    setMisses
+        .init(numSampledSets)
+        .flags(nozero)
+        ;
+    for (unsigned i = 0; i < numSampledSets; i++) {
+        setMisses.subname(i, csprintf("set%d", i * samplePeriod));
+    }
+
+    pcMisses
+        .init(pcEntries)
+        .flags(nozero)
+        ;
+    pcHits
+        .init(pcEntries)
+        .flags(nozero)
+        ;
+    pcDeadEvictions
+        .init(pcEntries)
+        .flags(nozero)
+        ;
+
+    reuseDistance
+        .init(reuseBuckets)
+        .flags(pdf)
+        ;
+
+    deadBlockRatio.flags(nonan);
+    deadBlockRatio = deadEvictions / evictions;
+}
+
+void
+BaseSetAssoc::AccessSampleStats::recordHit(const CacheBlk *blk)
+{
+    const int index = sampleIndex(blk->getSet());
+    if (index < 0)
+        return;
+
+    uint64_t &last = lastAccess[index * assoc + blk->getWay()];
+    reuseDistance.sample(setAccesses[index] - last);
+    last = ++setAccesses[index];
+
+    pcHits[pcIndex(blk->replacementData->pc)]++;
+}
+
+void
+BaseSetAssoc::AccessSampleStats::recordFill(const CacheBlk *blk)
+{
+    const int index = sampleIndex(blk->getSet());
+    if (index < 0)
+        return;
+
+    lastAccess[index * assoc + blk->getWay()] = ++setAccesses[index];
+
+    setMisses[index]++;
+    pcMisses[pcIndex(blk->replacementData->pc)]++;
+}
+
+void
+BaseSetAssoc::AccessSampleStats::recordEviction(const CacheBlk *blk)
+{
+    const int index = sampleIndex(blk->getSet());
+    if (index < 0)
+        return;
+
+    evictions++;
+
+    // The reference count starts at one when the block is inserted
+    if (blk->refCount <= 1) {
+        deadEvictions++;
+        pcDeadEvictions[pcIndex(blk->replacementData->pc)]++;
+    }
+}
+
+void
+BaseSetAssoc::AccessSampleStats::recordRelocation(const CacheBlk *src,
+                                                  const CacheBlk *dst)
+{
+    const int dst_index = sampleIndex(dst->getSet());
+    if (dst_index < 0)
+        return;
+
+    // A block coming from a set that is not sampled is treated as if it
+    // had just been accessed
+    const int src_index = sampleIndex(src->getSet());
+    const uint64_t age = src_index < 0 ? 0 :
+        setAccesses[src_index] - lastAccess[src_index * assoc + src->getWay()];
+
+    lastAccess[dst_index * assoc + dst->getWay()] =
+        setAccesses[dst_index] - std::min(age, setAccesses[dst_index]);
+}
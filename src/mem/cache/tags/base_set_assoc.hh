@@ -48,13 +48,16 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/logging.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/base.hh"
 #include "mem/cache/cache_blk.hh"
+#include "mem/cache/partitioning_policies/base.hh"
 #include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
@@ -84,6 +87,106 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     BaseReplacementPolicy *replacementPolicy;
 
+    /** Way partitioning policy, if the cache is partitioned. */
+    BasePartitioningPolicy *partitioningPolicy;
+
+    /**
+     * Sampled access statistics used to analyse replacement policies.
+     * Only one out of every samplePeriod sets is tracked and all the
+     * counters have a fixed size, so the overhead is bounded. Per-PC
+     * counters are attributed to the PC that inserted the block (the
+     * signature used by SHiP), hashed into a fixed number of entries.
+     */
+    struct AccessSampleStats : public Stats::Group
+    {
+        AccessSampleStats(BaseSetAssoc &tags, const BaseSetAssocParams *p);
+
+        void regStats() override;
+
+        /** Record a hit on a valid block. */
+        void recordHit(const CacheBlk *blk);
+
+        /** Record the insertion of a block after a miss. */
+        void recordFill(const CacheBlk *blk);
+
+        /** Record the eviction (or invalidation) of a valid block. */
+        void recordEviction(const CacheBlk *blk);
+
+        /**
+         * Record a block being moved to another entry, keeping the number
+         * of set accesses since its last access.
+         *
+         * @param src The entry the block was moved from.
+         * @param dst The entry the block was moved to.
+         */
+        void recordRelocation(const CacheBlk *src, const CacheBlk *dst);
+
+        /**
+         * Get the index of a set in the sampled set counters.
+         *
+         * @param set The set index.
+         * @return The sampled set index, or -1 if it is not sampled.
+         */
+        int sampleIndex(uint32_t set) const
+        {
+            return set % samplePeriod ? -1 : set / samplePeriod;
+        }
+
+        /** Hash a PC into the per-PC counters. */
+        unsigned pcIndex(Addr pc) const
+        {
+            return (pc ^ (pc >> 16) ^ (pc >> 32)) & (pcEntries - 1);
+        }
+
+        /** Associativity of the tag store. */
+        const unsigned assoc;
+
+        /** Only one out of every samplePeriod sets is tracked. */
+        const unsigned samplePeriod;
+
+        /** Number of tracked sets. */
+        const unsigned numSampledSets;
+
+        /** Number of per-PC counters. */
+        const unsigned pcEntries;
+
+        /** Number of buckets of the reuse distance histogram. */
+        const unsigned reuseBuckets;
+
+        /** Number of hits and fills seen by each sampled set. */
+        std::vector<uint64_t> setAccesses;
+
+        /** Set access count at the last access of each sampled block. */
+        std::vector<uint64_t> lastAccess;
+
+        /** Misses (fills) per sampled set. */
+        Stats::Vector setMisses;
+
+        /** Misses (fills) per hashed inserting PC. */
+        Stats::Vector pcMisses;
+
+        /** Hits per hashed inserting PC. */
+        Stats::Vector pcHits;
+
+        /** Evictions without reuse per hashed inserting PC. */
+        Stats::Vector pcDeadEvictions;
+
+        /** Accesses to the same set between two hits on a block. */
+        Stats::Histogram reuseDistance;
+
+        /** Evictions from the sampled sets. */
+        Stats::Scalar evictions;
+
+        /** Evictions of blocks that were never hit after insertion. */
+        Stats::Scalar deadEvictions;
+
+        /** Fraction of the evicted blocks that were never reused. */
+        Stats::Formula deadBlockRatio;
+    };
+
+    /** Sampled access statistics, only allocated when enabled. */
+    std::unique_ptr<AccessSampleStats> accessSamples;
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -145,6 +248,9 @@ class BaseSetAssoc : public BaseTags
 
             // Update replacement data of accessed block
             replacementPolicy->touch(blk->replacementData);
+
+            if (accessSamples)
+                accessSamples->recordHit(blk);
         }
 
         // The tag lookup latency is the same for a hit or a miss
@@ -161,16 +267,23 @@ class BaseSetAssoc : public BaseTags
      * @param is_secure True if the target memory space is secure.
      * @param size Size, in bits, of new block to allocate.
      * @param evict_blks Cache blocks to be evicted.
+     * @param master_id Requestor that allocates the new block.
      * @return Cache block to be replaced.
      */
     CacheBlk* findVictim(Addr addr, const bool is_secure,
                          const std::size_t size,
-                         std::vector<CacheBlk*>& evict_blks) override
+                         std::vector<CacheBlk*>& evict_blks,
+                         const MasterID master_id) override
     {
         // Get possible entries to be victimized
-        const std::vector<ReplaceableEntry*> entries =
+        std::vector<ReplaceableEntry*> entries =
             indexingPolicy->getPossibleEntries(addr);
 
+        // Only keep the entries the requestor may replace
+        if (partitioningPolicy) {
+            partitioningPolicy->filterCandidates(entries, master_id);
+        }
+
         // Choose replacement victim from replacement candidates
         CacheBlk* victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
                                 entries));
@@ -205,6 +318,9 @@ class BaseSetAssoc : public BaseTags
         blk->replacementData->setindex = blk->getSet();
         //DPRINTF(Cacheset, "Cache miss: cache blk set: %x, tag number: %x\n", blk->replacementData->setindex, blk->replacementData->tag);
         replacementPolicy->reset(blk->replacementData);
+
+        if (accessSamples)
+            accessSamples->recordFill(blk);
     }
 
     /**
@@ -251,6 +367,9 @@ class BaseSetAssoc : public BaseTags
         }
         return false;
     }
+
+    void serializeWarmState(std::ostream &os) override;
+    void unserializeWarmState(std::istream &is) override;
 };
 
 #endif //__MEM_CACHE_TAGS_BASE_SET_ASSOC_HH__
@@ -193,7 +193,8 @@ FALRU::findBlockBySetAndWay(int set, int way) const
 
 CacheBlk*
 FALRU::findVictim(Addr addr, const bool is_secure, const std::size_t size,
-                  std::vector<CacheBlk*>& evict_blks)
+                  std::vector<CacheBlk*>& evict_blks,
+                  const MasterID master_id)
 {
     // The victim is always stored on the tail for the FALRU
     FALRUBlk* victim = tail;
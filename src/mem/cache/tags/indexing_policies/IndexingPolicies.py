@@ -51,3 +51,15 @@ class SkewedAssociative(BaseIndexingPolicy):
     type = 'SkewedAssociative'
     cxx_class = 'SkewedAssociative'
     cxx_header = "mem/cache/tags/indexing_policies/skewed_associative.hh"
+
+class IndexingHash(ScopedEnum): vals = ['H3', 'PrimeModulo', 'XorFold']
+
+class HashedAssociative(BaseIndexingPolicy):
+    type = 'HashedAssociative'
+    cxx_class = 'HashedAssociative'
+    cxx_header = "mem/cache/tags/indexing_policies/hashed_associative.hh"
+
+    hash_function = Param.IndexingHash('H3', "Hash function family used "
+                                       "to compute the set of an address")
+    skewed = Param.Bool(False, "Use a different hash function for each way")
+    seed = Param.UInt32(1, "Seed of the H3 hash masks")
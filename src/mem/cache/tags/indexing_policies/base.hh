@@ -146,6 +146,22 @@ class BaseIndexingPolicy : public SimObject
     virtual std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr)
                                                                     const = 0;
 
+    /**
+     * Find all possible entries for insertion and replacement of an address,
+     * writing them to a caller-provided vector. The vector is cleared first,
+     * so reusing it across lookups avoids allocating once it has grown to
+     * the associativity.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param entries The possible entries.
+     */
+    virtual void
+    gatherPossibleEntries(const Addr addr,
+                          std::vector<ReplaceableEntry*> &entries) const
+    {
+        entries = getPossibleEntries(addr);
+    }
+
     /**
      * Regenerate an entry's address from its tag and assigned indexing bits.
      *
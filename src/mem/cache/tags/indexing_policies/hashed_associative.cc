@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a hashed (optionally skewed) associative indexing policy.
+ */
+
+#include "mem/cache/tags/indexing_policies/hashed_associative.hh"
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+
+HashedAssociative::HashedAssociative(const Params *p)
+    : BaseIndexingPolicy(p), hashFunction(p->hash_function),
+      skewed(p->skewed), setBits(floorLog2(numSets)),
+      prime(largestPrime(numSets))
+{
+    fatal_if(numSets < 2, "Hashed indexing needs more than one set");
+
+    if (hashFunction == IndexingHash::H3) {
+        // Generate the masks from a private generator so that the mapping
+        // only depends on the seed
+        Random rng(p->seed);
+        const unsigned num_functions = skewed ? assoc : 1;
+        h3Masks.resize(num_functions * setBits);
+        for (auto &mask : h3Masks) {
+            mask = rng.random<uint64_t>();
+        }
+    } else if (hashFunction == IndexingHash::PrimeModulo && prime != numSets) {
+        warn("Prime modulo indexing only uses %d out of %d sets.\n",
+             prime, numSets);
+    }
+}
+
+uint32_t
+HashedAssociative::largestPrime(uint32_t value)
+{
+    for (uint32_t candidate = value; candidate > 2; --candidate) {
+        bool is_prime = true;
+        for (uint32_t div = 2; div * div <= candidate; ++div) {
+            if (candidate % div == 0) {
+                is_prime = false;
+                break;
+            }
+        }
+        if (is_prime) {
+            return candidate;
+        }
+    }
+    return value < 2 ? 1 : 2;
+}
+
+uint32_t
+HashedAssociative::hash(const Addr line, const uint32_t way) const
+{
+    const uint32_t function = skewed ? way : 0;
+
+    switch (hashFunction) {
+      case IndexingHash::H3:
+        {
+            const uint64_t *masks = &h3Masks[function * setBits];
+            uint32_t set = 0;
+            for (unsigned bit = 0; bit < setBits; ++bit) {
+                set |= (popCount(line & masks[bit]) & 1) << bit;
+            }
+            return set;
+        }
+
+      case IndexingHash::PrimeModulo:
+        // Skewed ways displace the line address by a multiple of its upper
+        // bits, which keeps the mapping uniform for each way
+        return (line + function * (line >> setBits)) % prime;
+
+      case IndexingHash::XorFold:
+        {
+            // Skewed ways rotate the line address before folding it, so
+            // that each way combines different bits
+            Addr value = line;
+            if (function % 64) {
+                value = (line << (function % 64)) |
+                        (line >> (64 - function % 64));
+            }
+            uint32_t set = 0;
+            for (; value; value >>= setBits) {
+                set ^= value & setMask;
+            }
+            return set;
+        }
+
+      default:
+        panic("Unknown indexing hash function.");
+    }
+}
+
+Addr
+HashedAssociative::extractTag(const Addr addr) const
+{
+    return addr >> setShift;
+}
+
+Addr
+HashedAssociative::regenerateAddr(const Addr tag,
+                                  const ReplaceableEntry* entry) const
+{
+    return tag << setShift;
+}
+
+std::vector<ReplaceableEntry*>
+HashedAssociative::getPossibleEntries(const Addr addr) const
+{
+    std::vector<ReplaceableEntry*> entries;
+    entries.reserve(assoc);
+    gatherPossibleEntries(addr, entries);
+    return entries;
+}
+
+void
+HashedAssociative::gatherPossibleEntries(const Addr addr,
+    std::vector<ReplaceableEntry*> &entries) const
+{
+    entries.clear();
+
+    const Addr line = addr >> setShift;
+    if (skewed) {
+        for (uint32_t way = 0; way < assoc; ++way) {
+            entries.push_back(sets[hash(line, way)][way]);
+        }
+    } else {
+        const auto &set = sets[hash(line, 0)];
+        entries.insert(entries.end(), set.begin(), set.end());
+    }
+}
+
+HashedAssociative *
+HashedAssociativeParams::create()
+{
+    return new HashedAssociative(this);
+}
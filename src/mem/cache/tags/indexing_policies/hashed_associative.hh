@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a hashed (optionally skewed) associative indexing policy.
+ */
+
+#ifndef __MEM_CACHE_INDEXING_POLICIES_HASHED_ASSOCIATIVE_HH__
+#define __MEM_CACHE_INDEXING_POLICIES_HASHED_ASSOCIATIVE_HH__
+
+#include <vector>
+
+#include "enums/IndexingHash.hh"
+#include "mem/cache/tags/indexing_policies/base.hh"
+#include "params/HashedAssociative.hh"
+
+class ReplaceableEntry;
+
+/**
+ * A hashed associative indexing policy.
+ * @sa  \ref gem5MemorySystem "gem5 Memory System"
+ *
+ * The set of an address is computed by hashing all the bits of its line
+ * address, instead of just taking the bits above the block offset. This
+ * spreads power-of-two strides, which would otherwise map to a handful of
+ * sets, over the whole cache. The hash functions available are:
+ *
+ *  - H3: Each set index bit is the parity of the line address masked with
+ *    a random (seeded) mask, as proposed in "Universal classes of hash
+ *    functions", from Carter and Wegman.
+ *  - Prime modulo: The set is the line address modulo the largest prime
+ *    not larger than the number of sets, as proposed in "Using Prime
+ *    Numbers for Cache Indexing to Eliminate Conflict Misses", from
+ *    Kharbutli et al. The sets above the prime are never used.
+ *  - XOR fold: The line address is split in set-index-sized chunks which
+ *    are XORed together.
+ *
+ * When skewed, every way uses a different function of the same family, as
+ * in a skewed associative cache, which is what a ZCache walk needs to find
+ * replacement candidates beyond the ways of a single set.
+ *
+ * Since the hashes are not invertible, the tags hold the whole line address
+ * and the address of an entry is regenerated from its tag alone.
+ */
+class HashedAssociative : public BaseIndexingPolicy
+{
+  private:
+    /** The hash function family. */
+    const IndexingHash hashFunction;
+
+    /** Whether every way uses a different hash function. */
+    const bool skewed;
+
+    /** Number of set index bits. */
+    const unsigned setBits;
+
+    /** The modulus used by the prime modulo hash. */
+    const uint32_t prime;
+
+    /**
+     * Masks of the H3 hash, setBits masks per hash function (one hash
+     * function if not skewed, one per way otherwise).
+     */
+    std::vector<uint64_t> h3Masks;
+
+    /**
+     * Get the largest prime number not larger than a value.
+     *
+     * @param value The upper bound.
+     * @return The largest prime number not larger than value.
+     */
+    static uint32_t largestPrime(uint32_t value);
+
+    /**
+     * Apply the hash function of the given way to a line address.
+     *
+     * @param line The line address (address without the block offset).
+     * @param way The way, used to select a hash function when skewed.
+     * @return The set index for given combination of address and way.
+     */
+    uint32_t hash(const Addr line, const uint32_t way) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef HashedAssociativeParams Params;
+
+    /**
+     * Construct and initialize this policy.
+     */
+    HashedAssociative(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~HashedAssociative() {};
+
+    /**
+     * The tag is the whole line address, since the set index can't be
+     * inverted into address bits.
+     *
+     * @param addr Address to get the tag from.
+     * @return The tag of the address.
+     */
+    Addr extractTag(const Addr addr) const override;
+
+    /**
+     * Find all possible entries for insertion and replacement of an address.
+     * Should be called immediately before ReplacementPolicy's findVictim()
+     * not to break cache resizing.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @return The possible entries.
+     */
+    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
+                                                                   override;
+
+    /**
+     * Find all possible entries for insertion and replacement of an
+     * address without allocating.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param entries The possible entries.
+     */
+    void gatherPossibleEntries(const Addr addr,
+                               std::vector<ReplaceableEntry*> &entries) const
+                                                                   override;
+
+    /**
+     * Regenerate an entry's address from its tag.
+     *
+     * @param tag The tag bits.
+     * @param entry The entry.
+     * @return the entry's address.
+     */
+    Addr regenerateAddr(const Addr tag, const ReplaceableEntry* entry) const
+                                                                   override;
+};
+
+#endif //__MEM_CACHE_INDEXING_POLICIES_HASHED_ASSOCIATIVE_HH__
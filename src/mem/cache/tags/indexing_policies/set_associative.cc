@@ -72,6 +72,14 @@ SetAssociative::getPossibleEntries(const Addr addr) const
     return sets[extractSet(addr)];
 }
 
+void
+SetAssociative::gatherPossibleEntries(const Addr addr,
+    std::vector<ReplaceableEntry*> &entries) const
+{
+    const auto &set = sets[extractSet(addr)];
+    entries.assign(set.begin(), set.end());
+}
+
 SetAssociative*
 SetAssociativeParams::create()
 {
@@ -115,6 +115,17 @@ class SetAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
                                                                      override;
 
+    /**
+     * Find all possible entries for insertion and replacement of an
+     * address without allocating.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param entries The possible entries.
+     */
+    void gatherPossibleEntries(const Addr addr,
+                               std::vector<ReplaceableEntry*> &entries) const
+                                                                   override;
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      *
@@ -160,6 +160,17 @@ class SkewedAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
                                                                    override;
 
+    /**
+     * Find all possible entries for insertion and replacement of an
+     * address without allocating.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param entries The possible entries.
+     */
+    void gatherPossibleEntries(const Addr addr,
+                               std::vector<ReplaceableEntry*> &entries) const
+                                                                   override;
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      * Uses the inverse of the skewing function.
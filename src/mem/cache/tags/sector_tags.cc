@@ -221,7 +221,8 @@ SectorTags::findBlock(Addr addr, bool is_secure) const
 
 CacheBlk*
 SectorTags::findVictim(Addr addr, const bool is_secure, const std::size_t size,
-                       std::vector<CacheBlk*>& evict_blks)
+                       std::vector<CacheBlk*>& evict_blks,
+                       const MasterID master_id)
 {
     // Get possible entries to be victimized
     const std::vector<ReplaceableEntry*> sector_entries =
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Definitions of a ZCache tag store.
+ */
+
+#include "mem/cache/tags/zcache_tags.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "mem/cache/cache_blk.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+#include "mem/cache/tags/indexing_policies/base.hh"
+
+ZCacheTags::ZCacheTags(const Params *p)
+    : BaseSetAssoc(p), walkLevels(p->walk_levels),
+      relocationVictim(nullptr), zcacheStats(*this)
+{
+    fatal_if(walkLevels == 0, "The ZCache walk needs at least one level");
+    fatal_if(partitioningPolicy, "ZCache tags don't support partitioning");
+    fatal_if(replacementPolicy->isSetBound(), "ZCache tags move blocks "
+             "across sets, which %s doesn't support",
+             replacementPolicy->name());
+}
+
+CacheBlk*
+ZCacheTags::findVictim(Addr addr, const bool is_secure,
+                       const std::size_t size,
+                       std::vector<CacheBlk*>& evict_blks,
+                       const MasterID master_id)
+{
+    relocatedBlks.clear();
+    relocationVictim = nullptr;
+
+    // The first level holds the possible entries of the address itself
+    candidates = indexingPolicy->getPossibleEntries(addr);
+    parents.assign(candidates.size(), -1);
+
+    // There is no need to walk if a first level entry is free
+    const bool walk = std::all_of(candidates.begin(), candidates.end(),
+        [](const ReplaceableEntry *entry) {
+            return static_cast<const CacheBlk*>(entry)->isValid(); });
+
+    size_t level_begin = 0;
+    for (unsigned level = 1; walk && level < walkLevels; ++level) {
+        const size_t level_end = candidates.size();
+        for (size_t i = level_begin; i < level_end; ++i) {
+            CacheBlk *blk = static_cast<CacheBlk*>(candidates[i]);
+            if (!blk->isValid()) {
+                continue;
+            }
+
+            // Each possible entry of the candidate's block is a place where
+            // the block could be moved to
+            for (const auto &entry :
+                 indexingPolicy->getPossibleEntries(regenerateBlkAddr(blk))) {
+                if (std::find(candidates.begin(), candidates.end(), entry) ==
+                    candidates.end()) {
+                    candidates.push_back(entry);
+                    parents.push_back(i);
+                }
+            }
+
+            stats.tagAccesses += allocAssoc;
+        }
+        level_begin = level_end;
+    }
+
+    // Choose replacement victim from all the candidates
+    ReplaceableEntry *victim_entry = replacementPolicy->getVictim(candidates);
+    const int victim_index = std::find(candidates.begin(), candidates.end(),
+                                       victim_entry) - candidates.begin();
+
+    // Build the path from the first level to the victim
+    for (int i = parents[victim_index]; i >= 0; i = parents[i]) {
+        relocatedBlks.push_back(static_cast<CacheBlk*>(candidates[i]));
+    }
+    std::reverse(relocatedBlks.begin(), relocatedBlks.end());
+
+    zcacheStats.walks++;
+    zcacheStats.walkCandidates += candidates.size();
+    zcacheStats.victimLevels[relocatedBlks.size()]++;
+
+    // The victim is the only block to be evicted; the other blocks on the
+    // path are relocated once it is gone
+    CacheBlk *victim = static_cast<CacheBlk*>(victim_entry);
+    evict_blks.push_back(victim);
+
+    if (relocatedBlks.empty()) {
+        return victim;
+    }
+
+    relocationVictim = victim;
+    return relocatedBlks.front();
+}
+
+void
+ZCacheTags::relocateBlock(CacheBlk *src, CacheBlk *dst)
+{
+    dst->moveFrom(*src, blkSize);
+
+    // The replacement state follows the block. The source entry gets the
+    // (invalidated) state of the destination.
+    std::swap(src->replacementData, dst->replacementData);
+    src->replacementData->setindex = src->getSet();
+    dst->replacementData->setindex = dst->getSet();
+
+    if (accessSamples)
+        accessSamples->recordRelocation(src, dst);
+
+    zcacheStats.relocations++;
+    stats.tagAccesses += 1;
+    stats.dataAccesses += 1;
+}
+
+void
+ZCacheTags::relocateBlks()
+{
+    if (relocatedBlks.empty()) {
+        return;
+    }
+
+    // Move the blocks along the path found by the last walk, starting
+    // next to the victim, so that the first level entry ends up free
+    assert(!relocationVictim->isValid());
+    CacheBlk *dst = relocationVictim;
+    for (auto it = relocatedBlks.rbegin(); it != relocatedBlks.rend(); ++it) {
+        relocateBlock(*it, dst);
+        dst = *it;
+    }
+
+    relocatedBlks.clear();
+    relocationVictim = nullptr;
+}
+
+ZCacheTags::ZCacheStats::ZCacheStats(ZCacheTags &_tags)
+    : Stats::Group(&_tags),
+    tags(_tags),
+
+    walks(this, "zcache_walks", "Number of replacement candidate walks"),
+    walkCandidates(this, "zcache_walk_candidates",
+                   "Number of replacement candidates over all walks"),
+    avgWalkCandidates(this, "zcache_avg_walk_candidates",
+                      "Average number of replacement candidates per walk"),
+    victimLevels(this, "zcache_victim_levels",
+                 "Number of victims found at each walk level"),
+    relocations(this, "zcache_relocations", "Number of relocated blocks")
+{
+}
+
+void
+ZCacheTags::ZCacheStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    avgWalkCandidates = walkCandidates / walks;
+
+    victimLevels.init(tags.walkLevels);
+    for (unsigned i = 0; i < tags.walkLevels; i++) {
+        victimLevels.subname(i, csprintf("level%d", i));
+    }
+}
+
+ZCacheTags *
+ZCacheTagsParams::create()
+{
+    // There must be a indexing policy
+    fatal_if(!indexing_policy, "An indexing policy is required");
+
+    return new ZCacheTags(this);
+}
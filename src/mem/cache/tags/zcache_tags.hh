@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a ZCache tag store.
+ */
+
+#ifndef __MEM_CACHE_TAGS_ZCACHE_TAGS_HH__
+#define __MEM_CACHE_TAGS_ZCACHE_TAGS_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/cache/tags/base_set_assoc.hh"
+#include "mem/packet.hh"
+#include "params/ZCacheTags.hh"
+
+class CacheBlk;
+class ReplaceableEntry;
+
+/**
+ * A ZCache tag store, as proposed in "The ZCache: Decoupling Ways and
+ * Associativity", from Sanchez and Kozyrakis.
+ *
+ * The replacement candidates are found through a walk: the first level
+ * holds the possible entries of the address being inserted, and every
+ * further level holds the possible entries of the blocks of the previous
+ * level. The replacement policy chooses a victim among all candidates. If
+ * the victim is not in the first level, the blocks on the path from the
+ * first level to the victim are relocated one step along the path, which
+ * frees a first-level entry for the new block.
+ *
+ * The replacement state follows the relocated blocks, so replacement
+ * policies whose state is bound to a set (e.g., tree PLRU or set dueling)
+ * are not supported.
+ *
+ * The walk only finds new candidates if the indexing policy maps an
+ * address to different sets on different ways (e.g., a skewed or hashed
+ * skewed indexing policy).
+ */
+class ZCacheTags : public BaseSetAssoc
+{
+  protected:
+    /** Number of levels of the candidate walk. */
+    const unsigned walkLevels;
+
+    /** Candidates of the last walk. */
+    std::vector<ReplaceableEntry*> candidates;
+
+    /** Index of the candidate each candidate was reached from. */
+    std::vector<int> parents;
+
+    /**
+     * Blocks on the path from the first level to the last victim, which
+     * are moved one step along the path once the victim is evicted.
+     */
+    std::vector<CacheBlk*> relocatedBlks;
+
+    /** Victim at the end of the relocation path. */
+    CacheBlk *relocationVictim;
+
+    struct ZCacheStats : public Stats::Group
+    {
+        ZCacheStats(ZCacheTags &tags);
+
+        void regStats() override;
+
+        ZCacheTags &tags;
+
+        /** Number of candidate walks. */
+        Stats::Scalar walks;
+
+        /** Number of replacement candidates over all walks. */
+        Stats::Scalar walkCandidates;
+
+        /** Average number of replacement candidates per walk. */
+        Stats::Formula avgWalkCandidates;
+
+        /**
+         * Number of victims per walk level. Victims found beyond the
+         * first level are conflicts avoided in the inserted address'
+         * own entries.
+         */
+        Stats::Vector victimLevels;
+
+        /** Number of blocks relocated. */
+        Stats::Scalar relocations;
+    } zcacheStats;
+
+    /**
+     * Move a valid block to an invalid entry, along with its replacement
+     * data and sampled access state.
+     *
+     * @param src The block to move.
+     * @param dst The destination entry.
+     */
+    void relocateBlock(CacheBlk *src, CacheBlk *dst);
+
+  public:
+    /** Convenience typedef. */
+    typedef ZCacheTagsParams Params;
+
+    /**
+     * Construct and initialize this tag store.
+     */
+    ZCacheTags(const Params *p);
+
+    /**
+     * Destructor
+     */
+    virtual ~ZCacheTags() {};
+
+    /**
+     * Find replacement victim through a multi-level candidate walk. The
+     * returned entry is where the new block must be inserted, which is
+     * only the victim itself if it was found in the first level.
+     * Otherwise it still holds a valid block until relocateBlks() has
+     * moved the blocks on the path to the victim.
+     *
+     * @param addr Address to find a victim for.
+     * @param is_secure True if the target memory space is secure.
+     * @param size Size, in bits, of new block to allocate.
+     * @param evict_blks Cache blocks to be evicted.
+     * @param master_id Requestor that allocates the new block.
+     * @return Cache block to be replaced.
+     */
+    CacheBlk* findVictim(Addr addr, const bool is_secure,
+                         const std::size_t size,
+                         std::vector<CacheBlk*>& evict_blks,
+                         const MasterID master_id) override;
+
+    /**
+     * Get the blocks on the path to the victim found by the last walk.
+     *
+     * @return The blocks to be moved.
+     */
+    const std::vector<CacheBlk*> &
+    getRelocatedBlks() const override
+    {
+        return relocatedBlks;
+    }
+
+    /**
+     * Move the blocks on the path to the (now evicted) victim found by
+     * the last walk one step along the path, which frees the entry
+     * returned by findVictim().
+     */
+    void relocateBlks() override;
+};
+
+#endif //__MEM_CACHE_TAGS_ZCACHE_TAGS_HH__
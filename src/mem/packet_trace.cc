@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/packet_trace.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+using namespace std;
+
+const char PacketTraceStream::magic[8] =
+    {'g', 'e', 'm', '5', 'p', 't', 'r', 'c'};
+
+namespace
+{
+
+/**
+ * Fixed part of the trace header. It is followed by the object id,
+ * the id strings as (key, length, characters) tuples and padding up
+ * to the alignment of the records.
+ */
+struct PacketTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t tickFreq;
+    uint32_t objIdLen;
+    uint32_t numIdStrings;
+};
+
+} // anonymous namespace
+
+bool
+PacketTraceStream::isPacketTrace(const string &filename)
+{
+    ifstream file(filename, ios::in | ios::binary);
+    char buf[sizeof(magic)];
+    return file.read(buf, sizeof(buf)) && !memcmp(buf, magic, sizeof(buf));
+}
+
+PacketTraceOutputStream::PacketTraceOutputStream(const string &filename)
+    : fileName(filename), file(fopen(filename.c_str(), "wb")), done(false)
+{
+    if (!file)
+        panic("Could not open %s for writing\n", filename);
+
+    buffer.reserve(bufferRecords);
+    pending.reserve(bufferRecords);
+    writer = thread(&PacketTraceOutputStream::writerLoop, this);
+}
+
+PacketTraceOutputStream::~PacketTraceOutputStream()
+{
+    if (!buffer.empty())
+        flushBuffer();
+
+    {
+        lock_guard<mutex> lock(bufferMutex);
+        done = true;
+    }
+    bufferCond.notify_all();
+    writer.join();
+
+    if (fclose(file))
+        panic("Failed to close %s\n", fileName);
+}
+
+void
+PacketTraceOutputStream::writeHeader(const string &obj_id, uint64_t tick_freq,
+                                     const map<uint32_t, string> &id_strings)
+{
+    PacketTraceHeader header;
+    memcpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.recordSize = sizeof(PacketTraceRecord);
+    header.tickFreq = tick_freq;
+    header.objIdLen = obj_id.size();
+    header.numIdStrings = id_strings.size();
+
+    vector<uint8_t> data((const uint8_t *)&header,
+                         (const uint8_t *)&header + sizeof(header));
+    data.insert(data.end(), obj_id.begin(), obj_id.end());
+    for (const auto &id_string : id_strings) {
+        const uint32_t fields[2] = { id_string.first,
+                                     (uint32_t)id_string.second.size() };
+        data.insert(data.end(), (const uint8_t *)fields,
+                    (const uint8_t *)fields + sizeof(fields));
+        data.insert(data.end(), id_string.second.begin(),
+                    id_string.second.end());
+    }
+
+    // align the records to their natural alignment in the file
+    data.resize(roundUp(data.size(), alignof(PacketTraceRecord)));
+
+    // the writer thread only touches the file once records are flushed
+    lock_guard<mutex> lock(bufferMutex);
+    writeData(data.data(), data.size());
+}
+
+void
+PacketTraceOutputStream::flushBuffer()
+{
+    unique_lock<mutex> lock(bufferMutex);
+    // wait for the writer thread to pick up the previous buffer
+    bufferCond.wait(lock, [this]{ return pending.empty(); });
+    pending.swap(buffer);
+    lock.unlock();
+    bufferCond.notify_all();
+}
+
+void
+PacketTraceOutputStream::writerLoop()
+{
+    vector<PacketTraceRecord> records;
+    records.reserve(bufferRecords);
+
+    unique_lock<mutex> lock(bufferMutex);
+    while (true) {
+        bufferCond.wait(lock, [this]{ return done || !pending.empty(); });
+        if (pending.empty())
+            return;
+
+        records.swap(pending);
+        lock.unlock();
+        bufferCond.notify_all();
+
+        writeData(records.data(),
+                  records.size() * sizeof(PacketTraceRecord));
+        records.clear();
+
+        lock.lock();
+    }
+}
+
+void
+PacketTraceOutputStream::writeData(const void *data, size_t len)
+{
+    if (fwrite(data, 1, len, file) != len)
+        panic("Failed to write to %s\n", fileName);
+}
+
+PacketTraceInputStream::PacketTraceInputStream(const string &filename)
+    : fileName(filename), data(nullptr), fileSize(0), records(nullptr),
+      numRecords(0), nextRecord(0), tickFreq(0)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        panic("Could not open %s for reading\n", filename);
+
+    struct stat sb;
+    if (fstat(fd, &sb) || sb.st_size < (off_t)sizeof(PacketTraceHeader))
+        panic("Packet trace %s is truncated\n", filename);
+    fileSize = sb.st_size;
+
+    data = (const uint8_t *)mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE,
+                                 fd, 0);
+    close(fd);
+    if (data == (const uint8_t *)MAP_FAILED)
+        panic("Could not map packet trace %s\n", filename);
+
+    // the trace is read sequentially, let the kernel read ahead
+    madvise((void *)data, fileSize, MADV_SEQUENTIAL);
+
+    PacketTraceHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, magic, sizeof(magic)))
+        panic("%s is not a binary packet trace\n", filename);
+    if (header.version != version ||
+        header.recordSize != sizeof(PacketTraceRecord)) {
+        panic("Packet trace %s has unsupported version %d\n", filename,
+              header.version);
+    }
+    tickFreq = header.tickFreq;
+
+    size_t offset = sizeof(header);
+    auto get = [&](void *dest, size_t len) {
+        if (offset + len > fileSize)
+            panic("Packet trace %s is truncated\n", fileName);
+        memcpy(dest, data + offset, len);
+        offset += len;
+    };
+
+    _objId.resize(header.objIdLen);
+    get(&_objId[0], header.objIdLen);
+    for (uint32_t i = 0; i < header.numIdStrings; ++i) {
+        uint32_t fields[2];
+        get(fields, sizeof(fields));
+        string value(fields[1], '\0');
+        get(&value[0], fields[1]);
+        _idStrings[fields[0]] = value;
+    }
+
+    offset = roundUp(offset, alignof(PacketTraceRecord));
+    if (offset > fileSize)
+        panic("Packet trace %s is truncated\n", filename);
+
+    records = (const PacketTraceRecord *)(data + offset);
+    numRecords = (fileSize - offset) / sizeof(PacketTraceRecord);
+}
+
+PacketTraceInputStream::~PacketTraceInputStream()
+{
+    munmap((void *)data, fileSize);
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of a compact, protobuf-free packet trace format. Each
+ * packet is stored as a fixed-size record after a small header, so
+ * that traces can be written by a background thread with a single
+ * copy per packet and replayed straight from a memory-mapped file.
+ */
+
+#ifndef __MEM_PACKET_TRACE_HH__
+#define __MEM_PACKET_TRACE_HH__
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * A single packet in a binary packet trace. The fields mirror the
+ * ProtoMessage::Packet message, optional fields are zero when absent.
+ */
+struct PacketTraceRecord
+{
+    /** Tick at which the packet was seen */
+    uint64_t tick;
+    /** Address of the request */
+    uint64_t addr;
+    /** PC of the instruction issuing the request, if any */
+    uint64_t pc;
+    /** Generic identifier, e.g. the master id of the request */
+    uint64_t pktId;
+    /** MemCmd of the packet */
+    uint32_t cmd;
+    /** Size of the request in bytes */
+    uint32_t size;
+    /** Request flags */
+    uint32_t flags;
+    /** Padding, always zero */
+    uint32_t reserved;
+};
+
+static_assert(sizeof(PacketTraceRecord) == 48,
+              "Unexpected packet trace record size");
+
+/**
+ * A PacketTraceStream provides the shared functionality of the input
+ * and output streams, i.e. the description of the file header.
+ */
+class PacketTraceStream
+{
+  public:
+    /**
+     * Check if a file is a binary packet trace by looking at its
+     * magic number.
+     *
+     * @param filename Path to the file to check
+     * @return True if the file starts with the binary trace magic
+     */
+    static bool isPacketTrace(const std::string &filename);
+
+  protected:
+    /// Use the ASCII characters gem5ptrc as our magic number
+    static const char magic[8];
+
+    /// Version of the file format
+    static const uint32_t version = 1;
+
+    PacketTraceStream() {}
+
+  private:
+    /**
+     * Hide the copy constructor and assignment operator.
+     * @{
+     */
+    PacketTraceStream(const PacketTraceStream&);
+    PacketTraceStream& operator=(const PacketTraceStream&);
+    /** @} */
+};
+
+/**
+ * A PacketTraceOutputStream buffers records in memory and hands full
+ * buffers to a writer thread, so that tracing only costs a copy of the
+ * record on the simulation thread.
+ */
+class PacketTraceOutputStream : public PacketTraceStream
+{
+  public:
+    /**
+     * Create an output stream for a given file name.
+     *
+     * @param filename Path to the file to create or truncate
+     */
+    PacketTraceOutputStream(const std::string &filename);
+
+    /**
+     * Flush all buffered records, stop the writer thread and close
+     * the file.
+     */
+    ~PacketTraceOutputStream();
+
+    /**
+     * Write the trace header. This must be done once, before any
+     * record is written.
+     *
+     * @param obj_id Name of the object that captured the trace
+     * @param tick_freq Tick frequency of the record time stamps
+     * @param id_strings Names associated with the packet ids
+     */
+    void writeHeader(const std::string &obj_id, uint64_t tick_freq,
+                     const std::map<uint32_t, std::string> &id_strings);
+
+    /**
+     * Append a record to the trace.
+     *
+     * @param record Record to write
+     */
+    void
+    write(const PacketTraceRecord &record)
+    {
+        buffer.push_back(record);
+        if (buffer.size() == bufferRecords)
+            flushBuffer();
+    }
+
+  private:
+    /** Hand the current buffer to the writer thread. */
+    void flushBuffer();
+
+    /** Main loop of the writer thread. */
+    void writerLoop();
+
+    /** Write raw data to the file, called by the writer thread. */
+    void writeData(const void *data, size_t len);
+
+    /// Number of records per buffer
+    static const size_t bufferRecords = 1 << 16;
+
+    /// Hold on to the file name for error messages
+    const std::string fileName;
+
+    /// Underlying file
+    FILE *file;
+
+    /// Buffer currently filled by the simulation thread
+    std::vector<PacketTraceRecord> buffer;
+
+    /// Buffer handed to the writer thread, empty when it is idle
+    std::vector<PacketTraceRecord> pending;
+
+    /// Protects pending and done
+    std::mutex bufferMutex;
+
+    /// Signals changes to pending and done
+    std::condition_variable bufferCond;
+
+    /// Set when the writer thread should exit
+    bool done;
+
+    /// Thread writing the buffers to the file
+    std::thread writer;
+};
+
+/**
+ * A PacketTraceInputStream maps a binary packet trace into memory and
+ * returns its records in order.
+ */
+class PacketTraceInputStream : public PacketTraceStream
+{
+  public:
+    /**
+     * Create an input stream for a given file name and parse the
+     * header of the trace.
+     *
+     * @param filename Path to the file to read from
+     */
+    PacketTraceInputStream(const std::string &filename);
+
+    /**
+     * Unmap the trace.
+     */
+    ~PacketTraceInputStream();
+
+    /**
+     * Read the next record from the trace.
+     *
+     * @param record Record read from the trace
+     * @return True if a record was read, false at the end of the trace
+     */
+    bool
+    read(PacketTraceRecord &record)
+    {
+        if (nextRecord == numRecords)
+            return false;
+        record = records[nextRecord++];
+        return true;
+    }
+
+    /**
+     * Reset the input stream to the first record.
+     */
+    void reset() { nextRecord = 0; }
+
+    /** @return The number of records in the trace */
+    uint64_t size() const { return numRecords; }
+
+    /** @return The name of the object that captured the trace */
+    const std::string &objId() const { return _objId; }
+
+    /** @return The tick frequency of the record time stamps */
+    uint64_t tickFrequency() const { return tickFreq; }
+
+    /** @return The names associated with the packet ids */
+    const std::map<uint32_t, std::string> &
+    idStrings() const
+    {
+        return _idStrings;
+    }
+
+  private:
+    /// Hold on to the file name for error messages
+    const std::string fileName;
+
+    /// The mapped file
+    const uint8_t *data;
+
+    /// Size of the mapped file
+    size_t fileSize;
+
+    /// First record in the mapped file
+    const PacketTraceRecord *records;
+
+    /// Number of records in the trace
+    uint64_t numRecords;
+
+    /// Index of the next record to read
+    uint64_t nextRecord;
+
+    std::string _objId;
+    uint64_t tickFreq;
+    std::map<uint32_t, std::string> _idStrings;
+};
+
+#endif //__MEM_PACKET_TRACE_HH__
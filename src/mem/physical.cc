@@ -44,12 +44,16 @@
 #include <unistd.h>
 #include <zlib.h>
 
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -69,14 +73,103 @@
 
 using namespace std;
 
+namespace
+{
+
+/**
+ * Layout of the chunked physical memory checkpoint files. The file
+ * starts with a header, followed by one index entry per chunk and
+ * the (possibly compressed) chunk payloads. Chunks only containing
+ * zeros have no payload.
+ */
+const char chunkedMagic[8] = {'g', 'e', 'm', '5', 'p', 'm', 'e', 'm'};
+const uint32_t chunkedVersion = 1;
+
+struct ChunkedHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t chunkSize;
+    uint64_t rangeSize;
+    uint64_t numChunks;
+};
+
+enum ChunkType : uint32_t
+{
+    ChunkZero = 0,
+    ChunkStored = 1,
+    ChunkDeflate = 2,
+};
+
+struct ChunkIndexEntry
+{
+    uint64_t offset;
+    uint32_t length;
+    uint32_t type;
+};
+
+/** Check if a memory chunk only contains zeros. */
+bool
+isZeroChunk(const uint8_t *data, uint64_t len)
+{
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word)
+            return false;
+    }
+    for (; i < len; ++i) {
+        if (data[i])
+            return false;
+    }
+    return true;
+}
+
+/** Write a buffer at a given file offset, retrying on short writes. */
+bool
+pwriteAll(int fd, const void *buf, size_t len, off_t offset)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+    while (len) {
+        ssize_t ret = pwrite(fd, p, len, offset);
+        if (ret < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += ret;
+        len -= ret;
+        offset += ret;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 PhysicalMemory::PhysicalMemory(const string& _name,
                                const vector<AbstractMemory*>& _memories,
-                               bool mmap_using_noreserve) :
-    _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve)
+                               bool mmap_using_noreserve,
+                               MemoryCheckpointFormat checkpoint_format,
+                               uint64_t checkpoint_chunk_size,
+                               unsigned checkpoint_threads,
+                               bool checkpoint_cow) :
+    _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
+    checkpointFormat(checkpoint_format),
+    checkpointChunkSize(checkpoint_chunk_size),
+    checkpointThreads(checkpoint_threads ? checkpoint_threads :
+                      max(thread::hardware_concurrency(), 1u)),
+    checkpointCow(checkpoint_cow)
 {
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
 
+    fatal_if(checkpointFormat != MemoryCheckpointFormat::gzip &&
+             (checkpointChunkSize == 0 || checkpointChunkSize > INT_MAX),
+             "Invalid physical memory checkpoint chunk size %d\n",
+             checkpointChunkSize);
+
     // add the memories from the system to the address map as
     // appropriate
     for (const auto& m : _memories) {
@@ -328,20 +421,49 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     // memories that are not part of the address map can overlap
     string filename = name() + ".store" + to_string(store_id) + ".pmem";
     long range_size = range.size();
+    string format =
+        MemoryCheckpointFormatStrings[static_cast<int>(checkpointFormat)];
 
-    DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
-            filename, range_size);
+    DPRINTF(Checkpoint, "Serializing physical memory %s with size %d "
+            "(%s)\n", filename, range_size, format);
 
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(format);
 
     // write memory file
     string filepath = CheckpointIn::dir() + "/" + filename.c_str();
+
+    // The store may be mapped copy-on-write from the file of a previous
+    // checkpoint in the same directory. Truncating that file in place
+    // would pull the pages the guest never touched from under the
+    // mapping, so replace the directory entry instead and leave the old
+    // inode alive for as long as it is mapped.
+    if (unlink(filepath.c_str()) && errno != ENOENT)
+        fatal("Can't remove old physical memory checkpoint file '%s': %s\n",
+              filepath, strerror(errno));
+
+    switch (checkpointFormat) {
+      case MemoryCheckpointFormat::chunked:
+        serializeStoreChunked(filepath, range, pmem);
+        break;
+      case MemoryCheckpointFormat::raw:
+        serializeStoreRaw(filepath, range, pmem);
+        break;
+      default:
+        serializeStoreGzip(filepath, range, pmem);
+    }
+}
+
+void
+PhysicalMemory::serializeStoreGzip(const string &filepath, AddrRange range,
+                                   uint8_t* pmem) const
+{
     gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
     if (compressed_mem == NULL)
         fatal("Can't open physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
 
     uint64_t pass_size = 0;
 
@@ -354,7 +476,7 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
         if (gzwrite(compressed_mem, pmem + written,
                     (unsigned int) pass_size) != (int) pass_size) {
             fatal("Write failed on physical memory checkpoint file '%s'\n",
-                  filename);
+                  filepath);
         }
     }
 
@@ -362,8 +484,146 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     // is zero
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+
+}
 
+void
+PhysicalMemory::parallelForChunks(uint64_t num_chunks,
+                                  const function<void(uint64_t)> &f) const
+{
+    atomic<uint64_t> next_chunk(0);
+    auto worker = [&]() {
+        for (uint64_t c = next_chunk++; c < num_chunks; c = next_chunk++)
+            f(c);
+    };
+
+    unsigned num_threads = min<uint64_t>(checkpointThreads, num_chunks);
+    vector<thread> workers;
+    for (unsigned t = 1; t < num_threads; ++t)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &w : workers)
+        w.join();
+}
+
+void
+PhysicalMemory::serializeStoreChunked(const string &filepath,
+                                      AddrRange range, uint8_t* pmem) const
+{
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    const uint64_t range_size = range.size();
+    const uint64_t num_chunks = divCeil(range_size, checkpointChunkSize);
+
+    ChunkedHeader header;
+    memcpy(header.magic, chunkedMagic, sizeof(header.magic));
+    header.version = chunkedVersion;
+    header.reserved = 0;
+    header.chunkSize = checkpointChunkSize;
+    header.rangeSize = range_size;
+    header.numChunks = num_chunks;
+
+    vector<ChunkIndexEntry> index(num_chunks);
+    uint64_t offset = sizeof(header) + num_chunks * sizeof(ChunkIndexEntry);
+
+    // Compress a batch of chunks in parallel and then append them to
+    // the file in order. Bounding the batch size bounds the amount of
+    // host memory used for the compressed data.
+    const uint64_t batch_size = checkpointThreads * 4;
+    vector<vector<uint8_t>> buffers(batch_size);
+    for (uint64_t first = 0; first < num_chunks; first += batch_size) {
+        const uint64_t batch = min(batch_size, num_chunks - first);
+
+        parallelForChunks(batch, [&](uint64_t i) {
+            const uint64_t c = first + i;
+            const uint8_t *src = pmem + c * checkpointChunkSize;
+            const uint64_t len =
+                min(checkpointChunkSize, range_size - c * checkpointChunkSize);
+            auto &buf = buffers[i];
+            auto &entry = index[c];
+
+            if (isZeroChunk(src, len)) {
+                entry.type = ChunkZero;
+                entry.length = 0;
+                buf.clear();
+                return;
+            }
+
+            uLongf dest_len = compressBound(len);
+            buf.resize(dest_len);
+            if (compress2(buf.data(), &dest_len, src, len,
+                          Z_BEST_SPEED) == Z_OK && dest_len < len) {
+                entry.type = ChunkDeflate;
+                entry.length = dest_len;
+                buf.resize(dest_len);
+            } else {
+                // incompressible data is stored as is
+                entry.type = ChunkStored;
+                entry.length = len;
+                buf.assign(src, src + len);
+            }
+        });
+
+        for (uint64_t i = 0; i < batch; ++i) {
+            auto &entry = index[first + i];
+            entry.offset = offset;
+            if (entry.length &&
+                !pwriteAll(fd, buffers[i].data(), entry.length, offset)) {
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s'\n", filepath);
+            }
+            offset += entry.length;
+        }
+    }
+
+    if (!pwriteAll(fd, &header, sizeof(header), 0) ||
+        !pwriteAll(fd, index.data(), num_chunks * sizeof(ChunkIndexEntry),
+                   sizeof(header))) {
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              filepath);
+    }
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+}
+
+void
+PhysicalMemory::serializeStoreRaw(const string &filepath, AddrRange range,
+                                  uint8_t* pmem) const
+{
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    // size the file up front, the zero chunks are left as holes
+    const uint64_t range_size = range.size();
+    if (ftruncate(fd, range_size))
+        fatal("Can't resize physical memory checkpoint file '%s'\n",
+              filepath);
+
+    atomic<bool> failed(false);
+    parallelForChunks(divCeil(range_size, checkpointChunkSize),
+                      [&](uint64_t c) {
+        const uint64_t offset = c * checkpointChunkSize;
+        const uint64_t len = min(checkpointChunkSize, range_size - offset);
+        if (!isZeroChunk(pmem + offset, len) &&
+            !pwriteAll(fd, pmem + offset, len, offset)) {
+            failed = true;
+        }
+    });
+
+    fatal_if(failed, "Write failed on physical memory checkpoint file "
+             "'%s'\n", filepath);
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
 }
 
 void
@@ -394,8 +654,6 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -403,10 +661,10 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp.getCptDir() + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
+    // checkpoints predating the chunked format only store gzip streams
+    string format;
+    if (!UNSERIALIZE_OPT_SCALAR(format))
+        format = "gzip";
 
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
@@ -415,13 +673,39 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     long range_size;
     UNSERIALIZE_SCALAR(range_size);
 
-    DPRINTF(Checkpoint, "Unserializing physical memory %s with size %d\n",
-            filename, range_size);
+    DPRINTF(Checkpoint, "Unserializing physical memory %s with size %d "
+            "(%s)\n", filename, range_size, format);
 
     if (range_size != range.size())
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    if (format == "chunked") {
+        unserializeStoreChunked(filepath, range, pmem);
+    } else if (format == "raw") {
+        // KVM may already have registered the anonymous mapping with
+        // the guest, so it cannot be replaced
+        bool cow = checkpointCow && !backingStore[store_id].kvmMap;
+        warn_if(checkpointCow && !cow, "Not mapping physical memory "
+                "checkpoint '%s' copy-on-write, the store is KVM mapped\n",
+                filename);
+        unserializeStoreRaw(filepath, range, pmem, cow);
+    } else if (format == "gzip")
+        unserializeStoreGzip(filepath, range, pmem);
+    else
+        fatal("Unknown physical memory checkpoint format '%s'\n", format);
+}
+
+void
+PhysicalMemory::unserializeStoreGzip(const string &filepath, AddrRange range,
+                                     uint8_t* pmem)
+{
+    const uint32_t chunk_size = 16384;
+
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filepath);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
@@ -448,5 +732,145 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
 
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              filepath);
+}
+
+void
+PhysicalMemory::unserializeStoreChunked(const string &filepath,
+                                        AddrRange range, uint8_t* pmem)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    off_t file_size = lseek(fd, 0, SEEK_END);
+    fatal_if(file_size < (off_t)sizeof(ChunkedHeader),
+             "Physical memory checkpoint file '%s' is truncated\n",
+             filepath);
+
+    // map the file rather than reading it, only the pages holding
+    // non-zero chunks are ever brought in from disk
+    const uint8_t *data = (const uint8_t *)mmap(NULL, file_size, PROT_READ,
+                                                MAP_SHARED, fd, 0);
+    if (data == (const uint8_t *)MAP_FAILED) {
+        perror("mmap");
+        fatal("Could not mmap physical memory checkpoint file '%s'\n",
+              filepath);
+    }
+    close(fd);
+
+    ChunkedHeader header;
+    memcpy(&header, data, sizeof(header));
+    fatal_if(memcmp(header.magic, chunkedMagic, sizeof(header.magic)) ||
+             header.version != chunkedVersion,
+             "Physical memory checkpoint file '%s' is not in the chunked "
+             "format\n", filepath);
+    fatal_if(header.rangeSize != range.size() || header.chunkSize == 0 ||
+             header.numChunks != divCeil(header.rangeSize, header.chunkSize),
+             "Physical memory checkpoint file '%s' does not match the "
+             "backing store\n", filepath);
+
+    const uint64_t index_end =
+        sizeof(header) + header.numChunks * sizeof(ChunkIndexEntry);
+    fatal_if(index_end > (uint64_t)file_size,
+             "Physical memory checkpoint file '%s' is truncated\n",
+             filepath);
+    const ChunkIndexEntry *index =
+        (const ChunkIndexEntry *)(data + sizeof(header));
+
+    atomic<bool> failed(false);
+    parallelForChunks(header.numChunks, [&](uint64_t c) {
+        const ChunkIndexEntry &entry = index[c];
+        uint8_t *dest = pmem + c * header.chunkSize;
+        const uint64_t len = min(header.chunkSize,
+                                 header.rangeSize - c * header.chunkSize);
+
+        if (entry.type == ChunkZero)
+            return;
+
+        if (entry.offset + entry.length > (uint64_t)file_size) {
+            failed = true;
+            return;
+        }
+
+        const uint8_t *src = data + entry.offset;
+        if (entry.type == ChunkStored && entry.length == len) {
+            memcpy(dest, src, len);
+        } else if (entry.type == ChunkDeflate) {
+            uLongf dest_len = len;
+            if (uncompress(dest, &dest_len, src, entry.length) != Z_OK ||
+                dest_len != len) {
+                failed = true;
+            }
+        } else {
+            failed = true;
+        }
+    });
+
+    munmap((void *)data, file_size);
+
+    fatal_if(failed, "Physical memory checkpoint file '%s' is corrupt\n",
+             filepath);
+}
+
+void
+PhysicalMemory::unserializeStoreRaw(const string &filepath, AddrRange range,
+                                    uint8_t* pmem, bool cow)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    const uint64_t range_size = range.size();
+    fatal_if(lseek(fd, 0, SEEK_END) != (off_t)range_size,
+             "Physical memory checkpoint file '%s' does not match the "
+             "backing store\n", filepath);
+
+    if (cow) {
+        // replace the anonymous mapping in place, so the memories keep
+        // pointing at the same host address
+        int map_flags = MAP_PRIVATE | MAP_FIXED;
+        if (mmapUsingNoReserve)
+            map_flags |= MAP_NORESERVE;
+
+        if (mmap(pmem, range_size, PROT_READ | PROT_WRITE, map_flags,
+                 fd, 0) == MAP_FAILED) {
+            perror("mmap");
+            fatal("Could not map physical memory checkpoint file '%s'\n",
+                  filepath);
+        }
+        close(fd);
+        return;
+    }
+
+    atomic<bool> failed(false);
+    parallelForChunks(divCeil(range_size, checkpointChunkSize),
+                      [&](uint64_t c) {
+        const uint64_t offset = c * checkpointChunkSize;
+        const uint64_t len = min(checkpointChunkSize, range_size - offset);
+        vector<uint8_t> buf(len);
+        uint64_t done = 0;
+        while (done < len) {
+            ssize_t ret = pread(fd, buf.data() + done, len - done,
+                                offset + done);
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret <= 0) {
+                failed = true;
+                return;
+            }
+            done += ret;
+        }
+
+        // leave the pages of zero chunks untouched
+        if (!isZeroChunk(buf.data(), len))
+            memcpy(pmem + offset, buf.data(), len);
+    });
+
+    close(fd);
+
+    fatal_if(failed, "Read failed on physical memory checkpoint file "
+             "'%s'\n", filepath);
 }
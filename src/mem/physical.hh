@@ -38,7 +38,10 @@
 #ifndef __MEM_PHYSICAL_HH__
 #define __MEM_PHYSICAL_HH__
 
+#include <functional>
+
 #include "base/addr_range_map.hh"
+#include "enums/MemoryCheckpointFormat.hh"
 #include "mem/packet.hh"
 
 /**
@@ -131,6 +134,18 @@ class PhysicalMemory : public Serializable
     // system
     std::vector<BackingStoreEntry> backingStore;
 
+    // File format used when serializing the backing stores
+    const MemoryCheckpointFormat checkpointFormat;
+
+    // Size of the independently compressed chunks of the chunked format
+    const uint64_t checkpointChunkSize;
+
+    // Number of host threads used to (de)compress the chunks
+    const unsigned checkpointThreads;
+
+    // Map raw checkpoint images copy-on-write when restoring
+    const bool checkpointCow;
+
     // Prevent copying
     PhysicalMemory(const PhysicalMemory&);
 
@@ -151,6 +166,86 @@ class PhysicalMemory : public Serializable
                             bool conf_table_reported,
                             bool in_addr_map, bool kvm_map);
 
+    /**
+     * Write a backing store as a single gzip stream.
+     *
+     * @param filepath Path of the file to create
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void serializeStoreGzip(const std::string &filepath, AddrRange range,
+                            uint8_t* pmem) const;
+
+    /**
+     * Write a backing store in the chunked format. The store is split
+     * in chunks of checkpointChunkSize bytes which are compressed
+     * independently by a pool of host threads. Chunks that only
+     * contain zeros are recorded in the chunk index but not stored.
+     *
+     * @param filepath Path of the file to create
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void serializeStoreChunked(const std::string &filepath,
+                               AddrRange range, uint8_t* pmem) const;
+
+    /**
+     * Write a backing store as an uncompressed image. The file is
+     * created sparse and only the chunks that are not all zero are
+     * written, in parallel.
+     *
+     * @param filepath Path of the file to create
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void serializeStoreRaw(const std::string &filepath, AddrRange range,
+                           uint8_t* pmem) const;
+
+    /**
+     * Read a backing store written as a single gzip stream.
+     *
+     * @param filepath Path of the file to read
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void unserializeStoreGzip(const std::string &filepath, AddrRange range,
+                              uint8_t* pmem);
+
+    /**
+     * Read a backing store written in the chunked format. The file is
+     * mapped read-only and the chunks are decompressed in parallel
+     * straight into the backing store, leaving the pages of zero
+     * chunks untouched.
+     *
+     * @param filepath Path of the file to read
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void unserializeStoreChunked(const std::string &filepath,
+                                 AddrRange range, uint8_t* pmem);
+
+    /**
+     * Read a backing store written as an uncompressed image. When
+     * copy-on-write restore is enabled the image replaces the
+     * anonymous mapping of the backing store, which makes restoring
+     * proportional to the number of pages touched afterwards rather
+     * than to the size of the store.
+     *
+     * @param filepath Path of the file to read
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     * @param cow Map the image copy-on-write instead of reading it
+     */
+    void unserializeStoreRaw(const std::string &filepath, AddrRange range,
+                             uint8_t* pmem, bool cow);
+
+    /**
+     * Apply a function to all chunk indices in [0, num_chunks) using
+     * the configured number of host threads.
+     */
+    void parallelForChunks(uint64_t num_chunks,
+                           const std::function<void(uint64_t)> &f) const;
+
   public:
 
     /**
@@ -158,7 +253,12 @@ class PhysicalMemory : public Serializable
      */
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
-                   bool mmap_using_noreserve);
+                   bool mmap_using_noreserve,
+                   MemoryCheckpointFormat checkpoint_format =
+                       MemoryCheckpointFormat::gzip,
+                   uint64_t checkpoint_chunk_size = 0,
+                   unsigned checkpoint_threads = 0,
+                   bool checkpoint_cow = false);
 
     /**
      * Unmap all the backing store we have used.
@@ -37,12 +37,35 @@
 
 #include "mem/port_proxy.hh"
 
+#include <algorithm>
+#include <cstring>
+
 #include "base/chunk_generator.hh"
 
+uint8_t *
+PortProxy::backdoorPtr(Addr addr, int size, bool write) const
+{
+    if (!getBackdoor || size <= 0)
+        return nullptr;
+
+    const AddrRange range = RangeSize(addr, size);
+    MemBackdoorPtr bd = getBackdoor(range);
+    if (!bd || !(write ? bd->writeable() : bd->readable()) ||
+        bd->range().interleaved() || !range.isSubset(bd->range()))
+        return nullptr;
+
+    return bd->ptr() + (addr - bd->range().start());
+}
+
 void
 PortProxy::readBlobPhys(Addr addr, Request::Flags flags,
                         void *p, int size) const
 {
+    if (uint8_t *host = backdoorPtr(addr, size, false)) {
+        std::memcpy(p, host, size);
+        return;
+    }
+
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
 
@@ -60,6 +83,11 @@ void
 PortProxy::writeBlobPhys(Addr addr, Request::Flags flags,
                          const void *p, int size) const
 {
+    if (uint8_t *host = backdoorPtr(addr, size, true)) {
+        std::memcpy(host, p, size);
+        return;
+    }
+
     for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
          gen.next()) {
 
@@ -77,6 +105,11 @@ void
 PortProxy::memsetBlobPhys(Addr addr, Request::Flags flags,
                           uint8_t v, int size) const
 {
+    if (uint8_t *host = backdoorPtr(addr, size, true)) {
+        std::memset(host, v, size);
+        return;
+    }
+
     // quick and dirty...
     uint8_t *buf = new uint8_t[size];
 
@@ -87,25 +120,49 @@ PortProxy::memsetBlobPhys(Addr addr, Request::Flags flags,
 }
 
 bool
-PortProxy::tryWriteString(Addr addr, const char *str) const
+PortProxy::hostRangesPhys(Addr addr, int size, bool write,
+                          std::vector<struct iovec> &iovs) const
 {
-    do {
-        if (!tryWriteBlob(addr++, str, 1))
-            return false;
-    } while (*str++);
+    uint8_t *host = backdoorPtr(addr, size, write);
+    if (!host)
+        return false;
+
+    if (!iovs.empty()) {
+        struct iovec &last = iovs.back();
+        if (static_cast<uint8_t *>(last.iov_base) + last.iov_len == host) {
+            last.iov_len += size;
+            return true;
+        }
+    }
+    iovs.push_back({ host, static_cast<size_t>(size) });
     return true;
 }
 
+bool
+PortProxy::tryWriteString(Addr addr, const char *str) const
+{
+    return tryWriteBlob(addr, str, std::strlen(str) + 1);
+}
+
 bool
 PortProxy::tryReadString(std::string &str, Addr addr) const
 {
+    // Read a cache line at a time rather than a byte at a time. A line
+    // never straddles a page, so this doesn't touch any page the string
+    // itself doesn't.
+    std::vector<char> buf(_cacheLineSize);
     while (true) {
-        uint8_t c;
-        if (!tryReadBlob(addr++, &c, 1))
+        int chunk = _cacheLineSize - (addr % _cacheLineSize);
+        if (!tryReadBlob(addr, buf.data(), chunk))
             return false;
-        if (!c)
+        const char *end = static_cast<const char *>(
+                std::memchr(buf.data(), 0, chunk));
+        if (end) {
+            str.append(buf.data(), end - buf.data());
             return true;
-        str += c;
+        }
+        str.append(buf.data(), chunk);
+        addr += chunk;
     }
 }
 
@@ -113,11 +170,16 @@ bool
 PortProxy::tryReadString(char *str, Addr addr, size_t maxlen) const
 {
     assert(maxlen);
-    while (maxlen--) {
-        if (!tryReadBlob(addr++, str, 1))
+    while (maxlen) {
+        size_t chunk = std::min<size_t>(
+                _cacheLineSize - (addr % _cacheLineSize), maxlen);
+        if (!tryReadBlob(addr, str, chunk))
             return false;
-        if (!*str++)
+        if (std::memchr(str, 0, chunk))
             return true;
+        str += chunk;
+        addr += chunk;
+        maxlen -= chunk;
     }
     // We ran out of room, so back up and add a terminator.
     *--str = '\0';
@@ -57,9 +57,13 @@
 #ifndef __MEM_PORT_PROXY_HH__
 #define __MEM_PORT_PROXY_HH__
 
+#include <sys/uio.h>
+
 #include <functional>
 #include <limits>
+#include <vector>
 
+#include "mem/backdoor.hh"
 #include "mem/port.hh"
 #include "sim/byteswap.hh"
 
@@ -82,9 +86,20 @@ class PortProxy : FunctionalRequestProtocol
   public:
     typedef std::function<void(PacketPtr pkt)> SendFunctionalFunc;
 
+    /**
+     * Returns a backdoor covering the given physical range if one is
+     * available, or nullptr if the range has to be accessed through
+     * functional packets.
+     */
+    typedef std::function<MemBackdoorPtr(const AddrRange &range)>
+        BackdoorFunc;
+
   private:
     SendFunctionalFunc sendFunctional;
 
+    /** Optional source of backdoors for bulk physical accesses. */
+    BackdoorFunc getBackdoor;
+
     /** Granularity of any transactions issued through this proxy. */
     const unsigned int _cacheLineSize;
 
@@ -107,6 +122,19 @@ class PortProxy : FunctionalRequestProtocol
     {}
     virtual ~PortProxy() { }
 
+    /**
+     * Let the proxy copy straight to and from the backing store of any
+     * physical range a backdoor is handed out for. This is only safe
+     * when there are no caches between the proxy and the memory the
+     * backdoor refers to.
+     */
+    void setBackdoorFunc(BackdoorFunc func) { getBackdoor = func; }
+
+    /**
+     * Host pointer to size bytes at physical address addr, or nullptr if
+     * no backdoor with the required permission covers the range.
+     */
+    uint8_t *backdoorPtr(Addr addr, int size, bool write) const;
 
 
     /** Fixed functionality for use in base classes. */
@@ -129,6 +157,14 @@ class PortProxy : FunctionalRequestProtocol
     void memsetBlobPhys(Addr addr, Request::Flags flags,
                         uint8_t v, int size) const;
 
+    /**
+     * Append host iovecs covering size bytes at physical address addr
+     * to iovs, merging with the last entry when they are adjacent.
+     * Returns false if the range isn't reachable through a backdoor.
+     */
+    bool hostRangesPhys(Addr addr, int size, bool write,
+                        std::vector<struct iovec> &iovs) const;
+
 
 
     /** Methods to override in base classes */
@@ -166,6 +202,19 @@ class PortProxy : FunctionalRequestProtocol
         return true;
     }
 
+    /**
+     * Append host iovecs that alias the size bytes at address addr to
+     * iovs, so that host system calls can operate on guest memory
+     * directly. Returns false, leaving iovs in an unspecified state, if
+     * any part of the range can't be mapped that way.
+     */
+    virtual bool
+    tryHostRanges(Addr addr, int size, bool write,
+                  std::vector<struct iovec> &iovs) const
+    {
+        return hostRangesPhys(addr, size, write, iovs);
+    }
+
 
 
     /** Higher level interfaces based on the above. */
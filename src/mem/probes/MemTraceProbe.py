@@ -37,12 +37,25 @@ from m5.params import *
 from m5.proxy import *
 from m5.objects.BaseMemProbe import BaseMemProbe
 
+class PacketTraceFormat(ScopedEnum): vals = ['protobuf', 'binary']
+
 class MemTraceProbe(BaseMemProbe):
     type = 'MemTraceProbe'
     cxx_header = "mem/probes/mem_trace.hh"
 
-    # Boolean to compress the trace or not.
-    trace_compress = Param.Bool(True, "Enable trace compression")
+    # The protobuf format is compressed and understood by all trace
+    # consumers. The binary format uses fixed-size records written by
+    # a background thread, which keeps tracing overhead low and can be
+    # replayed by TrafficGen and the TraceCPU instruction trace without
+    # protobuf parsing. util/convert_packet_trace.py converts between
+    # the two formats.
+    trace_format = Param.PacketTraceFormat('protobuf',
+        "Format of the packet trace")
+
+    # Boolean to compress the trace or not. Only the protobuf format is
+    # compressed, binary traces ignore this.
+    trace_compress = Param.Bool(True,
+        "Enable trace compression (ignored by the binary format)")
 
     # For requests with a valid PC, include the PC in the trace
     with_pc = Param.Bool(False, "Include PC info in the trace")
@@ -46,11 +46,18 @@
 MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
     : BaseMemProbe(p),
       traceStream(nullptr),
+      binaryTraceStream(nullptr),
       system(p->system),
       withPC(p->with_pc)
 {
+    // The binary format is never compressed, whatever trace_compress says
+    const bool binary = p->trace_format == PacketTraceFormat::binary;
+
     std::string filename;
-    if (p->trace_file != "") {
+    if (binary) {
+        filename = simout.resolve(p->trace_file != "" ? p->trace_file :
+                                  name() + ".trc");
+    } else if (p->trace_file != "") {
         // If the trace file is not specified as an absolute path,
         // append the current simulation output directory
         filename = simout.resolve(p->trace_file);
@@ -69,7 +76,10 @@ MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
                                   (p->trace_compress ? ".gz" : ""));
     }
 
-    traceStream = new ProtoOutputStream(filename);
+    if (binary)
+        binaryTraceStream = new PacketTraceOutputStream(filename);
+    else
+        traceStream = new ProtoOutputStream(filename);
 
     // Register a callback to compensate for the destructor not
     // being called. The callback forces the stream to flush and
@@ -81,6 +91,16 @@ MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
 void
 MemTraceProbe::startup()
 {
+    if (binaryTraceStream) {
+        std::map<uint32_t, std::string> id_strings;
+        for (int i = 0; i < system->maxMasters(); i++)
+            id_strings[i] = system->getMasterName(i);
+
+        binaryTraceStream->writeHeader(name(), SimClock::Frequency,
+                                       id_strings);
+        return;
+    }
+
     // Create a protobuf message for the header and write it to
     // the stream
     ProtoMessage::PacketHeader header_msg;
@@ -101,11 +121,27 @@ MemTraceProbe::closeStreams()
 {
     if (traceStream != NULL)
         delete traceStream;
+    if (binaryTraceStream != NULL)
+        delete binaryTraceStream;
 }
 
 void
 MemTraceProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
 {
+    if (binaryTraceStream) {
+        PacketTraceRecord record;
+        record.tick = curTick();
+        record.addr = pkt_info.addr;
+        record.pc = withPC ? pkt_info.pc : 0;
+        record.pktId = pkt_info.master;
+        record.cmd = pkt_info.cmd.toInt();
+        record.size = pkt_info.size;
+        record.flags = pkt_info.flags;
+        record.reserved = 0;
+        binaryTraceStream->write(record);
+        return;
+    }
+
     ProtoMessage::Packet pkt_msg;
 
     pkt_msg.set_tick(curTick());
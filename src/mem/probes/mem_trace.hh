@@ -39,6 +39,7 @@
 #define __MEM_PROBES_MEM_TRACE_HH__
 
 #include "mem/packet.hh"
+#include "mem/packet_trace.hh"
 #include "mem/probes/base.hh"
 #include "proto/protoio.hh"
 
@@ -66,6 +67,9 @@ class MemTraceProbe : public BaseMemProbe
     /** Trace output stream */
     ProtoOutputStream *traceStream;
 
+    /** Binary trace output stream, used instead of traceStream */
+    PacketTraceOutputStream *binaryTraceStream;
+
     System *system;
 
   private:
@@ -56,7 +56,9 @@ TranslatingPortProxy::TranslatingPortProxy(
               tc->getSystemPtr()->cacheLineSize()), _tc(tc),
               pageBytes(tc->getSystemPtr()->getPageBytes()),
               flags(_flags)
-{}
+{
+    setBackdoorFunc(tc->getCpuPtr()->getBackdoorFunc());
+}
 
 bool
 TranslatingPortProxy::tryTLBsOnce(RequestPtr req, BaseTLB::Mode mode) const
@@ -77,8 +79,14 @@ TranslatingPortProxy::tryTLBs(RequestPtr req, BaseTLB::Mode mode) const
 }
 
 bool
-TranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
+TranslatingPortProxy::forEachPhysRun(Addr addr, int size, BaseTLB::Mode mode,
+                                     const PhysRunFunc &func) const
 {
+    Addr run_paddr = 0;
+    Request::Flags run_flags = 0;
+    int run_offset = 0;
+    int run_size = 0;
+
     for (ChunkGenerator gen(addr, size, pageBytes); !gen.done();
          gen.next())
     {
@@ -86,53 +94,70 @@ TranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
                 gen.addr(), gen.size(), flags, Request::funcMasterId, 0,
                 _tc->contextId());
 
-        if (!tryTLBs(req, BaseTLB::Read))
+        if (!tryTLBs(req, mode))
             return false;
 
-        PortProxy::readBlobPhys(
-                req->getPaddr(), req->getFlags(), p, gen.size());
+        if (run_size && req->getPaddr() == run_paddr + run_size &&
+            req->getFlags() == run_flags) {
+            run_size += gen.size();
+            continue;
+        }
+
+        if (run_size)
+            func(run_paddr, run_flags, run_offset, run_size);
 
-        p = static_cast<uint8_t *>(p) + gen.size();
+        run_paddr = req->getPaddr();
+        run_flags = req->getFlags();
+        run_offset = gen.addr() - addr;
+        run_size = gen.size();
     }
+
+    if (run_size)
+        func(run_paddr, run_flags, run_offset, run_size);
     return true;
 }
 
+bool
+TranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
+{
+    return forEachPhysRun(addr, size, BaseTLB::Read,
+        [this, p](Addr paddr, Request::Flags flags, int offset, int len) {
+            PortProxy::readBlobPhys(paddr, flags,
+                                    static_cast<uint8_t *>(p) + offset, len);
+        });
+}
+
 bool
 TranslatingPortProxy::tryWriteBlob(
         Addr addr, const void *p, int size) const
 {
-    for (ChunkGenerator gen(addr, size, pageBytes); !gen.done();
-         gen.next())
-    {
-        auto req = std::make_shared<Request>(
-                gen.addr(), gen.size(), flags, Request::funcMasterId, 0,
-                _tc->contextId());
-
-        if (!tryTLBs(req, BaseTLB::Write))
-            return false;
-
-        PortProxy::writeBlobPhys(
-                req->getPaddr(), req->getFlags(), p, gen.size());
-        p = static_cast<const uint8_t *>(p) + gen.size();
-    }
-    return true;
+    return forEachPhysRun(addr, size, BaseTLB::Write,
+        [this, p](Addr paddr, Request::Flags flags, int offset, int len) {
+            PortProxy::writeBlobPhys(
+                    paddr, flags, static_cast<const uint8_t *>(p) + offset,
+                    len);
+        });
 }
 
 bool
 TranslatingPortProxy::tryMemsetBlob(Addr address, uint8_t v, int size) const
 {
-    for (ChunkGenerator gen(address, size, pageBytes); !gen.done();
-         gen.next())
-    {
-        auto req = std::make_shared<Request>(
-                gen.addr(), gen.size(), flags, Request::funcMasterId, 0,
-                _tc->contextId());
-
-        if (!tryTLBs(req, BaseTLB::Write))
-            return false;
+    return forEachPhysRun(address, size, BaseTLB::Write,
+        [this, v](Addr paddr, Request::Flags flags, int offset, int len) {
+            PortProxy::memsetBlobPhys(paddr, flags, v, len);
+        });
+}
 
-        PortProxy::memsetBlobPhys(
-                req->getPaddr(), req->getFlags(), v, gen.size());
-    }
-    return true;
+bool
+TranslatingPortProxy::tryHostRanges(Addr addr, int size, bool write,
+                                    std::vector<struct iovec> &iovs) const
+{
+    bool mapped = true;
+    bool translated = forEachPhysRun(addr, size,
+        write ? BaseTLB::Write : BaseTLB::Read,
+        [this, write, &iovs, &mapped](Addr paddr, Request::Flags flags,
+                                      int offset, int len) {
+            mapped = mapped && hostRangesPhys(paddr, len, write, iovs);
+        });
+    return translated && mapped;
 }
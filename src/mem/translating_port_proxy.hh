@@ -58,6 +58,18 @@ class TranslatingPortProxy : public PortProxy
     bool tryTLBsOnce(RequestPtr req, BaseTLB::Mode) const;
     bool tryTLBs(RequestPtr req, BaseTLB::Mode) const;
 
+    typedef std::function<void(Addr paddr, Request::Flags flags,
+                               int offset, int size)> PhysRunFunc;
+
+    /**
+     * Translate size bytes at addr a page at a time and call func once
+     * for every run of pages that are contiguous in physical memory, so
+     * that each run is transferred in bulk. The offset passed to func is
+     * relative to addr. Returns false if any page fails to translate.
+     */
+    bool forEachPhysRun(Addr addr, int size, BaseTLB::Mode mode,
+                        const PhysRunFunc &func) const;
+
   protected:
     ThreadContext* _tc;
     const Addr pageBytes;
@@ -86,6 +98,10 @@ class TranslatingPortProxy : public PortProxy
      * Fill size bytes starting at addr with byte value val.
      */
     bool tryMemsetBlob(Addr address, uint8_t  v, int size) const override;
+
+    /** Version of tryHostRanges that translates virt->phys. */
+    bool tryHostRanges(Addr addr, int size, bool write,
+                       std::vector<struct iovec> &iovs) const override;
 };
 
 #endif //__MEM_TRANSLATING_PORT_PROXY_HH__
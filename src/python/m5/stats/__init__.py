@@ -184,6 +184,36 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "col", "columnar", ])
+def _columnarFactory(fn, desc=True, formulas=True):
+    """Output stats in a columnar binary format.
+
+    The columnar format stores the names of all stats once, the first
+    time stats are dumped. Every dump after that only stores the stats
+    whose value changed since the previous dump, which makes it well
+    suited for frequent periodic dumps (e.g., --stats-period style
+    time series).
+
+    Stats are flattened to one column per scalar, vector element, 2d
+    cell and distribution field/bucket. The file can be loaded using
+    util/columnar_stats.py, which returns the dumps as arrays (or a
+    pandas DataFrame) indexed by tick.
+
+    Known limitations:
+      * Sparse histograms are unsupported.
+      * The set of stats must not change between dumps.
+
+    Parameters:
+      * desc (bool): Output stat descriptions (default: True)
+      * formulas (bool): Output derived stats (default: True)
+
+    Example:
+      col://stats.col?desc=False;formulas=False
+
+    """
+
+    return _m5.stats.initColumnar(fn, desc, formulas)
+
 def addStatVisitor(url):
     """Add a stat visitor specified using a URL string
 
@@ -48,6 +48,8 @@ from m5.objects.SimpleMemory import *
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+class MemoryCheckpointFormat(ScopedEnum): vals = ['gzip', 'chunked', 'raw']
+
 class System(SimObject):
     type = 'System'
     cxx_header = "sim/system.hh"
@@ -73,6 +75,26 @@ class System(SimObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # The physical memory is by default checkpointed as a single gzip
+    # stream per backing store. The chunked format splits the store
+    # into independently compressed chunks, omits all-zero chunks and
+    # uses a pool of host threads to compress and decompress them. The
+    # raw format stores an uncompressed (sparse) image of each backing
+    # store, which can be mapped copy-on-write when restoring so that
+    # only the pages touched by the simulation are read from disk, and
+    # concurrent runs restoring the same checkpoint share the host page
+    # cache.
+    checkpoint_mem_format = Param.MemoryCheckpointFormat('gzip',
+        "File format used when checkpointing the physical memory")
+    checkpoint_mem_chunk_size = Param.MemorySize('256kB',
+        "Size of the independently compressed chunks (chunked format)")
+    checkpoint_mem_threads = Param.Unsigned(0,
+        "Host threads used to (de)compress memory chunks, 0 uses all "
+        "available host threads (chunked and raw formats)")
+    checkpoint_mem_cow = Param.Bool(False,
+        "Map raw memory checkpoints copy-on-write into the backing store "
+        "when restoring instead of reading them")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
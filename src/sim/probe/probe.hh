@@ -279,6 +279,13 @@ class ProbePointArg : public ProbePoint
                         listeners.end());
     }
 
+    /**
+     * @brief check if any listener is attached, so that call sites can
+     * skip building an expensive argument.
+     * @return true if at least one listener is attached.
+     */
+    bool hasListeners() const { return !listeners.empty(); }
+
     /**
      * @brief called at the ProbePoint call site, passes arg to each listener.
      * @param arg the argument to pass to each listener.
@@ -81,9 +81,14 @@
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <climits>
+#include <limits>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "arch/utility.hh"
@@ -1566,6 +1571,59 @@ fstatfsFunc(SyscallDesc *desc, ThreadContext *tc, int tgt_fd, Addr bufPtr)
     return 0;
 }
 
+/**
+ * Read the iovec array of a readv() or writev() call and build host
+ * iovecs aliasing the guest buffers it describes, so the host call can
+ * move the data directly. Sets direct to false if some buffer isn't
+ * reachable through a memory backdoor or the result doesn't fit in
+ * IOV_MAX entries, in which case the caller has to copy through a bounce
+ * buffer of total bytes. Like Linux, a single call moves at most
+ * MAX_RW_COUNT bytes, so total is the smaller of that and the sum of the
+ * lengths. Returns false if the lengths add up to more than the target
+ * ssize_t can hold.
+ */
+template <class OS>
+bool
+readGuestIovecs(PortProxy &prox, uint64_t tiov_base, size_t count,
+                bool write, std::vector<typename OS::tgt_iovec> &tiov,
+                std::vector<struct iovec> &hiov, size_t &total,
+                bool &direct)
+{
+    // MAX_RW_COUNT of Linux, which also keeps every length passed to
+    // the port proxy below INT_MAX
+    const size_t max_rw_count = INT_MAX & ~(size_t)0xfff;
+    typedef decltype(OS::tgt_iovec::iov_len) tgt_size_t;
+    const size_t max_total = std::numeric_limits<
+        typename std::make_signed<tgt_size_t>::type>::max();
+
+    tiov.resize(count);
+    prox.readBlob(tiov_base, tiov.data(),
+                  count * sizeof(typename OS::tgt_iovec));
+
+    direct = true;
+    total = 0;
+    for (auto &t : tiov) {
+        t.iov_base = gtoh(t.iov_base, OS::byteOrder);
+        t.iov_len = gtoh(t.iov_len, OS::byteOrder);
+        if (t.iov_len > max_total - total)
+            return false;
+        total += t.iov_len;
+
+        // Map the buffer in chunks the port proxy can take
+        Addr addr = t.iov_base;
+        size_t left = t.iov_len;
+        while (direct && left) {
+            const size_t chunk = std::min(left, max_rw_count);
+            direct = prox.tryHostRanges(addr, chunk, write, hiov);
+            addr += chunk;
+            left -= chunk;
+        }
+    }
+    direct = direct && hiov.size() <= IOV_MAX;
+    total = std::min(total, max_rw_count);
+    return true;
+}
+
 /// Target readv() handler.
 template <class OS>
 SyscallReturn
@@ -1579,28 +1637,41 @@ readvFunc(SyscallDesc *desc, ThreadContext *tc,
         return -EBADF;
     int sim_fd = ffdp->getSimFD();
 
+    if (count > IOV_MAX)
+        return -EINVAL;
+
     PortProxy &prox = tc->getVirtProxy();
-    typename OS::tgt_iovec tiov[count];
-    struct iovec hiov[count];
-    for (size_t i = 0; i < count; ++i) {
-        prox.readBlob(tiov_base + (i * sizeof(typename OS::tgt_iovec)),
-                      &tiov[i], sizeof(typename OS::tgt_iovec));
-        hiov[i].iov_len = gtoh(tiov[i].iov_len, OS::byteOrder);
-        hiov[i].iov_base = new char [hiov[i].iov_len];
+    std::vector<typename OS::tgt_iovec> tiov;
+    std::vector<struct iovec> hiov;
+    size_t total;
+    bool direct;
+    if (!readGuestIovecs<OS>(prox, tiov_base, count, true, tiov, hiov,
+                             total, direct))
+        return -EINVAL;
+    if (direct) {
+        ssize_t result = readv(sim_fd, hiov.data(), hiov.size());
+        return (result == -1) ? -errno : result;
     }
 
-    int result = readv(sim_fd, hiov, count);
-    int local_errno = errno;
+    // Read into a single bounce buffer and scatter only what was read.
+    // The buffer is left uninitialised so that only the pages the host
+    // read actually fills get backed.
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[total]);
+    ssize_t result = read(sim_fd, buf.get(), total);
+    if (result == -1)
+        return -errno;
 
-    for (size_t i = 0; i < count; ++i) {
-        if (result != -1) {
-            prox.writeBlob(htog(tiov[i].iov_base, OS::byteOrder),
-                           hiov[i].iov_base, hiov[i].iov_len);
-        }
-        delete [] (char *)hiov[i].iov_base;
+    size_t bytes_read = result;
+    size_t offset = 0;
+    for (auto &t : tiov) {
+        if (offset >= bytes_read)
+            break;
+        size_t len = std::min<size_t>(t.iov_len, bytes_read - offset);
+        prox.writeBlob(t.iov_base, buf.get() + offset, len);
+        offset += len;
     }
 
-    return (result == -1) ? -local_errno : result;
+    return result;
 }
 
 /// Target writev() handler.
@@ -1616,23 +1687,34 @@ writevFunc(SyscallDesc *desc, ThreadContext *tc,
         return -EBADF;
     int sim_fd = hbfdp->getSimFD();
 
+    if (count > IOV_MAX)
+        return -EINVAL;
+
     PortProxy &prox = tc->getVirtProxy();
-    struct iovec hiov[count];
-    for (size_t i = 0; i < count; ++i) {
-        typename OS::tgt_iovec tiov;
-
-        prox.readBlob(tiov_base + i*sizeof(typename OS::tgt_iovec),
-                      &tiov, sizeof(typename OS::tgt_iovec));
-        hiov[i].iov_len = gtoh(tiov.iov_len, OS::byteOrder);
-        hiov[i].iov_base = new char [hiov[i].iov_len];
-        prox.readBlob(gtoh(tiov.iov_base, OS::byteOrder), hiov[i].iov_base,
-                      hiov[i].iov_len);
+    std::vector<typename OS::tgt_iovec> tiov;
+    std::vector<struct iovec> hiov;
+    size_t total;
+    bool direct;
+    if (!readGuestIovecs<OS>(prox, tiov_base, count, false, tiov, hiov,
+                             total, direct))
+        return -EINVAL;
+    if (direct) {
+        ssize_t result = writev(sim_fd, hiov.data(), hiov.size());
+        return (result == -1) ? -errno : result;
     }
 
-    int result = writev(sim_fd, hiov, count);
+    // Gather into a single bounce buffer so the host still sees one write.
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[total]);
+    size_t offset = 0;
+    for (auto &t : tiov) {
+        if (offset >= total)
+            break;
+        size_t len = std::min<size_t>(t.iov_len, total - offset);
+        prox.readBlob(t.iov_base, buf.get() + offset, len);
+        offset += len;
+    }
 
-    for (size_t i = 0; i < count; ++i)
-        delete [] (char *)hiov[i].iov_base;
+    ssize_t result = write(sim_fd, buf.get(), total);
 
     return (result == -1) ? -errno : result;
 }
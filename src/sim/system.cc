@@ -94,7 +94,9 @@ System::System(Params *p)
 #else
       kvmVM(nullptr),
 #endif
-      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve),
+      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve,
+              p->checkpoint_mem_format, p->checkpoint_mem_chunk_size,
+              p->checkpoint_mem_threads, p->checkpoint_mem_cow),
       memoryMode(p->mem_mode),
       _cacheLineSize(p->cache_line_size),
       workItemsBegin(0),
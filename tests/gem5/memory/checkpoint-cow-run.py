@@ -0,0 +1,142 @@
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+'''
+Checks that a raw memory checkpoint restored copy-on-write can be
+checkpointed back into the directory it was restored from. The mapping
+of the restored memory refers to the checkpoint file being replaced, so
+writing the new checkpoint must not disturb the pages the guest never
+touched after the restore.
+
+Without a --phase, the script drives the test by running gem5 again
+for every phase, using the same binary, and checks the resulting
+memory image after each of them.
+'''
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import argparse
+import glob
+import os
+import subprocess
+import sys
+import tempfile
+
+import m5
+from m5.objects import *
+
+mem_size = 64 * 1024 * 1024
+region_size = 8 * 1024 * 1024
+# regions written by the create phase and by the first restore
+first_region = 0
+second_region = 16 * 1024 * 1024
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--phase', choices=['create', 'restore'], default=None)
+parser.add_argument('--checkpoint-dir', default=None)
+parser.add_argument('--write-addr', type=int, default=None)
+
+args = parser.parse_args()
+
+def simulate(restore_dir):
+    system = System(membus = SystemXBar())
+    system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                       voltage_domain = VoltageDomain())
+    system.mem_ranges = [AddrRange(mem_size)]
+    system.mem_mode = 'timing'
+    system.checkpoint_mem_format = 'raw'
+    system.checkpoint_mem_cow = restore_dir is not None
+
+    system.mem = SimpleMemory(range = system.mem_ranges[0])
+    system.mem.port = system.membus.master
+
+    system.tgen = PyTrafficGen()
+    system.tgen.port = system.membus.slave
+    system.system_port = system.membus.slave
+
+    root = Root(full_system = False, system = system)
+    m5.instantiate(restore_dir)
+
+    def traffic():
+        if args.write_addr is not None:
+            block_size = 64
+            period = 1000
+            # the generator writes its master id into every byte, so
+            # the written region is all non-zero
+            yield system.tgen.createLinear(
+                region_size // block_size * period, args.write_addr,
+                args.write_addr + region_size - 1, block_size,
+                period, period, 0, region_size)
+        yield system.tgen.createExit(0)
+
+    system.tgen.start(traffic())
+    m5.simulate()
+    m5.checkpoint(args.checkpoint_dir)
+
+def run_phase(ckpt_dir, outdir, phase, write_addr=None):
+    cmd = [os.readlink('/proc/self/exe'), '-d', outdir,
+           os.path.abspath(__file__), '--phase', phase,
+           '--checkpoint-dir', ckpt_dir]
+    if write_addr is not None:
+        cmd += ['--write-addr', str(write_addr)]
+    if subprocess.call(cmd):
+        m5.fatal('Phase %s failed' % phase)
+
+def check_image(ckpt_dir, written):
+    images = glob.glob(os.path.join(ckpt_dir, '*.store0.pmem'))
+    if len(images) != 1:
+        m5.fatal('Expected one memory image in %s' % ckpt_dir)
+    with open(images[0], 'rb') as f:
+        image = f.read()
+    if len(image) != mem_size:
+        m5.fatal('Memory image has %d bytes' % len(image))
+    for start in written:
+        if image[start:start + region_size].count(b'\0'):
+            m5.fatal('Data at %#x lost from the memory image' % start)
+
+if args.phase == 'create':
+    simulate(None)
+elif args.phase == 'restore':
+    simulate(args.checkpoint_dir)
+else:
+    work_dir = tempfile.mkdtemp(dir=m5.options.outdir)
+    ckpt_dir = os.path.join(work_dir, 'cpt')
+
+    run_phase(ckpt_dir, os.path.join(work_dir, 'create'), 'create',
+              first_region)
+    check_image(ckpt_dir, [first_region])
+
+    # restore, write some more and checkpoint into the same directory
+    run_phase(ckpt_dir, os.path.join(work_dir, 'restore1'), 'restore',
+              second_region)
+    check_image(ckpt_dir, [first_region, second_region])
+
+    # restore once more without touching memory and do it again
+    run_phase(ckpt_dir, os.path.join(work_dir, 'restore2'), 'restore')
+    check_image(ckpt_dir, [first_region, second_region])
+
+    print('Checkpoint round trip passed')
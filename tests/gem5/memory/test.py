@@ -60,6 +60,14 @@ for name, params in simple_mem_params:
         valid_isas=(constants.null_tag,),
         ) # This tests for validity as well as performance
 
+gem5_verify_config(
+    name='checkpoint_cow_same_dir',
+    verifiers=(), # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), 'checkpoint-cow-run.py'),
+    config_args = [],
+    valid_isas=(constants.null_tag,),
+)
+
 gem5_verify_config(
     name='memtest',
     verifiers=(), # No need for verfiers this will return non-zero on fail
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Guest workload used by configs/example/block_cache_bench.py to
+ * measure how fast the atomic CPU runs straight-line integer code. It
+ * also patches and calls a small function over and over, which checks
+ * that cached decodes are dropped when the code they came from is
+ * modified. The self-modifying part is only built for x86-64.
+ *
+ * usage: block-bench [iterations]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define NUM_KEYS 256
+
+static uint64_t
+compute(unsigned long iterations)
+{
+    static uint32_t keys[NUM_KEYS];
+    uint64_t state = 88172645463325252ULL;
+    uint64_t sum = 0;
+
+    for (unsigned long it = 0; it < iterations; it++) {
+        for (int i = 0; i < NUM_KEYS; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            keys[i] = (uint32_t)state;
+        }
+
+        // insertion sort, lots of short blocks and branches
+        for (int i = 1; i < NUM_KEYS; i++) {
+            uint32_t key = keys[i];
+            int j = i - 1;
+            while (j >= 0 && keys[j] > key) {
+                keys[j + 1] = keys[j];
+                j--;
+            }
+            keys[j + 1] = key;
+        }
+
+        sum += keys[it % NUM_KEYS];
+    }
+    return sum;
+}
+
+#if defined(__x86_64__)
+static int
+selfModify(unsigned long iterations)
+{
+    // mov $imm32, %eax; ret
+    static const uint8_t templ[] = { 0xb8, 0, 0, 0, 0, 0xc3 };
+
+    uint8_t *code = mmap(NULL, 4096, PROT_READ | PROT_WRITE | PROT_EXEC,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        perror("mmap");
+        return 0;
+    }
+    memcpy(code, templ, sizeof(templ));
+
+    uint32_t (*func)(void) = (uint32_t (*)(void))code;
+    for (unsigned long i = 0; i < iterations; i++) {
+        uint32_t imm = (uint32_t)i * 2654435761U;
+        memcpy(code + 1, &imm, sizeof(imm));
+        __builtin___clear_cache((char *)code, (char *)code + sizeof(templ));
+        if (func() != imm) {
+            printf("smc: stale code after %lu iterations\n", i);
+            return 0;
+        }
+    }
+    return 1;
+}
+#endif
+
+int
+main(int argc, char *argv[])
+{
+    unsigned long iterations = argc > 1 ? strtoul(argv[1], NULL, 0) : 100;
+
+    printf("sum: %llu\n", (unsigned long long)compute(iterations));
+
+#if defined(__x86_64__)
+    if (!selfModify(iterations * 100))
+        return 1;
+    printf("smc: ok\n");
+#endif
+
+    return 0;
+}
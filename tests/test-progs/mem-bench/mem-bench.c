@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Guest workload used by configs/example/cache_backdoor_bench.py to
+ * measure how fast the atomic CPU runs through a cache hierarchy when
+ * most accesses miss in the last-level cache. It updates a buffer much
+ * larger than a typical LLC, first line by line and then in a
+ * pseudo-random order, so that the caches see a mix of clean and dirty
+ * evictions.
+ *
+ * usage: mem-bench [size in MB] [passes]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LINE_WORDS 8
+
+int
+main(int argc, char *argv[])
+{
+    size_t size_mb = argc > 1 ? strtoul(argv[1], NULL, 0) : 64;
+    unsigned long passes = argc > 2 ? strtoul(argv[2], NULL, 0) : 4;
+
+    size_t words = size_mb * 1024 * 1024 / sizeof(uint64_t);
+    uint64_t *buf = malloc(words * sizeof(uint64_t));
+    if (!buf) {
+        perror("malloc");
+        return 1;
+    }
+    for (size_t i = 0; i < words; i++)
+        buf[i] = i;
+
+    uint64_t state = 88172645463325252ULL;
+    uint64_t sum = 0;
+    for (unsigned long pass = 0; pass < passes; pass++) {
+        // sequential, one access per cache line
+        for (size_t i = 0; i < words; i += LINE_WORDS) {
+            sum += buf[i];
+            buf[i] = sum;
+        }
+
+        // random, every other access only reads
+        for (size_t n = 0; n < words / LINE_WORDS; n++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            size_t i = state % words;
+            sum += buf[i];
+            if (n & 1)
+                buf[i] ^= state;
+        }
+    }
+
+    printf("sum: %llu\n", (unsigned long long)sum);
+    free(buf);
+    return 0;
+}
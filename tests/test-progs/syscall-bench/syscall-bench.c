@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020 The gem5 Authors
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Syscall-heavy guest workload used by configs/example/syscall_bench.py
+ * to measure how much host time SE mode spends moving data between
+ * guest memory and host file descriptors. Every phase works on a
+ * scratch file, so the host I/O itself is served from the page cache.
+ *
+ * usage: syscall-bench <file> [iterations] [buffer bytes]
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#define NUM_IOVS 4
+
+static void
+check(int ok, const char *what)
+{
+    if (!ok) {
+        perror(what);
+        exit(1);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file> [iterations] [buffer bytes]\n",
+                argv[0]);
+        return 1;
+    }
+
+    const char *path = argv[1];
+    long iters = argc > 2 ? atol(argv[2]) : 1000;
+    size_t size = argc > 3 ? (size_t)atol(argv[3]) : 64 * 1024;
+    size_t part = size / NUM_IOVS;
+
+    char *buf = malloc(size);
+    check(buf != NULL, "malloc");
+    memset(buf, 0x5a, size);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    check(fd >= 0, "open");
+
+    struct iovec iov[NUM_IOVS];
+    for (int i = 0; i < NUM_IOVS; i++) {
+        iov[i].iov_base = buf + i * part;
+        iov[i].iov_len = part;
+    }
+
+    unsigned long syscalls = 0;
+    unsigned long long bytes = 0;
+    unsigned long sum = 0;
+
+    for (long i = 0; i < iters; i++) {
+        check(lseek(fd, 0, SEEK_SET) == 0, "lseek");
+        check(write(fd, buf, size) == (ssize_t)size, "write");
+        check(lseek(fd, 0, SEEK_SET) == 0, "lseek");
+        check(read(fd, buf, size) == (ssize_t)size, "read");
+        check(pwrite(fd, buf, size, 0) == (ssize_t)size, "pwrite");
+        check(pread(fd, buf, size, 0) == (ssize_t)size, "pread");
+        check(lseek(fd, 0, SEEK_SET) == 0, "lseek");
+        check(writev(fd, iov, NUM_IOVS) == (ssize_t)(part * NUM_IOVS),
+              "writev");
+        check(lseek(fd, 0, SEEK_SET) == 0, "lseek");
+        check(readv(fd, iov, NUM_IOVS) == (ssize_t)(part * NUM_IOVS),
+              "readv");
+        syscalls += 10;
+        bytes += 4 * size + 2 * part * NUM_IOVS;
+    }
+
+    // Map the file a number of times so that every page is filled in
+    // from the host mapping on first touch.
+    long page = sysconf(_SC_PAGESIZE);
+    for (long i = 0; i < iters / 10 + 1; i++) {
+        unsigned char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        check(map != MAP_FAILED, "mmap");
+        for (size_t off = 0; off < size; off += page)
+            sum += map[off];
+        check(munmap(map, size) == 0, "munmap");
+        syscalls += 2;
+        bytes += size;
+    }
+
+    close(fd);
+    unlink(path);
+    free(buf);
+
+    printf("syscalls: %lu\nbytes: %llu\nchecksum: %lu\n",
+           syscalls, bytes, sum);
+    return 0;
+}
@@ -0,0 +1,178 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script reads the columnar binary stat format written by the
+# col:// stat output (see src/base/stats/columnar.hh). It can either be
+# imported as a module:
+#
+#   import columnar_stats
+#   stats = columnar_stats.load("m5out/stats.col")
+#   df = stats.to_dataframe()
+#
+# or run as a script to convert a stat file to CSV, optionally keeping
+# only the columns matching a set of regular expressions:
+#
+#   columnar_stats.py m5out/stats.col 'system.cpu.ipc' '.*l2.*miss'
+#
+# Unchanged values are not stored in the file. They are filled in from
+# the previous dump when the file is loaded.
+
+from __future__ import print_function
+
+import argparse
+import csv
+import re
+import struct
+import sys
+
+magic = b'gem5scol'
+version = 1
+flag_descriptions = 0x1
+header_fmt = '<8sIIQ'
+
+class ColumnarStats(object):
+    """Stats loaded from a columnar stat file.
+
+    Attributes:
+      * ticks: Tick of every dump.
+      * names: Name of every column.
+      * descs: Description of every column (empty if not stored).
+      * columns: One list of values (one per dump) per column.
+    """
+
+    def __init__(self, names, descs):
+        self.names = names
+        self.descs = descs
+        self.ticks = []
+        self.columns = [ [] for n in names ]
+
+    def __len__(self):
+        return len(self.ticks)
+
+    def column(self, name):
+        return self.columns[self.names.index(name)]
+
+    def select(self, patterns):
+        """Return the names of the columns matching any of the regular
+        expressions in patterns."""
+        regexps = [ re.compile(p) for p in patterns ]
+        return [ n for n in self.names
+                 if any(r.match(n) for r in regexps) ]
+
+    def to_numpy(self):
+        """Return a (ticks, values) tuple of numpy arrays. values has
+        one row per dump and one column per stat."""
+        import numpy as np
+        return np.array(self.ticks, dtype=np.uint64), \
+            np.array(self.columns, dtype=np.float64).T
+
+    def to_dataframe(self):
+        """Return a pandas DataFrame indexed by tick."""
+        import pandas as pd
+        return pd.DataFrame(dict(zip(self.names, self.columns)),
+                            index=pd.Index(self.ticks, name='tick'),
+                            columns=self.names)
+
+def _read(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError("Truncated columnar stat file")
+    return data
+
+def _read_string(f):
+    length, = struct.unpack('<I', _read(f, 4))
+    return _read(f, length).decode('utf-8')
+
+def load(filename):
+    """Load a columnar stat file."""
+    with open(filename, 'rb') as f:
+        header = f.read(struct.calcsize(header_fmt))
+        if len(header) == 0:
+            # No stats have been dumped yet
+            return ColumnarStats([], [])
+        file_magic, file_version, flags, num_columns = \
+            struct.unpack(header_fmt, header)
+        if file_magic != magic:
+            raise ValueError("%s is not a columnar stat file" % filename)
+        if file_version != version:
+            raise ValueError("Unsupported columnar stat file version %d" %
+                             file_version)
+
+        names = []
+        descs = []
+        for i in range(num_columns):
+            names.append(_read_string(f))
+            if flags & flag_descriptions:
+                descs.append(_read_string(f))
+
+        stats = ColumnarStats(names, descs)
+        bitmap_size = (num_columns + 7) // 8
+        values = [ 0.0 ] * num_columns
+        while True:
+            tick = f.read(8)
+            if len(tick) == 0:
+                break
+            tick, = struct.unpack('<Q', tick)
+            bitmap = bytearray(_read(f, bitmap_size))
+
+            changed = [ i for i in range(num_columns)
+                        if bitmap[i // 8] & (1 << (i % 8)) ]
+            new_values = struct.unpack('<%dd' % len(changed),
+                                       _read(f, 8 * len(changed)))
+            for i, value in zip(changed, new_values):
+                values[i] = value
+
+            stats.ticks.append(tick)
+            for column, value in zip(stats.columns, values):
+                column.append(value)
+
+        return stats
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert a columnar stat file to CSV.")
+    parser.add_argument("input", help="Columnar stat file")
+    parser.add_argument("patterns", nargs="*",
+                        help="Only output the columns matching these "
+                        "regular expressions")
+    parser.add_argument("-o", "--output", default=None,
+                        help="Output file (default: stdout)")
+    args = parser.parse_args()
+
+    stats = load(args.input)
+    names = stats.select(args.patterns) if args.patterns else stats.names
+    columns = [ stats.column(n) for n in names ]
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow([ 'tick' ] + names)
+    for i, tick in enumerate(stats.ticks):
+        writer.writerow([ tick ] + [ c[i] for c in columns ])
+
+if __name__ == "__main__":
+    main()
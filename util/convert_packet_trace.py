@@ -0,0 +1,157 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script converts packet traces between the protobuf format and
+# the binary fixed-record format (see src/mem/packet_trace.hh). The
+# direction is detected from the input file: binary traces are
+# converted to protobuf and protobuf traces to binary. Protobuf output
+# is compressed if the output file name ends with .gz.
+#
+# The protobuf definitions are generated on the fly in the same way as
+# for decode_packet_trace.py.
+
+from __future__ import print_function
+
+import gzip
+import os
+import protolib
+import struct
+import subprocess
+import sys
+
+util_dir = os.path.dirname(os.path.realpath(__file__))
+# Make sure the proto definitions are up to date.
+subprocess.check_call(['make', '--quiet', '-C', util_dir, 'packet_pb2.py'])
+import packet_pb2
+
+binary_magic = b'gem5ptrc'
+binary_version = 1
+header_fmt = '<8sIIQII'
+record_fmt = '<QQQQIIII'
+record_size = struct.calcsize(record_fmt)
+
+def binary_to_proto(bin_in, proto_out):
+    header = bin_in.read(struct.calcsize(header_fmt))
+    magic, version, rec_size, tick_freq, obj_id_len, num_ids = \
+        struct.unpack(header_fmt, header)
+    if version != binary_version or rec_size != record_size:
+        print("Unsupported binary trace version", version)
+        exit(-1)
+
+    header_msg = packet_pb2.PacketHeader()
+    header_msg.obj_id = bin_in.read(obj_id_len).decode('utf-8')
+    header_msg.tick_freq = tick_freq
+    for i in range(num_ids):
+        key, length = struct.unpack('<II', bin_in.read(8))
+        id_string = header_msg.id_strings.add()
+        id_string.key = key
+        id_string.value = bin_in.read(length).decode('utf-8')
+    # the records are aligned to 8 bytes
+    bin_in.read(-bin_in.tell() % 8)
+
+    proto_out.write(b'gem5')
+    protolib.encodeMessage(proto_out, header_msg)
+
+    num_packets = 0
+    while True:
+        data = bin_in.read(record_size)
+        if len(data) < record_size:
+            break
+        tick, addr, pc, pkt_id, cmd, size, flags, _ = \
+            struct.unpack(record_fmt, data)
+        packet = packet_pb2.Packet()
+        packet.tick = tick
+        packet.cmd = cmd
+        packet.addr = addr
+        packet.size = size
+        if flags:
+            packet.flags = flags
+        packet.pkt_id = pkt_id
+        if pc:
+            packet.pc = pc
+        protolib.encodeMessage(proto_out, packet)
+        num_packets += 1
+
+    return num_packets
+
+def proto_to_binary(proto_in, bin_out):
+    header_msg = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header_msg)
+
+    obj_id = header_msg.obj_id.encode('utf-8')
+    bin_out.write(struct.pack(header_fmt, binary_magic, binary_version,
+                              record_size, header_msg.tick_freq,
+                              len(obj_id), len(header_msg.id_strings)))
+    bin_out.write(obj_id)
+    for id_string in header_msg.id_strings:
+        value = id_string.value.encode('utf-8')
+        bin_out.write(struct.pack('<II', id_string.key, len(value)))
+        bin_out.write(value)
+    bin_out.write(b'\0' * (-bin_out.tell() % 8))
+
+    num_packets = 0
+    packet = packet_pb2.Packet()
+    while protolib.decodeMessage(proto_in, packet):
+        bin_out.write(struct.pack(record_fmt, packet.tick, packet.addr,
+                                  packet.pc, packet.pkt_id, packet.cmd,
+                                  packet.size, packet.flags, 0))
+        num_packets += 1
+
+    return num_packets
+
+def main():
+    if len(sys.argv) != 3:
+        print("Usage: ", sys.argv[0], " <input trace> <output trace>")
+        exit(-1)
+
+    with open(sys.argv[1], 'rb') as f:
+        is_binary = f.read(len(binary_magic)) == binary_magic
+
+    if is_binary:
+        bin_in = open(sys.argv[1], 'rb')
+        if sys.argv[2].endswith('.gz'):
+            proto_out = gzip.open(sys.argv[2], 'wb')
+        else:
+            proto_out = open(sys.argv[2], 'wb')
+        num_packets = binary_to_proto(bin_in, proto_out)
+        proto_out.close()
+        bin_in.close()
+    else:
+        proto_in = protolib.openFileRd(sys.argv[1])
+        if proto_in.read(4) != b'gem5':
+            print("Unrecognized file", sys.argv[1])
+            exit(-1)
+        bin_out = open(sys.argv[2], 'wb')
+        num_packets = proto_to_binary(proto_in, bin_out)
+        bin_out.close()
+        proto_in.close()
+
+    print("Converted packets:", num_packets)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+#! /usr/bin/env python2.7
+
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script measures decode throughput for every ISA a gem5 binary is
+# given for. Each workload runs in SE mode on an AtomicSimpleCPU
+# without caches in front of an ideal memory. That leaves instruction
+# decode, and the decode cache lookups in front of it, as the main
+# host cost per instruction. The ISA is
+# taken from the build directory of each binary, and the workload
+# defaults to the hello test program for that ISA. Longer running
+# workloads give more stable figures, e.g.
+#
+#   util/decode-bench.py build/ARM/gem5.opt build/X86/gem5.opt \
+#       --workload ARM=/path/to/arm/bench --workload X86=/path/to/x86/bench
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+parser = argparse.ArgumentParser()
+parser.add_argument("gem5", nargs="+",
+                    help="gem5 binaries, one per ISA (build/<ISA>/gem5.*)")
+parser.add_argument("--workload", action="append", default=[],
+                    metavar="ISA=BINARY",
+                    help="SE workload to run for an ISA")
+parser.add_argument("--maxinsts", type=int, default=0,
+                    help="Stop after this many instructions (0: run to "
+                    "completion)")
+parser.add_argument("--outdir", default="m5out.decode",
+                    help="Base output directory, one subdirectory per ISA")
+
+args = parser.parse_args()
+
+gem5_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+config = os.path.join(gem5_root, "configs", "example", "se.py")
+
+workloads = {}
+for w in args.workload:
+    isa, sep, binary = w.partition("=")
+    if not sep:
+        parser.error("--workload expects ISA=BINARY, got '%s'" % w)
+    workloads[isa.upper()] = binary
+
+stat_re = re.compile(r"^(\S+)\s+([-+0-9.eE]+|nan|inf)\s")
+
+def read_stats(outdir):
+    stats = {}
+    with open(os.path.join(outdir, "stats.txt")) as f:
+        for line in f:
+            m = stat_re.match(line)
+            if m:
+                stats[m.group(1)] = float(m.group(2))
+    return stats
+
+results = []
+for gem5 in args.gem5:
+    isa = os.path.basename(os.path.dirname(os.path.abspath(gem5))).upper()
+    workload = workloads.get(isa) or os.path.join(
+        gem5_root, "tests", "test-progs", "hello", "bin", isa.lower(),
+        "linux", "hello")
+    if not os.path.isfile(workload):
+        print("No workload for %s, skipping %s" % (isa, gem5),
+              file=sys.stderr)
+        continue
+
+    outdir = os.path.join(args.outdir, isa)
+    cmd = [ gem5, "--outdir=%s" % outdir, config,
+            "--cpu-type=AtomicSimpleCPU", "--mem-type=SimpleMemory",
+            "--cmd=%s" % workload ]
+    if args.maxinsts:
+        cmd.append("--maxinsts=%d" % args.maxinsts)
+    print("Running:", " ".join(cmd))
+    ret = subprocess.call(cmd)
+    if ret != 0:
+        print("gem5 failed with exit code %d" % ret, file=sys.stderr)
+        sys.exit(ret)
+
+    stats = read_stats(outdir)
+    results.append((isa, stats.get("sim_insts", 0),
+                    stats.get("host_seconds", 0.0)))
+
+print()
+print("%-8s %14s %10s %12s" % ("ISA", "instructions", "host s", "MIPS"))
+for isa, insts, seconds in results:
+    mips = insts / seconds / 1e6 if seconds else 0.0
+    print("%-8s %14d %10.2f %12.2f" % (isa, insts, seconds, mips))
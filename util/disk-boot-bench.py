@@ -0,0 +1,105 @@
+#! /usr/bin/env python2.7
+
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+# This script measures how long an fs.py boot followed by a disk-heavy
+# workload takes with the different disk image backends. The guest runs
+# configs/boot/disk-bench.rcS, which reads the whole root file system
+# and writes a scratch file after boot. Each configuration is a separate
+# gem5 run, timed from start to exit:
+#
+#   stream        raw images read and written one sector at a time
+#   mmap          raw images mapped (the default)
+#   overlay-cold  mapped, with the COW writes in a new overlay file
+#   overlay-warm  the same, reusing the overlay of the previous run
+#
+# e.g.
+#
+#   util/disk-boot-bench.py build/X86/gem5.opt \
+#       --kernel x86_64-vmlinux --disk-image linux-x86.img
+
+from __future__ import print_function
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import time
+
+configs = [ "stream", "mmap", "overlay-cold", "overlay-warm" ]
+
+parser = argparse.ArgumentParser()
+parser.add_argument("gem5", help="gem5 binary")
+parser.add_argument("--kernel", required=True, help="Guest kernel")
+parser.add_argument("--disk-image", required=True, help="Guest disk image")
+parser.add_argument("--cpu-type", default="AtomicSimpleCPU",
+                    help="CPU model to boot with")
+parser.add_argument("--config", action="append", choices=configs,
+                    default=[], help="Configuration to run (default: all)")
+parser.add_argument("--outdir", default="m5out.disk-boot",
+                    help="Base output directory")
+
+args = parser.parse_args()
+
+gem5_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+fs_config = os.path.join(gem5_root, "configs", "example", "fs.py")
+script = os.path.join(gem5_root, "configs", "boot", "disk-bench.rcS")
+overlay_dir = os.path.join(args.outdir, "overlay")
+
+def run(config):
+    outdir = os.path.join(args.outdir, config)
+    cmd = [ args.gem5, "--outdir=%s" % outdir, fs_config,
+            "--cpu-type=%s" % args.cpu_type,
+            "--kernel=%s" % args.kernel,
+            "--disk-image=%s" % args.disk_image,
+            "--script=%s" % script ]
+    if config == "stream":
+        cmd.append("--disk-stream-io")
+    elif config.startswith("overlay"):
+        if config == "overlay-cold" and os.path.isdir(overlay_dir):
+            shutil.rmtree(overlay_dir)
+        cmd.append("--disk-overlay-dir=%s" % overlay_dir)
+
+    print("Running:", " ".join(cmd))
+    with open(os.path.join(args.outdir, "%s.log" % config), "w") as log:
+        start = time.time()
+        ret = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+        elapsed = time.time() - start
+    if ret != 0:
+        print("gem5 failed with exit code %d" % ret, file=sys.stderr)
+        sys.exit(ret)
+    return elapsed
+
+if not os.path.isdir(args.outdir):
+    os.makedirs(args.outdir)
+
+results = [ (config, run(config))
+            for config in configs if not args.config or config in args.config ]
+
+print()
+for config, elapsed in results:
+    print("%-14s %8.2f s" % (config, elapsed))
@@ -0,0 +1,95 @@
+#! /bin/bash
+
+#
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# This script measures the host speedup of the dist-gem5 synchronisation
+# options on a single host. It runs the two AArch64 node setup from
+# test-2nodes-AArch64.sh with the TCP and the shared memory transport, each
+# with a fixed and an adaptive synchronisation quantum, and reports the wall
+# clock time of each run relative to the TCP/fixed quantum baseline.
+#
+# Usage: bench-sync-2nodes-AArch64.sh [max_quantum]
+#   max_quantum : upper bound for the adaptive quantum (default: 1ms)
+
+GEM5_DIR=$(pwd)/$(dirname $0)/../../..
+
+IMG=$M5_PATH/disks/aarch64-ubuntu-trusty-headless.img
+VMLINUX=$M5_PATH/binaries/vmlinux.aarch64.20140821
+DTB=$M5_PATH/binaries/vexpress.aarch64.20140821.dtb
+
+FS_CONFIG=$GEM5_DIR/configs/example/fs.py
+SW_CONFIG=$GEM5_DIR/configs/dist/sw.py
+GEM5_EXE=$GEM5_DIR/build/ARM/gem5.opt
+
+BOOT_SCRIPT=$GEM5_DIR/util/dist/test/simple_bootscript.rcS
+GEM5_DIST_SH=$GEM5_DIR/util/dist/gem5-dist.sh
+
+NNODES=2
+MAX_QUANTUM=${1:-1ms}
+RUN_ROOT=$(pwd)/bench-sync.$$
+
+run_config ()
+{
+    local name=$1
+    shift 1
+    local start=$(date +%s.%N)
+    $GEM5_DIST_SH -n $NNODES                                                 \
+                  -r $RUN_ROOT/$name                                         \
+                  -c $RUN_ROOT/$name                                         \
+                  -x $GEM5_EXE                                               \
+                  -s $SW_CONFIG                                              \
+                  -f $FS_CONFIG                                              \
+                  --fs-args                                                  \
+                      --cpu-type=atomic                                      \
+                      --num-cpus=1                                           \
+                      --machine-type=VExpress_EMM64                          \
+                      --disk-image=$IMG                                      \
+                      --kernel=$VMLINUX                                      \
+                      --dtb-filename=$DTB                                    \
+                      --script=$BOOT_SCRIPT                                  \
+                  --cf-args                                                  \
+                      "$@" > $RUN_ROOT/$name.log 2>&1 ||                     \
+        { echo "$name: run failed (see $RUN_ROOT/$name.log)"; exit 1; }
+    local end=$(date +%s.%N)
+    TIMES+=("$name $(echo "$start $end" | awk '{ print $2 - $1 }')")
+}
+
+mkdir -p $RUN_ROOT
+TIMES=()
+
+ADAPTIVE="--dist-sync-repeat-max=$MAX_QUANTUM"
+
+run_config tcp-fixed     --dist-transport=tcp
+run_config tcp-adaptive  --dist-transport=tcp $ADAPTIVE
+run_config shm-fixed     --dist-transport=shm
+run_config shm-adaptive  --dist-transport=shm $ADAPTIVE
+
+printf "%-14s %12s %8s\n" "config" "host_seconds" "speedup"
+printf "%s\n" "${TIMES[@]}" | awk '
+    NR == 1 { base = $2 }
+    { printf "%-14s %12.2f %8.2f\n", $1, $2, base / $2 }'
@@ -0,0 +1,95 @@
+#! /usr/bin/env python2.7
+
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script runs a netperf style full system network benchmark (two
+# systems connected by an EtherLink, see configs/example/fs.py --dual)
+# and reports the host time spent per simulated Ethernet packet, which
+# is the figure of merit for the host side cost of the network models.
+#
+# Example:
+#   util/netperf-host-time.py build/X86/gem5.opt -- \
+#       --kernel=... --disk-image=... --cpu-type=AtomicSimpleCPU
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+parser = argparse.ArgumentParser()
+parser.add_argument("gem5", help="gem5 binary")
+parser.add_argument("--config", default=None,
+                    help="Full system config script (default: "
+                    "configs/example/fs.py)")
+parser.add_argument("--benchmark", default="NetperfStream",
+                    help="Dual system benchmark from "
+                    "configs/common/Benchmarks.py")
+parser.add_argument("--outdir", default="m5out.netperf",
+                    help="gem5 output directory")
+parser.add_argument("fs_args", nargs=argparse.REMAINDER,
+                    help="Additional arguments for the config script "
+                    "(after --)")
+
+args = parser.parse_args()
+
+gem5_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+config = args.config or os.path.join(gem5_root, "configs", "example", "fs.py")
+fs_args = [a for a in args.fs_args if a != "--"]
+
+cmd = [ args.gem5, "--outdir=%s" % args.outdir, config, "--dual",
+        "--benchmark=%s" % args.benchmark ] + fs_args
+print("Running:", " ".join(cmd))
+ret = subprocess.call(cmd)
+if ret != 0:
+    print("gem5 failed with exit code %d" % ret, file=sys.stderr)
+    sys.exit(ret)
+
+# Use the last stats dump, the test system NIC sees every packet sent
+# over the link either as a transmit or as a receive.
+stat_re = re.compile(r"^(\S+)\s+([-+0-9.eE]+|nan|inf)\s")
+stats = {}
+with open(os.path.join(args.outdir, "stats.txt")) as f:
+    for line in f:
+        if line.startswith("---------- Begin Simulation Statistics"):
+            stats = {}
+        m = stat_re.match(line)
+        if m:
+            stats[m.group(1)] = float(m.group(2))
+
+host_seconds = stats.get("host_seconds", 0.0)
+packets = sum(v for k, v in stats.items()
+              if k.startswith("testsys.") and k.endswith(".totPackets"))
+
+print("host_seconds:       %.2f" % host_seconds)
+print("simulated packets:  %d" % packets)
+if packets:
+    print("host us per packet: %.2f" % (host_seconds * 1e6 / packets))
+else:
+    print("No packets simulated, check the benchmark boot scripts")
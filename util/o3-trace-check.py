@@ -0,0 +1,137 @@
+#! /usr/bin/env python2.7
+
+# Copyright (c) 2020 The gem5 Authors
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script checks that a change to the O3 CPU leaves its timing
+# untouched by comparing the commit traces of two gem5 binaries, e.g.
+# one built before and one after the change. Each workload runs in SE
+# mode on a DerivO3CPU with caches, with the Exec debug flag tracing
+# every committed instruction together with the tick it commits at.
+# The traces of the two binaries have to match line by line. --wide
+# runs an 8-wide core with a 256-entry IQ, where the IQ changes are
+# most likely to show, e.g.
+#
+#   util/o3-trace-check.py build.ref/X86/gem5.opt build/X86/gem5.opt \
+#       --wide --workload /path/to/x86/bench
+
+from __future__ import print_function
+
+import argparse
+import gzip
+import os
+import subprocess
+import sys
+
+parser = argparse.ArgumentParser()
+parser.add_argument("ref", help="Reference gem5 binary")
+parser.add_argument("test", help="gem5 binary to check")
+parser.add_argument("--workload", action="append", default=[],
+                    help="SE workload to run (default: the hello test "
+                    "program for the ISA of the binaries)")
+parser.add_argument("--maxinsts", type=int, default=0,
+                    help="Stop after this many instructions (0: run to "
+                    "completion)")
+parser.add_argument("--wide", action="store_true",
+                    help="Run an 8-wide core with a 256-entry IQ")
+parser.add_argument("--outdir", default="m5out.o3-trace",
+                    help="Base output directory")
+
+args = parser.parse_args()
+
+gem5_root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+config = os.path.join(gem5_root, "configs", "example", "se.py")
+
+def build_isa(gem5):
+    return os.path.basename(os.path.dirname(os.path.abspath(gem5))).upper()
+
+isa = build_isa(args.ref)
+if build_isa(args.test) != isa:
+    parser.error("The binaries are built for different ISAs")
+
+workloads = args.workload or [ os.path.join(
+    gem5_root, "tests", "test-progs", "hello", "bin", isa.lower(),
+    "linux", "hello") ]
+
+wide_params = [ "system.cpu[0].%s=%d" % p for p in (
+    ("fetchWidth", 8), ("decodeWidth", 8), ("renameWidth", 8),
+    ("dispatchWidth", 8), ("issueWidth", 8), ("wbWidth", 8),
+    ("commitWidth", 8), ("squashWidth", 8), ("numIQEntries", 256),
+    ("numROBEntries", 384), ("LQEntries", 128), ("SQEntries", 128),
+    ("numPhysIntRegs", 512), ("numPhysFloatRegs", 512)) ]
+
+def run(gem5, workload, outdir):
+    cmd = [ gem5, "--outdir=%s" % outdir, "--debug-flags=Exec",
+            "--debug-file=commit.trace.gz", config,
+            "--cpu-type=DerivO3CPU", "--caches",
+            "--cmd=%s" % workload ]
+    if args.maxinsts:
+        cmd.append("--maxinsts=%d" % args.maxinsts)
+    if args.wide:
+        cmd += [ "--param=%s" % p for p in wide_params ]
+    print("Running:", " ".join(cmd))
+    ret = subprocess.call(cmd)
+    if ret != 0:
+        print("gem5 failed with exit code %d" % ret, file=sys.stderr)
+        sys.exit(ret)
+    return os.path.join(outdir, "commit.trace.gz")
+
+def compare(ref_trace, test_trace):
+    with gzip.open(ref_trace, "rb") as ref, \
+         gzip.open(test_trace, "rb") as test:
+        count = 0
+        for ref_line, test_line in zip(ref, test):
+            count += 1
+            if ref_line != test_line:
+                print("  first difference at instruction %d:" % count)
+                print("  ref:  %s" % ref_line.decode().rstrip())
+                print("  test: %s" % test_line.decode().rstrip())
+                return False
+        if ref.readline() or test.readline():
+            print("  traces differ in length after %d instructions" %
+                  count)
+            return False
+    print("  %d committed instructions match" % count)
+    return True
+
+failed = 0
+for i, workload in enumerate(workloads):
+    if not os.path.isfile(workload):
+        print("%s not found" % workload, file=sys.stderr)
+        sys.exit(1)
+
+    outdir = os.path.join(args.outdir, str(i))
+    ref_trace = run(args.ref, workload, os.path.join(outdir, "ref"))
+    test_trace = run(args.test, workload, os.path.join(outdir, "test"))
+
+    print("%s:" % workload)
+    if not compare(ref_trace, test_trace):
+        failed += 1
+
+print()
+print("%d of %d workloads have identical commit traces" %
+      (len(workloads) - failed, len(workloads)))
+sys.exit(1 if failed else 0)